@@ -0,0 +1,6 @@
+"""
+Benchmark suite for pypersistent.
+
+See docs/optimizations/benchmarking-methodology.md for the methodology and
+``python -m benchmarks.run --help`` for usage.
+"""
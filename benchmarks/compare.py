@@ -0,0 +1,113 @@
+"""
+Compare two benchmark result files and flag significant changes.
+
+Latency and bulk-op cases are compared on their stored samples with the
+Mann-Whitney U test. A change is reported when p < alpha AND the p50
+moved by more than the threshold, so tiny but "significant" shifts from
+huge samples are not flagged. Memory cases are deterministic enough that
+only the threshold applies.
+
+Usage:
+    python -m benchmarks.compare baseline.json current.json [--alpha 0.01] [--threshold 0.10]
+
+Exit status is 1 if any regression is found.
+"""
+
+import argparse
+import json
+import sys
+
+from benchmarks.stats import mann_whitney_u
+
+MEMORY_FIELDS = ('tracemalloc_peak_bytes', 'rss_delta_bytes', 'trie_depth', 'trie_bitmap_nodes')
+
+
+def _key(entry: dict) -> tuple:
+    return (entry['container'], entry['op'], entry['key_type'], entry['size'])
+
+
+def _format_case(key: tuple) -> str:
+    container, op, key_type, size = key
+    return f"{container}.{op}[{key_type}, {size:,}]"
+
+
+def compare_results(baseline: dict, current: dict, alpha: float, threshold: float) -> list[dict]:
+    """
+    Pairwise comparison of matching cases.
+
+    Returns:
+        One dict per matched case with 'case', 'metric', 'ratio', 'p' (None
+        for memory) and 'verdict' ('regression', 'improvement' or 'same')
+    """
+    base_index = {_key(e): e for e in baseline.get('results', [])}
+    rows = []
+    for entry in current.get('results', []):
+        key = _key(entry)
+        base = base_index.get(key)
+        if base is None:
+            continue
+
+        if entry['op'] == 'memory':
+            for field in MEMORY_FIELDS:
+                old, new = base.get(field, 0), entry.get(field, 0)
+                if old <= 0:
+                    continue
+                ratio = new / old
+                verdict = 'same'
+                if ratio > 1 + threshold:
+                    verdict = 'regression'
+                elif ratio < 1 - threshold:
+                    verdict = 'improvement'
+                rows.append({'case': key, 'metric': field, 'ratio': ratio,
+                             'p': None, 'verdict': verdict})
+            continue
+
+        old, new = base.get('p50', 0.0), entry.get('p50', 0.0)
+        if old <= 0:
+            continue
+        ratio = new / old
+        _, p = mann_whitney_u(base.get('samples', []), entry.get('samples', []))
+        verdict = 'same'
+        if p < alpha and ratio > 1 + threshold:
+            verdict = 'regression'
+        elif p < alpha and ratio < 1 - threshold:
+            verdict = 'improvement'
+        rows.append({'case': key, 'metric': 'p50', 'ratio': ratio, 'p': p, 'verdict': verdict})
+    return rows
+
+
+def report(baseline: dict, current: dict, alpha: float = 0.01, threshold: float = 0.10) -> list[dict]:
+    """Print significant changes to stderr and return the regressions."""
+    rows = compare_results(baseline, current, alpha, threshold)
+    builds = [r.get('meta', {}).get('build') for r in (baseline, current)]
+    if builds[0] != builds[1]:
+        print(f"\nBuild configs differ: baseline {builds[0]}, current {builds[1]}", file=sys.stderr)
+    changed = [r for r in rows if r['verdict'] != 'same']
+    print(f"\nCompared {len(rows)} metrics: "
+          f"{sum(r['verdict'] == 'regression' for r in rows)} regressions, "
+          f"{sum(r['verdict'] == 'improvement' for r in rows)} improvements "
+          f"(alpha={alpha}, threshold={threshold:.0%})", file=sys.stderr)
+    for r in sorted(changed, key=lambda r: -abs(r['ratio'] - 1)):
+        p = f"p={r['p']:.2g}" if r['p'] is not None else ''
+        print(f"  {r['verdict']:<12}{_format_case(r['case']):<55}{r['metric']:<26}"
+              f"x{r['ratio']:.3f} {p}", file=sys.stderr)
+    return [r for r in rows if r['verdict'] == 'regression']
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--alpha', type=float, default=0.01)
+    parser.add_argument('--threshold', type=float, default=0.10)
+    args = parser.parse_args(argv)
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.current) as f:
+        current = json.load(f)
+    return 1 if report(baseline, current, args.alpha, args.threshold) else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,509 @@
+/**
+ * bench_native - C++ microbenchmarks for the pypersistent containers
+ *
+ * Drives PersistentDict, PersistentList, PersistentSortedDict,
+ * PersistentArrayMap and BulkOpArena directly from C++ inside an embedded
+ * interpreter, so timings exclude the Python call layer and show node-level
+ * effects (layout, allocation, hashing).
+ *
+ * The pypersistent module itself is linked in and registered as a builtin
+ * before the interpreter starts, so pybind11 type registrations (used by
+ * merge/update and the sets) are in place.
+ *
+ * Statistics: each case runs `warmup` discarded passes, then `runs` measured
+ * passes. Per-op time is reported as the median over passes, with min, max,
+ * p90 and the coefficient of variation (see
+ * docs/optimizations/benchmarking-methodology.md).
+ *
+ * Usage:
+ *   bench_native [--sizes 1000,100000] [--keys int,str,tuple] [--runs 7]
+ *                [--warmup 1] [--filter substring] [--json out.json]
+ */
+
+#include <pybind11/embed.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arena_allocator.hpp"
+#include "persistent_array_map.hpp"
+#include "persistent_dict.hpp"
+#include "persistent_list.hpp"
+#include "persistent_sorted_dict.hpp"
+
+namespace py = pybind11;
+
+extern "C" PyObject* PyInit_pypersistent();
+
+namespace {
+
+//=============================================================================
+// Options and results
+//=============================================================================
+
+struct Options {
+    std::vector<size_t> sizes = {1000, 100000, 1000000};
+    std::vector<std::string> keyTypes = {"int", "str", "tuple"};
+    int runs = 7;
+    int warmup = 1;
+    std::string filter;
+    std::string jsonPath;
+};
+
+struct Result {
+    std::string container;
+    std::string operation;
+    std::string keyType;
+    size_t size;
+    size_t opsPerRun;
+    double medianNs;  // Per operation
+    double minNs;
+    double maxNs;
+    double p90Ns;
+    double cvPercent;
+};
+
+std::vector<size_t> parseSizes(const std::string& arg) {
+    std::vector<size_t> sizes;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        sizes.push_back(static_cast<size_t>(std::stoull(item)));
+    }
+    return sizes;
+}
+
+std::vector<std::string> parseList(const std::string& arg) {
+    std::vector<std::string> items;
+    std::stringstream ss(arg);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+Options parseArgs(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--sizes") {
+            opts.sizes = parseSizes(value());
+        } else if (arg == "--keys") {
+            opts.keyTypes = parseList(value());
+        } else if (arg == "--runs") {
+            opts.runs = std::max(1, std::stoi(value()));
+        } else if (arg == "--warmup") {
+            opts.warmup = std::max(0, std::stoi(value()));
+        } else if (arg == "--filter") {
+            opts.filter = value();
+        } else if (arg == "--json") {
+            opts.jsonPath = value();
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return opts;
+}
+
+//=============================================================================
+// Measurement
+//=============================================================================
+
+double percentile(std::vector<double> sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    double pos = q * (sorted.size() - 1);
+    size_t lo = static_cast<size_t>(std::floor(pos));
+    size_t hi = static_cast<size_t>(std::ceil(pos));
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - lo);
+}
+
+class Bench {
+public:
+    explicit Bench(const Options& opts) : opts_(opts) {}
+
+    /**
+     * Time `body` over opts.runs passes. `setup` runs before every pass and
+     * is not timed; `body` must perform `ops` operations.
+     */
+    void run(const std::string& container, const std::string& operation,
+             const std::string& keyType, size_t size, size_t ops,
+             const std::function<void()>& setup, const std::function<void()>& body) {
+        std::string name = container + "." + operation;
+        if (!opts_.filter.empty() && name.find(opts_.filter) == std::string::npos) {
+            return;
+        }
+
+        for (int i = 0; i < opts_.warmup; ++i) {
+            setup();
+            body();
+        }
+
+        std::vector<double> perOp;
+        perOp.reserve(opts_.runs);
+        for (int i = 0; i < opts_.runs; ++i) {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            perOp.push_back(ns / static_cast<double>(ops));
+        }
+
+        std::sort(perOp.begin(), perOp.end());
+        double mean = 0.0;
+        for (double t : perOp) mean += t;
+        mean /= perOp.size();
+        double var = 0.0;
+        for (double t : perOp) var += (t - mean) * (t - mean);
+        double stdev = perOp.size() > 1 ? std::sqrt(var / (perOp.size() - 1)) : 0.0;
+
+        Result r{container, operation, keyType, size, ops,
+                 percentile(perOp, 0.5), perOp.front(), perOp.back(),
+                 percentile(perOp, 0.9), mean > 0 ? stdev / mean * 100.0 : 0.0};
+        results_.push_back(r);
+
+        std::fprintf(stderr, "%-22s %-14s %-6s %10zu %12.1f ns/op  (CV %5.1f%%, %.1f-%.1f)\n",
+                     container.c_str(), operation.c_str(), keyType.c_str(), size,
+                     r.medianNs, r.cvPercent, r.minNs, r.maxNs);
+    }
+
+    const std::vector<Result>& results() const { return results_; }
+
+private:
+    const Options& opts_;
+    std::vector<Result> results_;
+};
+
+//=============================================================================
+// Workloads
+//=============================================================================
+
+// Keys are generated up front so their construction is never timed
+std::vector<py::object> makeKeys(const std::string& keyType, size_t n) {
+    std::vector<py::object> keys;
+    keys.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (keyType == "int") {
+            keys.push_back(py::int_(i));
+        } else if (keyType == "str") {
+            keys.push_back(py::str("key-" + std::to_string(i)));
+        } else if (keyType == "tuple") {
+            keys.push_back(py::make_tuple(i / 1000, i % 1000));
+        } else {
+            throw std::invalid_argument("unknown key type " + keyType);
+        }
+    }
+    return keys;
+}
+
+py::dict makeDict(const std::vector<py::object>& keys, size_t from, size_t to) {
+    py::dict d;
+    for (size_t i = from; i < to; ++i) {
+        d[keys[i]] = py::int_(i);
+    }
+    return d;
+}
+
+void benchDict(Bench& bench, const std::string& kt, const std::vector<py::object>& keys) {
+    const size_t n = keys.size();
+    py::dict source = makeDict(keys, 0, n);
+    PersistentDict full = PersistentDict::fromDict(source);
+    PersistentDict scratch;
+
+    bench.run("PersistentDict", "bulk_build", kt, n, n, [] {}, [&] {
+        scratch = PersistentDict::fromDict(source);
+    });
+
+    bench.run("PersistentDict", "insert", kt, n, n, [&] { scratch = PersistentDict(); }, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            scratch = scratch.assoc(keys[i], keys[i]);
+        }
+    });
+
+    bench.run("PersistentDict", "lookup", kt, n, n, [] {}, [&] {
+        for (const auto& k : keys) {
+            full.get(k);
+        }
+    });
+
+    bench.run("PersistentDict", "delete", kt, n, n, [&] { scratch = full; }, [&] {
+        for (const auto& k : keys) {
+            scratch = scratch.dissoc(k);
+        }
+    });
+
+    // Half-overlapping merge exercises the structural mergeNodes path
+    PersistentDict right = PersistentDict::fromDict(makeDict(keys, n / 2, n));
+    py::object rightObj = py::cast(right);
+    bench.run("PersistentDict", "merge", kt, n, n, [] {}, [&] {
+        scratch = full.update(rightObj);
+    });
+
+    py::list sink;
+    bench.run("PersistentDict", "iterate", kt, n, n, [] {}, [&] {
+        sink = full.itemsList();
+    });
+
+    scratch = PersistentDict();
+}
+
+void benchSortedDict(Bench& bench, const std::string& kt, const std::vector<py::object>& keys) {
+    const size_t n = keys.size();
+    py::dict source = makeDict(keys, 0, n);
+    PersistentSortedDict full = PersistentSortedDict::fromDict(source);
+    PersistentSortedDict scratch;
+
+    bench.run("PersistentSortedDict", "bulk_build", kt, n, n, [] {}, [&] {
+        scratch = PersistentSortedDict::fromDict(source);
+    });
+
+    bench.run("PersistentSortedDict", "insert", kt, n, n,
+              [&] { scratch = PersistentSortedDict(); }, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            scratch = scratch.assoc(keys[i], keys[i]);
+        }
+    });
+
+    bench.run("PersistentSortedDict", "lookup", kt, n, n, [] {}, [&] {
+        for (const auto& k : keys) {
+            full.get(k, py::none());
+        }
+    });
+
+    bench.run("PersistentSortedDict", "delete", kt, n, n, [&] { scratch = full; }, [&] {
+        for (const auto& k : keys) {
+            scratch = scratch.dissoc(k);
+        }
+    });
+
+    py::list sink;
+    bench.run("PersistentSortedDict", "iterate", kt, n, n, [] {}, [&] {
+        sink = full.items();
+    });
+
+    scratch = PersistentSortedDict();
+}
+
+void benchList(Bench& bench, const std::vector<py::object>& values) {
+    const size_t n = values.size();
+    PersistentList full;
+    for (const auto& v : values) {
+        full = full.conj(v);
+    }
+    PersistentList scratch;
+
+    bench.run("PersistentList", "append", "int", n, n, [&] { scratch = PersistentList(); }, [&] {
+        for (const auto& v : values) {
+            scratch = scratch.conj(v);
+        }
+    });
+
+    bench.run("PersistentList", "lookup", "int", n, n, [] {}, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            full.nth(i);
+        }
+    });
+
+    bench.run("PersistentList", "update", "int", n, n, [&] { scratch = full; }, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            scratch = scratch.assoc(i, values[n - 1 - i]);
+        }
+    });
+
+    bench.run("PersistentList", "pop", "int", n, n, [&] { scratch = full; }, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            scratch = scratch.pop();
+        }
+    });
+
+    bench.run("PersistentList", "iterate", "int", n, n, [] {}, [&] {
+        VectorIterator it = full.iter();
+        while (it.hasNext()) {
+            it.next();
+        }
+    });
+
+    scratch = PersistentList();
+}
+
+void benchArrayMap(Bench& bench, const std::string& kt) {
+    // ArrayMap is capped at 8 entries, so each pass repeats small-map work
+    constexpr size_t kEntries = 8;
+    constexpr size_t kRepeats = 10000;
+    std::vector<py::object> keys = makeKeys(kt, kEntries);
+    PersistentArrayMap full;
+    for (const auto& k : keys) {
+        full = full.assoc(k, k);
+    }
+    PersistentArrayMap scratch;
+
+    bench.run("PersistentArrayMap", "insert", kt, kEntries, kEntries * kRepeats, [] {}, [&] {
+        for (size_t r = 0; r < kRepeats; ++r) {
+            scratch = PersistentArrayMap();
+            for (const auto& k : keys) {
+                scratch = scratch.assoc(k, k);
+            }
+        }
+    });
+
+    bench.run("PersistentArrayMap", "lookup", kt, kEntries, kEntries * kRepeats, [] {}, [&] {
+        for (size_t r = 0; r < kRepeats; ++r) {
+            for (const auto& k : keys) {
+                full.get(k);
+            }
+        }
+    });
+
+    bench.run("PersistentArrayMap", "delete", kt, kEntries, kEntries * kRepeats, [] {}, [&] {
+        for (size_t r = 0; r < kRepeats; ++r) {
+            scratch = full;
+            for (const auto& k : keys) {
+                scratch = scratch.dissoc(k);
+            }
+        }
+    });
+}
+
+void benchArena(Bench& bench, size_t n) {
+    py::object key = py::int_(1);
+    auto makeArray = [&] {
+        NodeArray array;
+        array.push_back(makeEntry(key, key, pmutils::hashKey(key)));
+        return array;
+    };
+
+    // Nodes hold shared_ptr<Entry>, so both variants run the destructor;
+    // the difference is the allocation strategy alone
+    bench.run("BulkOpArena", "allocate", "node", n, n, [] {}, [&] {
+        BulkOpArena arena;
+        std::vector<BitmapNode*> nodes;
+        nodes.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            nodes.push_back(arena.allocate<BitmapNode>(1u, makeArray()));
+        }
+        for (BitmapNode* node : nodes) {
+            node->~BitmapNode();
+        }
+    });
+
+    bench.run("BulkOpArena", "heap_baseline", "node", n, n, [] {}, [&] {
+        std::vector<BitmapNode*> nodes;
+        nodes.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            nodes.push_back(new BitmapNode(1u, makeArray()));
+        }
+        for (BitmapNode* node : nodes) {
+            delete node;
+        }
+    });
+}
+
+//=============================================================================
+// JSON output
+//=============================================================================
+
+std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';  // Py_GetVersion() may embed a newline
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void writeJson(std::ostream& os, const Options& opts, const std::vector<Result>& results) {
+    os << "{\n";
+    os << "  \"harness\": \"bench_native\",\n";
+    os << "  \"python\": \"" << jsonEscape(Py_GetVersion()) << "\",\n";
+    os << "  \"hamt_bits\": " << HASH_BITS << ",\n";
+    os << "  \"vector_bits\": " << PYPERSISTENT_VECTOR_BITS << ",\n";
+    os << "  \"runs\": " << opts.runs << ",\n";
+    os << "  \"warmup\": " << opts.warmup << ",\n";
+    os << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        os << "    {\"container\": \"" << r.container << "\", "
+           << "\"operation\": \"" << r.operation << "\", "
+           << "\"key_type\": \"" << r.keyType << "\", "
+           << "\"size\": " << r.size << ", "
+           << "\"ops_per_run\": " << r.opsPerRun << ", "
+           << "\"median_ns\": " << r.medianNs << ", "
+           << "\"min_ns\": " << r.minNs << ", "
+           << "\"max_ns\": " << r.maxNs << ", "
+           << "\"p90_ns\": " << r.p90Ns << ", "
+           << "\"cv_percent\": " << r.cvPercent << "}"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    try {
+        opts = parseArgs(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "bench_native: %s\n", e.what());
+        return 2;
+    }
+
+    // Register the linked-in extension before the interpreter starts
+    if (PyImport_AppendInittab("pypersistent", &PyInit_pypersistent) == -1) {
+        std::fprintf(stderr, "bench_native: could not register pypersistent\n");
+        return 1;
+    }
+
+    py::scoped_interpreter guard;
+    py::module_::import("pypersistent");
+
+    Bench bench(opts);
+    try {
+        for (size_t n : opts.sizes) {
+            for (const auto& kt : opts.keyTypes) {
+                std::vector<py::object> keys = makeKeys(kt, n);
+                benchDict(bench, kt, keys);
+                benchSortedDict(bench, kt, keys);
+            }
+            benchList(bench, makeKeys("int", n));
+            benchArena(bench, n);
+        }
+        for (const auto& kt : opts.keyTypes) {
+            benchArrayMap(bench, kt);
+        }
+    } catch (const py::error_already_set& e) {
+        std::fprintf(stderr, "bench_native: Python error: %s\n", e.what());
+        return 1;
+    }
+
+    if (opts.jsonPath.empty()) {
+        writeJson(std::cout, opts, bench.results());
+    } else {
+        std::ofstream out(opts.jsonPath);
+        writeJson(out, opts, bench.results());
+    }
+    return 0;
+}
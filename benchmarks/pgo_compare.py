@@ -0,0 +1,126 @@
+"""
+Build the extension twice, default and PYPERSISTENT_PGO=1, and compare.
+
+Each build goes to its own directory under --workdir and is benchmarked
+with benchmarks.run in a fresh interpreter that imports it first. The two
+result files are then compared with benchmarks.compare. A Markdown summary
+of the comparison is written next to them (pgo-summary.md) for pasting
+into docs/optimizations/pgo-lto.md or a pull request.
+
+Both builds use the same compiler, flags and node widths apart from the
+PGO/LTO switches. The baseline build ignores any PYPERSISTENT_PGO/LTO
+already set in the environment.
+
+Usage:
+    python -m benchmarks.pgo_compare --preset quick
+    python -m benchmarks.pgo_compare --workdir build-pgo --sizes 1000,100000 --keys int,str
+
+Arguments not listed below are passed through to benchmarks.run. Exit
+status is 1 if the PGO build has any significant regression.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+from benchmarks import compare
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+VARIANTS = (
+    ('default', {}),
+    ('pgo', {'PYPERSISTENT_PGO': '1'}),
+)
+
+
+def build(name: str, extra_env: dict, workdir: str) -> str:
+    """
+    Build the extension into workdir/name.
+
+    Returns:
+        Directory holding the built module
+    """
+    lib = os.path.join(workdir, name, 'lib')
+    temp = os.path.join(workdir, name, 'temp')
+    env = {k: v for k, v in os.environ.items()
+           if k not in ('PYPERSISTENT_PGO', 'PYPERSISTENT_LTO')}
+    env.update(extra_env)
+    print(f"building {name} -> {lib}", file=sys.stderr)
+    subprocess.run([sys.executable, 'setup.py', 'build_ext', '--force',
+                    '--build-lib', lib, '--build-temp', temp],
+                   cwd=ROOT, env=env, check=True)
+    return lib
+
+
+def run_benchmarks(lib: str, output: str, run_args: list) -> dict:
+    """Run benchmarks.run against the module in lib and load its results."""
+    env = dict(os.environ)
+    env['PYTHONPATH'] = os.pathsep.join(filter(None, [lib, ROOT, env.get('PYTHONPATH')]))
+    # Run from lib so an in-place build in the checkout cannot shadow it
+    found = subprocess.run([sys.executable, '-c', 'import pypersistent; print(pypersistent.__file__)'],
+                           cwd=lib, env=env, check=True, capture_output=True, text=True).stdout
+    if os.path.dirname(os.path.abspath(found.strip())) != os.path.abspath(lib):
+        raise RuntimeError(f"expected pypersistent from {lib}, got {found.strip()}")
+    subprocess.run([sys.executable, '-m', 'benchmarks.run', '--output', output] + run_args,
+                   cwd=lib, env=env, check=True)
+    with open(output) as f:
+        return json.load(f)
+
+
+def markdown_summary(baseline: dict, current: dict, alpha: float, threshold: float) -> str:
+    """
+    Markdown table of every compared metric, largest changes first.
+
+    Returns:
+        Summary text: build configs, machine, counts and one row per metric
+    """
+    rows = compare.compare_results(baseline, current, alpha, threshold)
+    meta = current.get('meta', {})
+    lines = [
+        f"Baseline build: `{baseline.get('meta', {}).get('build')}`  ",
+        f"PGO build: `{meta.get('build')}`  ",
+        f"Machine: {meta.get('platform')} ({meta.get('machine')}), Python {meta.get('python', '').split()[0]}  ",
+        f"Arguments: `{' '.join(meta.get('args_passed', []))}`",
+        '',
+        f"{len(rows)} metrics: {sum(r['verdict'] == 'improvement' for r in rows)} improvements, "
+        f"{sum(r['verdict'] == 'regression' for r in rows)} regressions "
+        f"(alpha={alpha}, threshold={threshold:.0%}). Ratio is PGO / baseline; below 1 is faster.",
+        '',
+        '| Case | Metric | Ratio | p | Verdict |',
+        '|------|--------|------:|--:|---------|',
+    ]
+    for r in sorted(rows, key=lambda r: -abs(r['ratio'] - 1)):
+        p = f"{r['p']:.2g}" if r['p'] is not None else ''
+        lines.append(f"| {compare._format_case(r['case'])} | {r['metric']} | "
+                     f"{r['ratio']:.3f} | {p} | {r['verdict']} |")
+    return '\n'.join(lines) + '\n'
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--workdir', default='build-pgo-compare',
+                        help='Directory for the two builds and their results')
+    parser.add_argument('--alpha', type=float, default=0.01)
+    parser.add_argument('--threshold', type=float, default=0.10)
+    args, run_args = parser.parse_known_args(argv)
+
+    workdir = os.path.abspath(args.workdir)
+    results = {}
+    for name, extra_env in VARIANTS:
+        lib = build(name, extra_env, workdir)
+        results[name] = run_benchmarks(lib, os.path.join(workdir, f"{name}.json"), run_args)
+        results[name].setdefault('meta', {})['args_passed'] = run_args
+
+    baseline, current = results['default'], results['pgo']
+    summary = os.path.join(workdir, 'pgo-summary.md')
+    with open(summary, 'w') as f:
+        f.write(markdown_summary(baseline, current, args.alpha, args.threshold))
+    regressions = compare.report(baseline, current, args.alpha, args.threshold)
+    print(f"\nResults in {workdir}; summary in {summary}", file=sys.stderr)
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,159 @@
+"""
+Representative workload for profile-guided builds.
+
+setup.py runs this script against the instrumented extension when
+PYPERSISTENT_PGO=1, then recompiles with the recorded profile. It should
+exercise the paths that matter in real use, in roughly realistic
+proportions, and nothing exotic: branch and inlining decisions are made
+for whatever runs here.
+
+Covers, with int, str and tuple keys:
+
+- PersistentDict: bulk build, lookup/get/contains, assoc/dissoc chains,
+  update/merge, iteration, equality and diff
+- PersistentList: append, nth/index, set, slicing, pop, iteration
+- PersistentSortedDict: assoc/dissoc, lookup, range views, first/last
+- PersistentSet: build, conj/disj, membership, set algebra
+
+Only the standard library and pypersistent are imported, so the script
+runs from any directory against whichever pypersistent is first on the
+path.
+
+Usage:
+    python benchmarks/pgo_workload.py [--scale 1.0]
+"""
+
+import argparse
+import random
+import sys
+import time
+
+import pypersistent as pp
+
+KEY_TYPES = {
+    'int': lambda i: i,
+    'str': lambda i: f"key-{i}",
+    'tuple': lambda i: (i // 1000, i % 1000),
+}
+
+
+def dict_workload(keys, rng):
+    m = pp.PersistentDict.from_dict(dict.fromkeys(keys, 0))
+    probes = [keys[rng.randrange(len(keys))] for _ in range(len(keys))]
+    for k in probes:
+        m[k]
+        m.get(k, None)
+        k in m
+    # Incremental edits on a large map: the path-copy hot path
+    n = m
+    for i, k in enumerate(probes[:len(probes) // 2]):
+        n = n.assoc(k, i)
+        if i % 3 == 0:
+            n = n.dissoc(probes[i // 2])
+    built = pp.PersistentDict()
+    for k in keys[:len(keys) // 4]:
+        built = built.assoc(k, True)
+    m.update({k: 1 for k in probes[:1000]})
+    m.merge(n)
+    for _ in m.items():
+        pass
+    list(m.keys_list())
+    m == n
+    m.diff(n)
+
+
+def list_workload(items, rng):
+    v = pp.PersistentList()
+    for x in items:
+        v = v.append(x)
+    v = pp.PersistentList.from_list(items)
+    n = len(v)
+    for _ in range(n):
+        i = rng.randrange(n)
+        v[i]
+        v.nth(i)
+    w = v
+    for i in range(0, n, 3):
+        w = w.set(i, -i)
+    for _ in range(min(n, 1000)):
+        w = w.pop()
+    v[n // 4:n // 2]
+    v[::-1]
+    for _ in v:
+        pass
+    v == w
+
+
+def sorted_dict_workload(keys, rng):
+    ordered = sorted(keys)
+    m = pp.PersistentSortedDict()
+    for k in keys[:len(keys) // 2]:
+        m = m.assoc(k, True)
+    m = pp.PersistentSortedDict.from_dict(dict.fromkeys(keys, True))
+    for _ in range(len(keys)):
+        k = keys[rng.randrange(len(keys))]
+        m[k]
+        k in m
+    for i in range(0, len(ordered) - 50, max(1, len(ordered) // 200)):
+        r = m.range(ordered[i], ordered[i + 50])
+        len(r)
+        for _ in r.items():
+            pass
+    n = m
+    for k in keys[::4]:
+        n = n.dissoc(k)
+    m.first()
+    m.last()
+    for _ in m.items():
+        pass
+
+
+def set_workload(keys, rng):
+    s = pp.PersistentSet.from_list(keys)
+    t = pp.PersistentSet()
+    for k in keys[::2]:
+        t = t.conj(k)
+    for _ in range(len(keys)):
+        keys[rng.randrange(len(keys))] in s
+    u = s
+    for k in keys[::5]:
+        u = u.disj(k)
+    s.union(t)
+    s.intersection(u)
+    s.difference(t)
+    for _ in s:
+        pass
+
+
+WORKLOADS = (
+    ('PersistentDict', dict_workload),
+    ('PersistentList', list_workload),
+    ('PersistentSortedDict', sorted_dict_workload),
+    ('PersistentSet', set_workload),
+)
+
+
+def main(argv=None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--scale', type=float, default=1.0,
+                        help='Multiply the container sizes by this factor')
+    parser.add_argument('--seed', type=int, default=12345)
+    args = parser.parse_args(argv)
+
+    rng = random.Random(args.seed)
+    # Small containers stay in the root node or tail; large ones go deep
+    sizes = [max(1, int(n * args.scale)) for n in (8, 100, 5_000, 100_000)]
+    print(f"pgo workload: {pp.__file__}", file=sys.stderr)
+    for name, workload in WORKLOADS:
+        t0 = time.perf_counter()
+        for key_type, make in KEY_TYPES.items():
+            for size in sizes:
+                keys = [make(i) for i in range(size)]
+                rng.shuffle(keys)
+                workload(keys, rng)
+        print(f"  {name:<22}{time.perf_counter() - t0:6.2f}s", file=sys.stderr)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
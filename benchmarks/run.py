@@ -0,0 +1,293 @@
+"""
+Run the pypersistent benchmark suite and write JSON results.
+
+Measures, for every container x key type x size:
+
+- single-op latency distributions (p50/p99/p999) for lookup, insert and
+  delete, timed one call at a time with perf_counter_ns and corrected for
+  timer overhead
+- whole-operation time for bulk build and full iteration (median of runs)
+- memory: tracemalloc current/peak bytes and RSS growth for one build
+- trie shape for containers with trie_stats() (depth, bitmap nodes,
+  fan-out), next to the shape raw unmixed hashes would give (see
+  benchmarks.trie_shape); the 'strided' and 'tuple' key types show the
+  effect of hash mixing
+
+Usage:
+    python -m benchmarks.run --preset quick --output results.json
+    python -m benchmarks.run --sizes 10,1000 --keys int,str --containers PersistentDict,dict
+    python -m benchmarks.run --preset quick --baseline baseline.json
+
+With --baseline, results are compared using benchmarks.compare and the
+exit status is 1 if any statistically significant regression is found.
+meta.build records the node widths the module was compiled with, so runs
+against builds with different PYPERSISTENT_HAMT_BITS/VECTOR_BITS can be
+compared the same way.
+"""
+
+import argparse
+import datetime
+import gc
+import json
+import os
+import platform
+import random
+import sys
+import time
+import tracemalloc
+
+from benchmarks import compare
+from benchmarks.stats import downsample, summarize
+from benchmarks.trie_shape import simulate_shape
+from benchmarks.workloads import KEY_TYPES, adapters, make_keys
+
+PRESETS = {
+    'quick': [10, 1_000, 100_000],
+    'full': [10, 100, 1_000, 10_000, 100_000, 1_000_000, 10_000_000],
+    'huge': [10, 1_000, 100_000, 10_000_000, 100_000_000],
+}
+
+LATENCY_OPS = ('lookup', 'insert', 'delete')
+
+# Largest size for which the unmixed trie shape is simulated (pure Python)
+UNMIXED_SHAPE_MAX = 1_000_000
+BULK_OPS = ('build', 'iterate')
+
+
+def current_rss() -> int:
+    """Resident set size in bytes (0 if unavailable)."""
+    try:
+        with open('/proc/self/statm') as f:
+            return int(f.read().split()[1]) * os.sysconf('SC_PAGE_SIZE')
+    except (OSError, ValueError, IndexError):
+        pass
+    try:
+        import resource
+        # Peak, not current, on platforms without /proc - still monotonic
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        return peak if sys.platform == 'darwin' else peak * 1024
+    except ImportError:
+        return 0
+
+
+def peak_rss() -> int:
+    """Process peak RSS in bytes (0 if unavailable)."""
+    try:
+        import resource
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        return peak if sys.platform == 'darwin' else peak * 1024
+    except ImportError:
+        return 0
+
+
+def timer_overhead_ns(samples: int = 10_000) -> float:
+    """Median cost of an empty perf_counter_ns() pair."""
+    clock = time.perf_counter_ns
+    deltas = []
+    for _ in range(samples):
+        t0 = clock()
+        t1 = clock()
+        deltas.append(t1 - t0)
+    deltas.sort()
+    return float(deltas[len(deltas) // 2])
+
+
+def sample_latencies(op, container, args, undo, overhead: float) -> list[float]:
+    """Time op(container, arg) once per arg; undo (untimed) restores mutable state."""
+    clock = time.perf_counter_ns
+    out = []
+    for arg in args:
+        t0 = clock()
+        op(container, arg)
+        t1 = clock()
+        if undo is not None:
+            undo(container, arg)
+        out.append(max(0.0, (t1 - t0) - overhead))
+    return out
+
+
+def time_runs(fn, runs: int, warmup: int, repeat: int = 1) -> list[float]:
+    """
+    Wall time (ns) per fn() call over `runs` measured runs after `warmup` runs.
+
+    Each run calls fn() `repeat` times so small sizes stay well above timer
+    resolution.
+    """
+    for _ in range(warmup):
+        fn()
+    out = []
+    for _ in range(runs):
+        gc.collect()
+        t0 = time.perf_counter_ns()
+        for _ in range(repeat):
+            fn()
+        out.append(float(time.perf_counter_ns() - t0) / repeat)
+    return out
+
+
+def measure_memory(adapter, keys) -> dict:
+    """Memory attributable to building one container from prebuilt keys."""
+    gc.collect()
+    rss_before = current_rss()
+    tracemalloc.start()
+    container = adapter.build(keys)
+    current, peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+    rss_after = current_rss()
+    result = {
+        'tracemalloc_current_bytes': current,
+        'tracemalloc_peak_bytes': peak,
+        'rss_delta_bytes': max(0, rss_after - rss_before),
+    }
+    if hasattr(container, 'trie_stats'):
+        stats = container.trie_stats()
+        result['trie_depth'] = stats['depth']
+        result['trie_bitmap_nodes'] = stats['bitmap_nodes']
+        result['trie_avg_fanout'] = stats['avg_fanout']
+        if len(keys) <= UNMIXED_SHAPE_MAX:
+            import pypersistent
+            hash_bits = getattr(pypersistent, 'BUILD_CONFIG', {}).get('hamt_bits', 5)
+            unmixed = simulate_shape(keys, hash_bits)
+            result['trie_depth_unmixed'] = unmixed['depth']
+            result['trie_bitmap_nodes_unmixed'] = unmixed['bitmap_nodes']
+            result['trie_avg_fanout_unmixed'] = unmixed['avg_fanout']
+    del container
+    gc.collect()
+    return result
+
+
+def bench_case(adapter, key_type, size, args, rng, overhead, record) -> None:
+    keys = make_keys(key_type, 0, size)
+    absent = make_keys(key_type, size, size + args.samples)
+    container = adapter.build(keys)
+
+    base = {'container': adapter.name, 'key_type': key_type, 'size': size}
+
+    def emit(op, values, unit, extra=None):
+        entry = dict(base, op=op, unit=unit, **summarize(values))
+        entry['samples'] = downsample(values, args.keep_samples)
+        if extra:
+            entry.update(extra)
+        record(entry)
+
+    # Single-op latencies on a fixed container
+    if adapter.kind == 'seq':
+        lookup_args = [rng.randrange(size) for _ in range(args.samples)]
+        delete_args = [keys[-1]] * args.samples
+    else:
+        lookup_args = [keys[rng.randrange(size)] for _ in range(args.samples)]
+        delete_args = [keys[rng.randrange(size)] for _ in range(args.samples)]
+    insert_args = absent[:args.samples]
+
+    op_args = {'lookup': lookup_args, 'insert': insert_args, 'delete': delete_args}
+    undo = {'lookup': None, 'insert': adapter.undo_insert, 'delete': adapter.undo_delete}
+    for op in LATENCY_OPS:
+        if op not in args.ops:
+            continue
+        fn = getattr(adapter, op)
+        sample_latencies(fn, container, op_args[op][:100], undo[op], overhead)  # Warmup
+        emit(op, sample_latencies(fn, container, op_args[op], undo[op], overhead), 'ns')
+
+    repeat = max(1, 10_000 // size)
+    if 'build' in args.ops:
+        runs = time_runs(lambda: adapter.build(keys), args.runs, args.warmup, repeat)
+        emit('build', [t / size for t in runs], 'ns/element')
+    if 'iterate' in args.ops:
+        runs = time_runs(lambda: adapter.iterate(container), args.runs, args.warmup, repeat)
+        emit('iterate', [t / size for t in runs], 'ns/element')
+
+    if 'memory' in args.ops:
+        del container
+        record(dict(base, op='memory', unit='bytes', **measure_memory(adapter, keys)))
+
+
+def parse_args(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--preset', choices=sorted(PRESETS), default='quick')
+    parser.add_argument('--sizes', help='Comma-separated sizes (overrides --preset)')
+    parser.add_argument('--keys', default=','.join(KEY_TYPES),
+                        help='Comma-separated key types: ' + ', '.join(KEY_TYPES))
+    parser.add_argument('--containers', help='Comma-separated container names (default: all)')
+    parser.add_argument('--ops', default=','.join(LATENCY_OPS + BULK_OPS + ('memory',)))
+    parser.add_argument('--samples', type=int, default=20_000,
+                        help='Single-op samples per latency case')
+    parser.add_argument('--keep-samples', type=int, default=1_000,
+                        help='Order statistics stored per case for later comparison')
+    parser.add_argument('--runs', type=int, default=7, help='Measured runs for bulk ops')
+    parser.add_argument('--warmup', type=int, default=1, help='Discarded runs for bulk ops')
+    parser.add_argument('--seed', type=int, default=12345)
+    parser.add_argument('--output', help='Write JSON results here (default: stdout)')
+    parser.add_argument('--baseline', help='Compare against this results file')
+    parser.add_argument('--alpha', type=float, default=0.01,
+                        help='Significance level for the comparison')
+    parser.add_argument('--threshold', type=float, default=0.10,
+                        help='Minimum relative change to report')
+    args = parser.parse_args(argv)
+
+    args.sizes = ([int(s) for s in args.sizes.split(',')] if args.sizes
+                  else PRESETS[args.preset])
+    args.keys = args.keys.split(',')
+    args.ops = set(args.ops.split(','))
+    args.containers = set(args.containers.split(',')) if args.containers else None
+    unknown = set(args.keys) - set(KEY_TYPES)
+    if unknown:
+        parser.error(f"unknown key types: {', '.join(sorted(unknown))}")
+    return args
+
+
+def main(argv=None) -> int:
+    args = parse_args(argv)
+    rng = random.Random(args.seed)
+    overhead = timer_overhead_ns()
+    results = []
+
+    def record(entry):
+        results.append(entry)
+        if 'p50' in entry:
+            print(f"{entry['container']:<22}{entry['op']:<9}{entry['key_type']:<8}"
+                  f"{entry['size']:>11,}  p50 {entry['p50']:>10.1f}  p99 {entry['p99']:>10.1f}"
+                  f"  p999 {entry['p999']:>10.1f} {entry['unit']}", file=sys.stderr)
+
+    for adapter in adapters():
+        if args.containers is not None and adapter.name not in args.containers:
+            continue
+        for size in args.sizes:
+            if adapter.max_size is not None and size > adapter.max_size:
+                continue
+            for key_type in args.keys:
+                bench_case(adapter, key_type, size, args, rng, overhead, record)
+
+    import pypersistent
+    report = {
+        'meta': {
+            'timestamp': datetime.datetime.now(datetime.timezone.utc).isoformat(),
+            'python': sys.version,
+            'implementation': platform.python_implementation(),
+            'platform': platform.platform(),
+            'machine': platform.machine(),
+            'pypersistent': getattr(pypersistent, '__version__', 'unknown'),
+            'build': dict(getattr(pypersistent, 'BUILD_CONFIG', {})),
+            'timer_overhead_ns': overhead,
+            'peak_rss_bytes': peak_rss(),
+            'args': {k: (sorted(v) if isinstance(v, set) else v) for k, v in vars(args).items()},
+        },
+        'results': results,
+    }
+
+    text = json.dumps(report, indent=1)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        print(text)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare.report(baseline, report, args.alpha, args.threshold)
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
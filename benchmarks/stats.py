@@ -0,0 +1,114 @@
+"""
+Statistics helpers for the benchmark suite.
+
+Latency distributions are summarized by order statistics (p50/p99/p999)
+rather than mean/stdev, and compared with the Mann-Whitney U test, which
+makes no normality assumption. Timing noise is heavy-tailed, so a t-test
+would be misleading.
+"""
+
+import math
+import statistics
+from typing import Sequence
+
+
+def percentile(sorted_values: Sequence[float], q: float) -> float:
+    """
+    Linear-interpolated percentile of pre-sorted values.
+
+    Args:
+        sorted_values: Values in ascending order
+        q: Quantile in [0, 1]
+
+    Returns:
+        Interpolated value (0.0 for empty input)
+    """
+    if not sorted_values:
+        return 0.0
+    pos = q * (len(sorted_values) - 1)
+    lo = math.floor(pos)
+    hi = math.ceil(pos)
+    return sorted_values[lo] + (sorted_values[hi] - sorted_values[lo]) * (pos - lo)
+
+
+def summarize(values: Sequence[float]) -> dict:
+    """
+    Summary statistics for a sample.
+
+    Returns:
+        Dict with n, min, max, mean, p50, p90, p99, p999 and cv (percent)
+    """
+    s = sorted(values)
+    mean = statistics.fmean(s) if s else 0.0
+    stdev = statistics.stdev(s) if len(s) > 1 else 0.0
+    return {
+        'n': len(s),
+        'min': s[0] if s else 0.0,
+        'max': s[-1] if s else 0.0,
+        'mean': mean,
+        'p50': percentile(s, 0.50),
+        'p90': percentile(s, 0.90),
+        'p99': percentile(s, 0.99),
+        'p999': percentile(s, 0.999),
+        'cv': (stdev / mean * 100.0) if mean > 0 else 0.0,
+    }
+
+
+def downsample(values: Sequence[float], limit: int) -> list[float]:
+    """
+    Keep at most `limit` evenly spaced order statistics.
+
+    The result has the same distribution shape as the input, which is all
+    the rank test needs, while keeping result files small.
+    """
+    s = sorted(values)
+    if len(s) <= limit:
+        return s
+    step = (len(s) - 1) / (limit - 1)
+    return [s[round(i * step)] for i in range(limit)]
+
+
+def mann_whitney_u(a: Sequence[float], b: Sequence[float]) -> tuple[float, float]:
+    """
+    Two-sided Mann-Whitney U test (normal approximation, tie-corrected).
+
+    Args:
+        a: First sample (e.g. baseline)
+        b: Second sample (e.g. candidate)
+
+    Returns:
+        (U statistic for `a`, two-sided p-value)
+    """
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 0.0, 1.0
+
+    combined = sorted([(x, 0) for x in a] + [(x, 1) for x in b])
+    n = n1 + n2
+    rank_sum_a = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        avg_rank = (i + j) / 2.0 + 1.0
+        t = j - i + 1
+        tie_term += t ** 3 - t
+        for k in range(i, j + 1):
+            if combined[k][1] == 0:
+                rank_sum_a += avg_rank
+        i = j + 1
+
+    u = rank_sum_a - n1 * (n1 + 1) / 2.0
+    mu = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return u, 1.0
+
+    # Continuity correction towards the mean
+    diff = u - mu
+    diff -= math.copysign(0.5, diff) if diff != 0 else 0.0
+    z = diff / math.sqrt(variance)
+    p = math.erfc(abs(z) / math.sqrt(2.0))
+    return u, min(1.0, p)
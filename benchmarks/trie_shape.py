@@ -0,0 +1,51 @@
+"""
+HAMT shape of a key set with raw, unmixed Python hashes.
+
+Python hashes feed poorly into a HAMT: ints hash to themselves, so
+sequential IDs share their high bits, and tuples of small ints have
+clustered low bits. PersistentDict avalanches every hash before indexing.
+benchmarks.run reports the real shape from trie_stats() next to the shape
+simulated here, so the effect of mixing shows up per key type (the
+'strided' and 'tuple' key types are the clustered cases).
+"""
+
+MAX_TRIE_SHIFT = 64
+MASK64 = (1 << 64) - 1
+
+
+def simulate_shape(keys: list, hash_bits: int = 5) -> dict:
+    """
+    Compute the HAMT shape produced by the raw hashes of distinct keys.
+
+    Args:
+        keys: Distinct keys
+        hash_bits: Bits per trie level (BUILD_CONFIG['hamt_bits'])
+
+    Returns:
+        Dict with 'depth', 'bitmap_nodes' and 'avg_fanout', matching the
+        corresponding trie_stats() fields
+    """
+    mask = (1 << hash_bits) - 1
+    nodes = 0
+    slots = 0
+    depth = 0
+    # Explicit stack: clustered hashes can nest deeper than the recursion limit allows
+    stack = [([hash(k) & MASK64 for k in keys], 0, 0)] if keys else []
+    while stack:
+        group, shift, level = stack.pop()
+        depth = max(depth, level + 1)
+        if shift >= MAX_TRIE_SHIFT:
+            continue  # Collision bucket
+        nodes += 1
+        buckets: dict[int, list[int]] = {}
+        for h in group:
+            buckets.setdefault((h >> shift) & mask, []).append(h)
+        slots += len(buckets)
+        for bucket in buckets.values():
+            if len(bucket) > 1:
+                stack.append((bucket, shift + hash_bits, level + 1))
+    return {
+        'depth': depth,
+        'bitmap_nodes': nodes,
+        'avg_fanout': slots / nodes if nodes else 0.0,
+    }
@@ -0,0 +1,226 @@
+"""
+Key generators and container adapters for the benchmark suite.
+
+Every container is driven through the same small adapter interface, so a
+single measurement loop covers pypersistent, the built-in dict/list/set
+and (when installed) pyrsistent:
+
+- build(keys)       bulk construction from the keys (untimed setup elsewhere)
+- lookup(c, k)      read one key / index
+- insert(c, k)      add one absent key; returns the new container
+- delete(c, k)      remove one present key; returns the new container
+- iterate(c)        full traversal
+
+Mutable baselines restore their state through `undo`, which is never timed.
+"""
+
+from dataclasses import dataclass
+from typing import Any, Callable, Optional
+
+import pypersistent as pp
+
+try:
+    import pyrsistent
+except ImportError:  # Baseline is optional
+    pyrsistent = None
+
+
+class CustomHashKey:
+    """Key with a Python-level __hash__/__eq__ (exercises the slow hash path)."""
+
+    __slots__ = ('value',)
+
+    def __init__(self, value: int):
+        self.value = value
+
+    def __hash__(self) -> int:
+        return hash(('custom', self.value))
+
+    def __eq__(self, other: object) -> bool:
+        return isinstance(other, CustomHashKey) and self.value == other.value
+
+    def __lt__(self, other: 'CustomHashKey') -> bool:
+        return self.value < other.value  # For the sorted containers
+
+
+KEY_TYPES: dict[str, Callable[[int], Any]] = {
+    'int': lambda i: i,
+    'strided': lambda i: i * 1024,  # Raw hashes share their low bits
+    'str': lambda i: f"key-{i}",
+    'tuple': lambda i: (i // 1000, i % 1000),
+    'custom': CustomHashKey,
+}
+
+
+def make_keys(key_type: str, start: int, stop: int) -> list:
+    """Keys for indices [start, stop) of the given type."""
+    make = KEY_TYPES[key_type]
+    return [make(i) for i in range(start, stop)]
+
+
+def _drain(iterable) -> None:
+    for _ in iterable:
+        pass
+
+
+@dataclass
+class Adapter:
+    """Uniform operations for one container type."""
+
+    name: str
+    kind: str  # 'map', 'set' or 'seq'
+    build: Callable[[list], Any]
+    lookup: Callable[[Any, Any], Any]
+    insert: Callable[[Any, Any], Any]
+    delete: Callable[[Any, Any], Any]
+    iterate: Callable[[Any], None]
+    undo_insert: Optional[Callable[[Any, Any], None]] = None
+    undo_delete: Optional[Callable[[Any, Any], None]] = None
+    max_size: Optional[int] = None
+    baseline: bool = False
+
+
+def _dict_delete(d, k):
+    del d[k]
+    return d
+
+
+def _set_delete(s, k):
+    s.discard(k)
+    return s
+
+
+def _list_pop(lst, _):
+    lst.pop()
+    return lst
+
+
+def _dict_insert(d, k):
+    d[k] = True
+    return d
+
+
+def _set_insert(s, k):
+    s.add(k)
+    return s
+
+
+def _list_append(lst, k):
+    lst.append(k)
+    return lst
+
+
+def adapters() -> list[Adapter]:
+    """All available container adapters (pyrsistent only if installed)."""
+    result = [
+        Adapter('PersistentDict', 'map',
+                build=lambda keys: pp.PersistentDict.from_dict(dict.fromkeys(keys, True)),
+                lookup=lambda c, k: c[k],
+                insert=lambda c, k: c.assoc(k, True),
+                delete=lambda c, k: c.dissoc(k),
+                iterate=lambda c: _drain(c.items())),
+        Adapter('PersistentSortedDict', 'map',
+                build=lambda keys: pp.PersistentSortedDict.from_dict(dict.fromkeys(keys, True)),
+                lookup=lambda c, k: c[k],
+                insert=lambda c, k: c.assoc(k, True),
+                delete=lambda c, k: c.dissoc(k),
+                iterate=lambda c: _drain(c.items())),
+        Adapter('PersistentArrayMap', 'map',
+                build=lambda keys: pp.PersistentArrayMap.from_dict(dict.fromkeys(keys, True)),
+                lookup=lambda c, k: c[k],
+                insert=lambda c, k: c.assoc(k, True),
+                delete=lambda c, k: c.dissoc(k),
+                iterate=lambda c: _drain(c.items()),
+                max_size=7),  # Leaves room for one insert below the cap of 8
+        Adapter('PersistentOrderedDict', 'map',
+                build=lambda keys: pp.PersistentOrderedDict.from_dict(dict.fromkeys(keys, True)),
+                lookup=lambda c, k: c[k],
+                insert=lambda c, k: c.assoc(k, True),
+                delete=lambda c, k: c.dissoc(k),
+                iterate=lambda c: _drain(c.items())),
+        Adapter('PersistentMultiMap', 'map',
+                build=lambda keys: pp.PersistentMultiMap.from_pairs((k, True) for k in keys),
+                lookup=lambda c, k: c[k],
+                insert=lambda c, k: c.add(k, True),
+                delete=lambda c, k: c.remove_all(k),
+                iterate=lambda c: _drain(c.items_list())),
+        Adapter('PersistentBag', 'set',
+                build=lambda keys: pp.PersistentBag.from_iterable(keys),
+                lookup=lambda c, k: c[k],
+                insert=lambda c, k: c.add(k),
+                delete=lambda c, k: c.remove_all(k),
+                iterate=lambda c: _drain(c)),
+        # Point intervals [k, k]; lookup is a stabbing query
+        Adapter('PersistentIntervalMap', 'map',
+                build=lambda keys: pp.PersistentIntervalMap.from_items((k, k, True) for k in keys),
+                lookup=lambda c, k: c.stabbing(k),
+                insert=lambda c, k: c.assoc(k, k, True),
+                delete=lambda c, k: c.dissoc(k, k),
+                iterate=lambda c: _drain(c)),
+        Adapter('PersistentSet', 'set',
+                build=lambda keys: pp.PersistentSet.from_list(keys),
+                lookup=lambda c, k: k in c,
+                insert=lambda c, k: c.conj(k),
+                delete=lambda c, k: c.disj(k),
+                iterate=lambda c: _drain(c)),
+        Adapter('PersistentList', 'seq',
+                build=lambda keys: pp.PersistentList.from_list(keys),
+                lookup=lambda c, i: c[i],
+                insert=lambda c, k: c.append(k),
+                delete=lambda c, _: c.pop(),
+                iterate=lambda c: _drain(c)),
+        Adapter('dict', 'map',
+                build=lambda keys: dict.fromkeys(keys, True),
+                lookup=lambda c, k: c[k],
+                insert=_dict_insert,
+                delete=_dict_delete,
+                iterate=lambda c: _drain(c.items()),
+                undo_insert=lambda c, k: c.__delitem__(k),
+                undo_delete=lambda c, k: c.__setitem__(k, True),
+                baseline=True),
+        Adapter('set', 'set',
+                build=lambda keys: set(keys),
+                lookup=lambda c, k: k in c,
+                insert=_set_insert,
+                delete=_set_delete,
+                iterate=lambda c: _drain(c),
+                undo_insert=lambda c, k: c.discard(k),
+                undo_delete=lambda c, k: c.add(k),
+                baseline=True),
+        Adapter('list', 'seq',
+                build=lambda keys: list(keys),
+                lookup=lambda c, i: c[i],
+                insert=_list_append,
+                delete=_list_pop,
+                iterate=lambda c: _drain(c),
+                undo_insert=lambda c, _: c.pop(),
+                undo_delete=lambda c, k: c.append(k),
+                baseline=True),
+    ]
+
+    if pyrsistent is not None:
+        result += [
+            Adapter('pyrsistent.pmap', 'map',
+                    build=lambda keys: pyrsistent.pmap(dict.fromkeys(keys, True)),
+                    lookup=lambda c, k: c[k],
+                    insert=lambda c, k: c.set(k, True),
+                    delete=lambda c, k: c.discard(k),
+                    iterate=lambda c: _drain(c.items()),
+                    baseline=True),
+            Adapter('pyrsistent.pset', 'set',
+                    build=lambda keys: pyrsistent.pset(keys),
+                    lookup=lambda c, k: k in c,
+                    insert=lambda c, k: c.add(k),
+                    delete=lambda c, k: c.discard(k),
+                    iterate=lambda c: _drain(c),
+                    baseline=True),
+            Adapter('pyrsistent.pvector', 'seq',
+                    build=lambda keys: pyrsistent.pvector(keys),
+                    lookup=lambda c, i: c[i],
+                    insert=lambda c, k: c.append(k),
+                    delete=lambda c, _: c.delete(len(c) - 1),
+                    iterate=lambda c: _drain(c),
+                    baseline=True),
+        ]
+
+    return result
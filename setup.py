@@ -8,8 +8,12 @@ Create wheel: python setup.py bdist_wheel
 
 from setuptools import setup
 from pybind11.setup_helpers import Pybind11Extension, build_ext
-import sys
+import glob
+import os
 import platform
+import shutil
+import subprocess
+import sys
 
 # Determine optimization flags based on platform
 extra_compile_args = []
@@ -39,6 +43,108 @@ else:
     if platform.system() == "Linux" and platform.machine() in ("x86_64", "AMD64"):
         extra_compile_args.append("-march=native")
 
+# Node widths (log2 of the branching factor), fixed at compile time:
+#   PYPERSISTENT_HAMT_BITS=4|5|6    PersistentDict and the maps built on it
+#   PYPERSISTENT_VECTOR_BITS=4|5|6  PersistentList
+# e.g. PYPERSISTENT_HAMT_BITS=6 python setup.py build_ext --inplace
+define_macros = []
+for name in ("PYPERSISTENT_HAMT_BITS", "PYPERSISTENT_VECTOR_BITS"):
+    value = os.environ.get(name)
+    if value:
+        if value not in ("4", "5", "6"):
+            sys.exit(f"{name} must be 4, 5 or 6 (got {value!r})")
+        define_macros.append((name, value))
+
+# Optional optimized build modes (GCC/Clang only):
+#   PYPERSISTENT_LTO=1  link-time optimization across all translation units
+#   PYPERSISTENT_PGO=1  profile-guided build, implies LTO: compile with
+#                       instrumentation, run benchmarks/pgo_workload.py
+#                       against it, then recompile with the profile
+# e.g. PYPERSISTENT_PGO=1 python setup.py build_ext --inplace --force
+PGO = os.environ.get("PYPERSISTENT_PGO") == "1"
+LTO = PGO or os.environ.get("PYPERSISTENT_LTO") == "1"
+if platform.system() == "Windows" and LTO:
+    print("PYPERSISTENT_PGO/PYPERSISTENT_LTO are not supported with MSVC; "
+          "building without them", file=sys.stderr)
+    PGO = LTO = False
+if LTO:
+    extra_compile_args.append("-flto")
+    extra_link_args.append("-flto")
+    # Reported in pypersistent.BUILD_CONFIG, and so in benchmark results
+    define_macros.append(("PYPERSISTENT_LTO_BUILD", "1"))
+if PGO:
+    define_macros.append(("PYPERSISTENT_PGO_BUILD", "1"))
+
+
+class OptimizedBuildExt(build_ext):
+    """build_ext that adds the two-pass profile-guided build (PGO)."""
+
+    def build_extension(self, ext):
+        if not PGO:
+            return super().build_extension(ext)
+
+        profile_dir = os.path.abspath(os.path.join(self.build_temp, "pgo-profile"))
+        shutil.rmtree(profile_dir, ignore_errors=True)
+        os.makedirs(profile_dir)
+        clang = self._is_clang()
+        base_compile = list(ext.extra_compile_args)
+        base_link = list(ext.extra_link_args)
+        # Object paths must match between the passes: that is how GCC pairs
+        # .gcda files with translation units
+        force = self.force
+        self.force = True
+        try:
+            # Pass 1: instrumented build
+            generate = ["-fprofile-generate=" + profile_dir]
+            ext.extra_compile_args = base_compile + generate
+            ext.extra_link_args = base_link + generate
+            super().build_extension(ext)
+            self._run_workload(os.path.dirname(os.path.abspath(self.get_ext_fullpath(ext.name))))
+
+            # Pass 2: optimized build using the profile
+            if clang:
+                profile = self._merge_clang_profile(profile_dir)
+                use = ["-fprofile-use=" + profile]
+            else:
+                if not glob.glob(os.path.join(profile_dir, "*.gcda")):
+                    raise RuntimeError("PGO workload produced no profile data in " + profile_dir)
+                use = ["-fprofile-use=" + profile_dir, "-fprofile-correction",
+                       "-Wno-missing-profile"]
+            ext.extra_compile_args = base_compile + use
+            ext.extra_link_args = base_link + use
+            super().build_extension(ext)
+        finally:
+            self.force = force
+            ext.extra_compile_args = base_compile
+            ext.extra_link_args = base_link
+
+    def _is_clang(self):
+        compiler = getattr(self.compiler, "compiler_so", None) or ["cc"]
+        try:
+            out = subprocess.run([compiler[0], "--version"], capture_output=True, text=True).stdout
+        except OSError:
+            return False
+        return "clang" in out.lower()
+
+    def _run_workload(self, ext_dir):
+        workload = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                "benchmarks", "pgo_workload.py")
+        env = dict(os.environ)
+        env["PYTHONPATH"] = os.pathsep.join(filter(None, [ext_dir, env.get("PYTHONPATH")]))
+        print("running PGO workload " + workload, file=sys.stderr)
+        subprocess.run([sys.executable, workload], env=env, check=True)
+
+    def _merge_clang_profile(self, profile_dir):
+        raw = glob.glob(os.path.join(profile_dir, "*.profraw"))
+        if not raw:
+            raise RuntimeError("PGO workload produced no profile data in " + profile_dir)
+        merged = os.path.join(profile_dir, "default.profdata")
+        tool = shutil.which("llvm-profdata")
+        cmd = [tool] if tool else ["xcrun", "llvm-profdata"]
+        subprocess.run(cmd + ["merge", "-output=" + merged] + raw, check=True)
+        return merged
+
+
 # Define the extension module
 ext_modules = [
     Pybind11Extension(
@@ -49,9 +155,20 @@ ext_modules = [
             "src/persistent_set.cpp",
             "src/persistent_list.cpp",
             "src/persistent_sorted_dict.cpp",
+            "src/persistent_multimap.cpp",
+            "src/persistent_bag.cpp",
+            "src/persistent_ordered_dict.cpp",
+            "src/persistent_interval_map.cpp",
+            "src/persistent_json.cpp",
+            "src/persistent_freeze.cpp",
+            "src/persistent_path.cpp",
+            "src/persistent_history.cpp",
+            "src/persistent_store.cpp",
+            "src/persistent_indexed_dict.cpp",
             "src/bindings.cpp",
         ],
         include_dirs=["src"],
+        define_macros=define_macros,
         extra_compile_args=extra_compile_args,
         extra_link_args=extra_link_args,
         language="c++",
@@ -93,7 +210,7 @@ setup(
     long_description_content_type="text/plain",
     url="https://github.com/cmarschner/pypersistent",
     ext_modules=ext_modules,
-    cmdclass={"build_ext": build_ext},
+    cmdclass={"build_ext": OptimizedBuildExt},
     python_requires=">=3.7",
     install_requires=[
         "pybind11>=2.10.0",
@@ -6,6 +6,7 @@
 #include <memory>
 #include <new>
 #include <stdexcept>
+#include "tracked_alloc.hpp"
 
 /**
  * BulkOpArena - Fast bump-pointer arena allocator for bulk operations
@@ -32,14 +33,21 @@
  */
 class BulkOpArena {
 private:
+    // Chunks are reported to tracemalloc under the arena domain
+    struct ChunkDeleter {
+        void operator()(uint8_t* p) const noexcept {
+            pmalloc::deallocate(p, pmalloc::DOMAIN_ARENA);
+        }
+    };
+
     // Memory chunk for bump-pointer allocation
     struct Chunk {
-        std::unique_ptr<uint8_t[]> memory;
+        std::unique_ptr<uint8_t[], ChunkDeleter> memory;
         size_t size;
         size_t used;
 
         Chunk(size_t chunk_size)
-            : memory(new uint8_t[chunk_size])
+            : memory(static_cast<uint8_t*>(pmalloc::allocate(chunk_size, pmalloc::DOMAIN_ARENA)))
             , size(chunk_size)
             , used(0) {}
     };
@@ -6,12 +6,157 @@
 #include "persistent_set.hpp"
 #include "persistent_list.hpp"
 #include "persistent_sorted_dict.hpp"
+#include "persistent_multimap.hpp"
+#include "persistent_bag.hpp"
+#include "persistent_ordered_dict.hpp"
+#include "persistent_interval_map.hpp"
+#include "persistent_json.hpp"
+#include "persistent_freeze.hpp"
+#include "persistent_path.hpp"
+#include "persistent_history.hpp"
+#include "persistent_store.hpp"
+#include "persistent_indexed_dict.hpp"
+#include "type_slots.hpp"
 
 namespace py = pybind11;
 
+// get_in/assoc_in/update_in/dissoc_in, shared by every container a path can
+// descend through (see persistent_path.hpp)
+template <typename T>
+void addPathMethods(py::class_<T>& cls) {
+    cls.def("get_in", &ppath::getIn,
+            py::arg("path"), py::arg("default") = py::none(),
+            "Get the value at a nested path.\n\n"
+            "Levels may be any mix of PersistentDict, PersistentArrayMap,\n"
+            "PersistentSortedDict (keys) and PersistentList (int indices).\n\n"
+            "Args:\n"
+            "    path: Sequence of keys/indices, outermost first\n"
+            "    default: Value returned if any step is missing\n\n"
+            "Returns:\n"
+            "    The value at path, or default\n\n"
+            "Complexity: One lookup per level")
+
+       .def("assoc_in", &ppath::assocIn,
+            py::arg("path"), py::arg("val"),
+            "Set the value at a nested path, returning a new container.\n\n"
+            "Missing intermediate levels are created as empty PersistentDicts;\n"
+            "on a PersistentList, index == len appends. Only the spine along\n"
+            "path is copied.\n\n"
+            "Args:\n"
+            "    path: Non-empty sequence of keys/indices, outermost first\n"
+            "    val: The new value\n\n"
+            "Returns:\n"
+            "    A new container (self if the value is already there)\n\n"
+            "Complexity: One descent per level")
+
+       .def("update_in", &ppath::updateIn,
+            py::arg("path"), py::arg("fn"),
+            "Replace the value at a nested path with fn(value).\n\n"
+            "fn receives None if the leaf is missing; missing intermediate\n"
+            "levels are created as empty PersistentDicts.\n\n"
+            "Args:\n"
+            "    path: Non-empty sequence of keys/indices, outermost first\n"
+            "    fn: Function of the current value\n\n"
+            "Returns:\n"
+            "    A new container (self if fn returns the same object)\n\n"
+            "Complexity: One descent per level plus the cost of fn")
+
+       .def("dissoc_in", &ppath::dissocIn,
+            py::arg("path"),
+            "Remove the key at the end of a nested path.\n\n"
+            "Missing paths leave the container unchanged. Elements of a\n"
+            "PersistentList cannot be removed (TypeError).\n\n"
+            "Args:\n"
+            "    path: Non-empty sequence of keys/indices, outermost first\n\n"
+            "Returns:\n"
+            "    A new container (self if nothing was removed)\n\n"
+            "Complexity: One descent per level");
+}
+
+// Lookups for the exception-free subscript slots (see type_slots.hpp); each
+// returns a null object on a miss
+namespace {
+
+py::object findInDict(const PersistentDict& m, const py::object& key) {
+    return m.get(key, py::object());
+}
+
+py::object findInArrayMap(const PersistentArrayMap& m, const py::object& key) {
+    return m.get(key, py::object());
+}
+
+py::object findInSortedDict(const PersistentSortedDict& m, const py::object& key) {
+    return m.get(key, py::object());
+}
+
+py::object findInMultiMap(const PersistentMultiMap& m, const py::object& key) {
+    return m.getMap().get(key, py::object());
+}
+
+py::object findInOrderedDict(const PersistentOrderedDict& m, const py::object& key) {
+    return m.find(key);
+}
+
+py::object findInIndexedDict(const IndexedPersistentDict& m, const py::object& key) {
+    return m.get(key, py::object());
+}
+
+// Slices go to the range-query __getitem__
+PyObject* sortedDictSubscript(PyObject* self, PyObject* key) {
+    if (PySlice_Check(key)) {
+        return pslots::originalSubscript<PersistentSortedDict>()(self, key);
+    }
+    return pslots::mapSubscript<PersistentSortedDict, findInSortedDict>(self, key);
+}
+
+// Integer indices; slices and type errors go to the pybind11 __getitem__
+PyObject* listSubscript(PyObject* self, PyObject* key) {
+    if (!PyLong_Check(key)) {
+        return pslots::originalSubscript<PersistentList>()(self, key);
+    }
+    try {
+        const PersistentList& list = pslots::instance<PersistentList>(self);
+        Py_ssize_t size = static_cast<Py_ssize_t>(list.size());
+        Py_ssize_t idx = PyLong_AsSsize_t(key);
+        if (idx == -1 && PyErr_Occurred()) {
+            PyErr_Clear();  // Beyond Py_ssize_t: out of range either way
+            idx = size;
+        } else if (idx < 0) {
+            idx += size;
+        }
+        if (idx < 0 || idx >= size) {
+            PyErr_SetString(PyExc_IndexError, "PersistentList index out of range");
+            return nullptr;
+        }
+        return list.nth(static_cast<size_t>(idx)).release().ptr();
+    } catch (...) {
+        pslots::setErrorFromException();
+        return nullptr;
+    }
+}
+
+} // namespace
+
 PYBIND11_MODULE(pypersistent, m) {
     m.doc() = "High-performance persistent hash map (HAMT) implementation in C++";
 
+    // Compile-time node widths and optimized build modes (set by setup.py),
+    // so benchmark results can be told apart
+    py::dict buildConfig;
+    buildConfig["hamt_bits"] = HASH_BITS;
+    buildConfig["vector_bits"] = PYPERSISTENT_VECTOR_BITS;
+#ifdef PYPERSISTENT_LTO_BUILD
+    buildConfig["lto"] = true;
+#else
+    buildConfig["lto"] = false;
+#endif
+#ifdef PYPERSISTENT_PGO_BUILD
+    buildConfig["pgo"] = true;
+#else
+    buildConfig["pgo"] = false;
+#endif
+    m.attr("BUILD_CONFIG") = buildConfig;
+
     // Initialize the NOT_FOUND sentinels
     PersistentDict::NOT_FOUND = py::object();
     PersistentArrayMap::NOT_FOUND = py::object();
@@ -29,7 +174,7 @@ PYBIND11_MODULE(pypersistent, m) {
         .def("__iter__", [](ItemIterator &it) -> ItemIterator& { return it; })
         .def("__next__", &ItemIterator::next);
 
-    py::class_<PersistentDict>(m, "PersistentDict")
+    auto dict_class = py::class_<PersistentDict>(m, "PersistentDict")
         .def(py::init<>(),
              "Create an empty PersistentDict")
 
@@ -109,7 +254,7 @@ PYBIND11_MODULE(pypersistent, m) {
              [](const PersistentDict& m, py::object key) -> py::object {
                  py::object result = m.get(key, PersistentDict::NOT_FOUND);
                  if (result.is(PersistentDict::NOT_FOUND)) {
-                     throw py::key_error(py::str(key));
+                     pslots::throwKeyError(key);
                  }
                  return result;
              },
@@ -168,6 +313,95 @@ PYBIND11_MODULE(pypersistent, m) {
              "Returns:\n"
              "    List of all values in the map")
 
+        .def("to_dict", &PersistentDict::toDict,
+             "Convert to a plain Python dict.\n\n"
+             "The dict is presized and filled with the hashes already stored in\n"
+             "the trie, so no key's __hash__ is called.\n\n"
+             "Returns:\n"
+             "    Python dict containing all key-value pairs\n\n"
+             "Complexity: O(n), no rehashing or dict resizes")
+
+        // Shape-preserving bulk transforms
+        .def("map_values",
+             [](const PersistentDict& self, py::function fn) {
+                 return self.mapValues([&](const py::object& v) { return fn(v); });
+             },
+             py::arg("fn"),
+             "Return a map with every value replaced by fn(value).\n\n"
+             "Keys, hashes and the trie shape are kept, so nothing is rehashed.\n"
+             "Where fn returns the identical object, the entry is shared, and\n"
+             "subtrees with no changed value are reused as-is.\n\n"
+             "Args:\n"
+             "    fn: Function of one value\n\n"
+             "Returns:\n"
+             "    A new PersistentDict (self if no value changed)\n\n"
+             "Complexity: O(n) calls to fn, O(changed paths) allocations")
+
+        .def("filter",
+             [](const PersistentDict& self, py::function pred) {
+                 return self.filter([&](const py::object&, const py::object& v) {
+                     return pmutils::truthy(pred(v));
+                 });
+             },
+             py::arg("pred"),
+             "Return a map with only the entries whose value satisfies pred.\n\n"
+             "Prunes the existing trie: untouched subtrees are shared, and\n"
+             "subtrees reduced to one entry are compacted into their parent.\n\n"
+             "Args:\n"
+             "    pred: Function of one value, truthy to keep the entry\n\n"
+             "Returns:\n"
+             "    A new PersistentDict (self if nothing was removed)\n\n"
+             "Complexity: O(n) calls to pred, no rehashing")
+
+        .def("filter_items",
+             [](const PersistentDict& self, py::function pred) {
+                 return self.filter([&](const py::object& k, const py::object& v) {
+                     return pmutils::truthy(pred(k, v));
+                 });
+             },
+             py::arg("pred"),
+             "Like filter(), but pred receives (key, value).\n\n"
+             "Args:\n"
+             "    pred: Function of key and value, truthy to keep the entry\n\n"
+             "Returns:\n"
+             "    A new PersistentDict (self if nothing was removed)\n\n"
+             "Complexity: O(n) calls to pred, no rehashing")
+
+        .def("split", &PersistentDict::split,
+             py::arg("k"),
+             "Split into k disjoint maps of roughly equal size.\n\n"
+             "Parts are carved from the top levels of the hash trie and share\n"
+             "their subtrees with this map, so no entry is copied or rehashed.\n"
+             "Each part is an ordinary PersistentDict (it pickles on its own);\n"
+             "small maps may yield empty parts.\n\n"
+             "Args:\n"
+             "    k: Number of parts (at least 1)\n\n"
+             "Returns:\n"
+             "    List of k PersistentDicts whose union is this map\n\n"
+             "Raises:\n"
+             "    ValueError: If k is 0\n\n"
+             "Complexity: O(k log n) new nodes, plus a native O(n) walk to size\n"
+             "the top-level subtrees")
+
+        .def("partition_sizes", &PersistentDict::partitionSizes,
+             py::arg("k"),
+             "Sizes of the parts split(k) would return, without building them.\n\n"
+             "Args:\n"
+             "    k: Number of parts (at least 1)\n\n"
+             "Returns:\n"
+             "    List of k ints\n\n"
+             "Raises:\n"
+             "    ValueError: If k is 0\n\n"
+             "Complexity: O(n) native walk, no allocation per entry")
+
+        .def("trie_stats", &PersistentDict::trieStats,
+             "Describe the shape of the underlying hash trie.\n\n"
+             "Returns:\n"
+             "    Dict with 'entries', 'depth', 'bitmap_nodes', 'collision_nodes',\n"
+             "    'max_collision_bucket', 'avg_fanout' (slots per bitmap node) and\n"
+             "    per-level 'level_nodes' / 'level_entries' lists\n\n"
+             "Complexity: O(n)")
+
         .def("__eq__",
              [](const PersistentDict& self, py::object other) -> bool {
                  if (!py::isinstance<PersistentDict>(other)) {
@@ -226,6 +460,31 @@ PYBIND11_MODULE(pypersistent, m) {
                    "Returns:\n"
                    "    A new PersistentDict containing the keyword arguments")
 
+        .def_static("group_by", &PersistentDict::groupBy,
+                   py::arg("iterable"), py::arg("keyfn"),
+                   "Group items by keyfn(item) into PersistentLists.\n\n"
+                   "Groups accumulate in native buffers; each list and the map\n"
+                   "itself are bulk-built once at the end, so no intermediate\n"
+                   "versions are created.\n\n"
+                   "Example:\n"
+                   "    PersistentDict.group_by(words, len)  # {3: ['the', 'fox'], ...}\n\n"
+                   "Args:\n"
+                   "    iterable: Items to group\n"
+                   "    keyfn: Function of one item giving its group key\n\n"
+                   "Returns:\n"
+                   "    A new PersistentDict mapping key -> PersistentList of items in\n"
+                   "    iteration order\n\n"
+                   "Complexity: O(n) keyfn calls, one hash per item")
+
+        .def_static("frequencies", &PersistentDict::frequencies,
+                   py::arg("iterable"),
+                   "Count occurrences of each distinct item.\n\n"
+                   "Args:\n"
+                   "    iterable: Hashable items to count\n\n"
+                   "Returns:\n"
+                   "    A new PersistentDict mapping item -> count\n\n"
+                   "Complexity: O(n), one hash per item")
+
         // Pickle support
         .def(py::pickle(
             [](const PersistentDict &p) { // __getstate__
@@ -255,7 +514,7 @@ PYBIND11_MODULE(pypersistent, m) {
         .def("__next__", &ArrayMapItemIterator::next);
 
     // PersistentArrayMap
-    py::class_<PersistentArrayMap>(m, "PersistentArrayMap")
+    auto array_map_class = py::class_<PersistentArrayMap>(m, "PersistentArrayMap")
         .def(py::init<>(),
              "Create an empty PersistentArrayMap")
 
@@ -344,7 +603,7 @@ PYBIND11_MODULE(pypersistent, m) {
              [](const PersistentArrayMap& m, py::object key) -> py::object {
                  py::object result = m.get(key, PersistentArrayMap::NOT_FOUND);
                  if (result.is(PersistentArrayMap::NOT_FOUND)) {
-                     throw py::key_error(py::str(key));
+                     pslots::throwKeyError(key);
                  }
                  return result;
              },
@@ -396,6 +655,11 @@ PYBIND11_MODULE(pypersistent, m) {
              "Returns:\n"
              "    List of all values in the map")
 
+        .def("to_dict", &PersistentArrayMap::toDict,
+             "Convert to a plain Python dict (presized, insertion order).\n\n"
+             "Returns:\n"
+             "    Python dict containing all key-value pairs")
+
         .def("__eq__",
              [](const PersistentArrayMap& self, py::object other) -> bool {
                  if (!py::isinstance<PersistentArrayMap>(other)) {
@@ -606,6 +870,17 @@ PYBIND11_MODULE(pypersistent, m) {
              "Returns:\n"
              "    List of all elements in the set")
 
+        .def("to_list", &PersistentSet::list,
+             "Convert to a plain Python list (presized). Same as list().\n\n"
+             "Returns:\n"
+             "    List of all elements in the set")
+
+        .def("to_set", &PersistentSet::toSet,
+             "Convert to a plain Python set.\n\n"
+             "Returns:\n"
+             "    Python set containing all elements\n\n"
+             "Complexity: O(n)")
+
         // Set operators
         .def("__or__", &PersistentSet::union_,
              py::arg("other"),
@@ -735,8 +1010,55 @@ PYBIND11_MODULE(pypersistent, m) {
         .def("__iter__", [](VectorIterator &it) -> VectorIterator& { return it; })
         .def("__next__", &VectorIterator::next);
 
+    py::class_<ReverseVectorIterator>(m, "ReverseVectorIterator")
+        .def("__iter__", [](ReverseVectorIterator &it) -> ReverseVectorIterator& { return it; })
+        .def("__next__", &ReverseVectorIterator::next);
+
+    // PersistentList cursor; negative indices count from the end
+    auto cursorIndex = [](const ListCursor& c, Py_ssize_t idx) -> size_t {
+        if (idx < 0) idx += static_cast<Py_ssize_t>(c.size());
+        if (idx < 0) throw py::index_error("Index out of range");
+        return static_cast<size_t>(idx);
+    };
+    py::class_<ListCursor>(m, "ListCursor")
+        .def(py::init<const PersistentList&>(), py::arg("list"),
+             "Start a batch of in-place edits on a copy of list.")
+        .def("__getitem__",
+             [cursorIndex](const ListCursor& c, Py_ssize_t idx) { return c.get(cursorIndex(c, idx)); },
+             py::arg("index"))
+        .def("__setitem__",
+             [cursorIndex](ListCursor& c, Py_ssize_t idx, const py::object& val) {
+                 c.set(cursorIndex(c, idx), val);
+             },
+             py::arg("index"), py::arg("value"))
+        .def("set",
+             [cursorIndex](ListCursor& c, Py_ssize_t idx, const py::object& val) {
+                 c.set(cursorIndex(c, idx), val);
+             },
+             py::arg("index"), py::arg("value"),
+             "Set the element at index.\n\n"
+             "Raises:\n"
+             "    IndexError: If index is out of range\n\n"
+             "Complexity: O(1) within the last edited leaf; otherwise one\n"
+             "descent that copies only nodes this cursor has not copied yet")
+        .def("set_range",
+             [cursorIndex](ListCursor& c, Py_ssize_t start, const py::iterable& values) {
+                 c.setRange(cursorIndex(c, start), values);
+             },
+             py::arg("start"), py::arg("values"),
+             "Overwrite consecutive elements from start with values.\n\n"
+             "Raises:\n"
+             "    IndexError: If the values run past the end (earlier values\n"
+             "        stay written)")
+        .def("__len__", &ListCursor::size)
+        .def("commit", &ListCursor::commit,
+             "Return the edited PersistentList.\n\n"
+             "The cursor stays usable; later edits copy the nodes they touch\n"
+             "again, so the returned list never changes.\n\n"
+             "Complexity: O(1)");
+
     // PersistentList
-    py::class_<PersistentList>(m, "PersistentList")
+    auto list_class = py::class_<PersistentList>(m, "PersistentList")
         .def(py::init<>(),
              "Create an empty PersistentList")
 
@@ -817,10 +1139,7 @@ PYBIND11_MODULE(pypersistent, m) {
                      if (!slice.compute(v.size(), &start, &stop, &step, &slicelength)) {
                          throw py::error_already_set();
                      }
-                     if (step != 1) {
-                         throw std::invalid_argument("PersistentList slicing does not support step != 1");
-                     }
-                     return py::cast(v.slice(start, stop));
+                     return py::cast(v.strided(start, step, static_cast<size_t>(slicelength)));
                  }
 
                  // Handle integer index
@@ -840,11 +1159,46 @@ PYBIND11_MODULE(pypersistent, m) {
                                      std::string(py::str(py::type::of(key))));
              },
              py::arg("key"),
-             "Get item using bracket notation. Supports integers (negative allowed) and slices.\n\n"
+             "Get item using bracket notation. Supports integers (negative allowed) and slices,\n"
+             "including strided and reversed slices.\n\n"
              "Examples:\n"
              "    v[0]      # First element\n"
              "    v[-1]     # Last element\n"
-             "    v[1:4]    # Slice from index 1 to 3")
+             "    v[1:4]    # Slice from index 1 to 3\n"
+             "    v[::10]   # Every 10th element\n"
+             "    v[::-1]   # Reversed")
+
+        .def("__reversed__", &PersistentList::reversed,
+             "Iterate from the last element to the first.")
+
+        .def("take", &PersistentList::take,
+             py::arg("indices"),
+             "Gather the elements at the given indices into a new list.\n\n"
+             "Indices may repeat, appear in any order and be negative.\n"
+             "Nearby indices share leaf lookups, and the result is built\n"
+             "leaf by leaf.\n\n"
+             "Args:\n"
+             "    indices: Iterable of ints\n\n"
+             "Returns:\n"
+             "    A new PersistentList with one element per index\n\n"
+             "Raises:\n"
+             "    IndexError: If an index is out of range\n"
+             "    TypeError: If an index is not an int\n\n"
+             "Complexity: O(k log n) for k indices, less when they are clustered")
+
+        .def("cursor",
+             [](const PersistentList& v) { return std::make_unique<ListCursor>(v); },
+             "Start a batch of localized edits.\n\n"
+             "Each node on an edited path is copied once per cursor, not once\n"
+             "per edit, so patching a window of elements allocates a handful\n"
+             "of nodes instead of a root-to-leaf path per element.\n\n"
+             "Returns:\n"
+             "    A ListCursor; call commit() to get the edited list\n\n"
+             "Example:\n"
+             "    c = v.cursor()\n"
+             "    for i in range(1000, 1100):\n"
+             "        c[i] = c[i].upper()\n"
+             "    v2 = c.commit()")
 
         .def("__len__", &PersistentList::size,
              "Return number of elements in the vector.")
@@ -873,6 +1227,13 @@ PYBIND11_MODULE(pypersistent, m) {
              "Returns:\n"
              "    Python list containing all elements")
 
+        .def("to_list", &PersistentList::list,
+             "Convert to a plain Python list. Same as list().\n\n"
+             "The list is presized and filled leaf by leaf.\n\n"
+             "Returns:\n"
+             "    Python list containing all elements\n\n"
+             "Complexity: O(n)")
+
         .def("slice", &PersistentList::slice,
              py::arg("start"), py::arg("stop"),
              "Return slice of vector.\n\n"
@@ -882,6 +1243,48 @@ PYBIND11_MODULE(pypersistent, m) {
              "Returns:\n"
              "    A new PersistentList containing the slice")
 
+        .def("sorted", &PersistentList::sorted,
+             py::arg("key") = py::none(), py::arg("reverse") = false,
+             "Return a new list with the elements in ascending order.\n\n"
+             "Stable, like the built-in sorted(): key is called once per element,\n"
+             "and reverse=True keeps equal elements in their original order.\n"
+             "Keys that are all int, all float or all str are compared without\n"
+             "calling __lt__; other keys use <.\n\n"
+             "Args:\n"
+             "    key: Optional function of one element giving its sort key\n"
+             "    reverse: Sort in descending order\n\n"
+             "Returns:\n"
+             "    A new sorted PersistentList\n\n"
+             "Raises:\n"
+             "    TypeError: If keys cannot be compared with <\n\n"
+             "Complexity: O(n log n) comparisons, result built leaf by leaf")
+
+        .def("split", &PersistentList::split,
+             py::arg("k"),
+             "Split into k contiguous lists of roughly equal length.\n\n"
+             "Boundaries fall on trie subtree edges so the parts share whole\n"
+             "subtrees with this list; only one leaf per part is copied (into\n"
+             "its tail). Each part is an ordinary PersistentList (it pickles\n"
+             "on its own); lists shorter than 32 * k may yield empty parts.\n\n"
+             "Args:\n"
+             "    k: Number of parts (at least 1)\n\n"
+             "Returns:\n"
+             "    List of k PersistentLists that concatenate to this list\n\n"
+             "Raises:\n"
+             "    ValueError: If k is 0\n\n"
+             "Complexity: O(k log n)")
+
+        .def("partition_sizes", &PersistentList::partitionSizes,
+             py::arg("k"),
+             "Lengths of the parts split(k) would return, without building them.\n\n"
+             "Args:\n"
+             "    k: Number of parts (at least 1)\n\n"
+             "Returns:\n"
+             "    List of k ints\n\n"
+             "Raises:\n"
+             "    ValueError: If k is 0\n\n"
+             "Complexity: O(k)")
+
         .def("__eq__",
              [](const PersistentList& self, py::object other) -> bool {
                  if (!py::isinstance<PersistentList>(other)) {
@@ -952,8 +1355,51 @@ PYBIND11_MODULE(pypersistent, m) {
         .def("__iter__", &TreeMapIteratorWrapper::iter)
         .def("__next__", &TreeMapIteratorWrapper::next);
 
+    // PersistentSortedDict range view
+    py::class_<SortedRangeIterator>(m, "SortedRangeIterator")
+        .def("__iter__", &SortedRangeIterator::iter)
+        .def("__next__", &SortedRangeIterator::next);
+
+    py::class_<SortedDictRange>(m, "SortedDictRange")
+        .def("__len__", &SortedDictRange::size,
+             "Number of entries in range, from two rank descents.\n\n"
+             "Complexity: O(log n)")
+        .def("__iter__",
+             [](const SortedDictRange& r) { return r.iter(SortedRangeIterator::KEYS); },
+             "Iterate over keys in range, in ascending order.")
+        .def("keys",
+             [](const SortedDictRange& r) { return r.iter(SortedRangeIterator::KEYS); },
+             "Iterate over keys in range, in ascending order.")
+        .def("values",
+             [](const SortedDictRange& r) { return r.iter(SortedRangeIterator::VALUES); },
+             "Iterate over values in range, ordered by their keys.")
+        .def("items",
+             [](const SortedDictRange& r) { return r.iter(SortedRangeIterator::ITEMS); },
+             "Iterate over [key, value] pairs in range, in ascending key order.")
+        .def("__contains__", &SortedDictRange::contains, py::arg("key"),
+             "Check if key is in the map and within the bounds.")
+        .def("first", &SortedDictRange::first,
+             "Get the entry with the smallest key in range.\n\n"
+             "Returns:\n"
+             "    [key, value]\n\n"
+             "Raises:\n"
+             "    RuntimeError: If the range is empty\n\n"
+             "Complexity: O(log n)")
+        .def("last", &SortedDictRange::last,
+             "Get the entry with the largest key in range.\n\n"
+             "Returns:\n"
+             "    [key, value]\n\n"
+             "Raises:\n"
+             "    RuntimeError: If the range is empty\n\n"
+             "Complexity: O(log n)")
+        .def("to_sorted_dict", &SortedDictRange::toSortedDict,
+             "Materialize the range as a PersistentSortedDict.\n\n"
+             "Builds a balanced tree directly from the in-order entries.\n\n"
+             "Complexity: O(log n + k) for k entries in range")
+        .def("__repr__", &SortedDictRange::repr);
+
     // PersistentSortedDict
-    py::class_<PersistentSortedDict>(m, "PersistentSortedDict")
+    auto sorted_dict_class = py::class_<PersistentSortedDict>(m, "PersistentSortedDict")
         .def(py::init<>(),
              "Create an empty PersistentSortedDict (sorted map)")
 
@@ -1057,12 +1503,10 @@ PYBIND11_MODULE(pypersistent, m) {
         // Python protocols
         .def("__getitem__",
              [](const PersistentSortedDict& m, py::object key) -> py::object {
-                 // Handle slice for range queries
+                 // Handle slice for range queries: a lazy [start, stop) view,
+                 // open at either end when start or stop is omitted
                  if (py::isinstance<py::slice>(key)) {
                      py::slice slice = key.cast<py::slice>();
-                     // Extract start and stop from slice (step not supported)
-                     py::object start_obj = slice.attr("start");
-                     py::object stop_obj = slice.attr("stop");
                      py::object step_obj = slice.attr("step");
 
                      // Check that step is None or 1
@@ -1070,13 +1514,7 @@ PYBIND11_MODULE(pypersistent, m) {
                          throw std::invalid_argument("PersistentSortedDict slicing does not support step != 1");
                      }
 
-                     // Both start and stop must be provided for range queries
-                     if (start_obj.is_none() || stop_obj.is_none()) {
-                         throw std::invalid_argument("PersistentSortedDict slicing requires both start and stop keys");
-                     }
-
-                     // Call subseq with the start and stop keys
-                     return py::cast(m.subseq(start_obj, stop_obj));
+                     return py::cast(m.range(slice.attr("start"), slice.attr("stop")));
                  }
 
                  // Handle regular key lookup
@@ -1087,10 +1525,31 @@ PYBIND11_MODULE(pypersistent, m) {
              "Args:\n"
              "    key: The key to look up, or a slice for range queries\n\n"
              "Returns:\n"
-             "    The value associated with key, or a PersistentSortedDict for slices\n\n"
+             "    The value associated with key, or a SortedDictRange view for\n"
+             "    slices (m[a:b], m[a:], m[:b])\n\n"
              "Raises:\n"
              "    KeyError: If key not found")
 
+        .def("range",
+             [](const PersistentSortedDict& m, py::object start, py::object stop,
+                std::pair<bool, bool> inclusive) {
+                 return m.range(start, stop, inclusive.first, inclusive.second);
+             },
+             py::arg("start") = py::none(), py::arg("stop") = py::none(),
+             py::arg("inclusive") = std::make_pair(true, false),
+             "Lazy view of the entries between two keys.\n\n"
+             "The view reads the original tree: nothing is copied until\n"
+             "to_sorted_dict() is called.\n\n"
+             "Args:\n"
+             "    start: Lower bound, or None for no lower bound\n"
+             "    stop: Upper bound, or None for no upper bound\n"
+             "    inclusive: (start_inclusive, stop_inclusive), default (True, False)\n\n"
+             "Returns:\n"
+             "    A SortedDictRange view\n\n"
+             "Example:\n"
+             "    m.range(10, 20, inclusive=(False, True))  # 10 < key <= 20\n\n"
+             "Complexity: O(log n) to create")
+
         .def("__contains__", &PersistentSortedDict::pyContains,
              py::arg("key"),
              "Check if key is in map.\n\n"
@@ -1128,6 +1587,12 @@ PYBIND11_MODULE(pypersistent, m) {
              "Returns:\n"
              "    Python dict containing all key-value pairs")
 
+        .def("to_dict", &PersistentSortedDict::dict,
+             "Convert to a plain Python dict in key order. Same as dict().\n\n"
+             "The dict is presized and filled by an in-order walk of the tree.\n\n"
+             "Returns:\n"
+             "    Python dict containing all key-value pairs")
+
         .def("__eq__",
              [](const PersistentSortedDict& self, py::object other) -> bool {
                  if (!py::isinstance<PersistentSortedDict>(other)) {
@@ -1430,6 +1895,993 @@ PYBIND11_MODULE(pypersistent, m) {
             }
         ));
 
+    // PersistentMultiMap
+    py::class_<PersistentMultiMap>(m, "PersistentMultiMap")
+        .def(py::init<>(),
+             "Create an empty PersistentMultiMap (key -> set of values)")
+
+        // Core methods
+        .def("add", &PersistentMultiMap::add,
+             py::arg("key"), py::arg("value"),
+             "Add value to the set stored under key, returning new multimap.\n\n"
+             "Args:\n"
+             "    key: The key\n"
+             "    value: The value to add\n\n"
+             "Returns:\n"
+             "    A new PersistentMultiMap with the pair added\n\n"
+             "Complexity: O(log32 n), single descent of the outer map")
+
+        .def("remove", &PersistentMultiMap::remove,
+             py::arg("key"), py::arg("value"),
+             "Remove value from the set stored under key, returning new multimap.\n\n"
+             "The key is dropped when its last value is removed.\n\n"
+             "Args:\n"
+             "    key: The key\n"
+             "    value: The value to remove\n\n"
+             "Returns:\n"
+             "    A new PersistentMultiMap with the pair removed")
+
+        .def("remove_all", &PersistentMultiMap::removeAll,
+             py::arg("key"),
+             "Remove key and all of its values, returning new multimap.\n\n"
+             "Args:\n"
+             "    key: The key to remove\n\n"
+             "Returns:\n"
+             "    A new PersistentMultiMap without the key")
+
+        .def("get", &PersistentMultiMap::get,
+             py::arg("key"),
+             "Get the set of values for key.\n\n"
+             "Args:\n"
+             "    key: The key to look up\n\n"
+             "Returns:\n"
+             "    PersistentSet of values (empty if key is absent)")
+
+        .def("contains", &PersistentMultiMap::contains,
+             py::arg("key"), py::arg("value"),
+             "Check if the (key, value) pair is present.\n\n"
+             "Args:\n"
+             "    key: The key\n"
+             "    value: The value\n\n"
+             "Returns:\n"
+             "    True if value is stored under key, False otherwise")
+
+        .def("count", &PersistentMultiMap::count,
+             py::arg("key"),
+             "Return number of values stored under key.")
+
+        .def("key_count", &PersistentMultiMap::keyCount,
+             "Return number of distinct keys.")
+
+        .def("merge", &PersistentMultiMap::merge,
+             py::arg("other"),
+             "Merge with another multimap, taking the union of values per key.\n\n"
+             "Args:\n"
+             "    other: Another PersistentMultiMap\n\n"
+             "Returns:\n"
+             "    A new PersistentMultiMap containing the pairs of both\n\n"
+             "Complexity: O(n + m) structural merge for large inputs")
+
+        .def("__or__", &PersistentMultiMap::merge,
+             py::arg("other"),
+             "Merge using | operator (alias for merge).")
+
+        // Python protocols
+        .def("__getitem__", &PersistentMultiMap::pyGetItem,
+             py::arg("key"),
+             "Get the set of values for key. Raises KeyError if not found.")
+
+        .def("__contains__", &PersistentMultiMap::containsKey,
+             py::arg("key"),
+             "Check if key is in the multimap.")
+
+        .def("__len__", &PersistentMultiMap::size,
+             "Return total number of (key, value) pairs.")
+
+        .def("__iter__", &PersistentMultiMap::keys,
+             "Iterate over distinct keys.")
+
+        .def("keys", &PersistentMultiMap::keys,
+             "Return iterator over distinct keys.")
+
+        .def("keys_list", &PersistentMultiMap::keysList,
+             "Return list of distinct keys.")
+
+        .def("items_list", &PersistentMultiMap::itemsList,
+             "Return list of (key, PersistentSet) tuples.")
+
+        .def("pairs_list", &PersistentMultiMap::pairsList,
+             "Return flattened list of (key, value) tuples.")
+
+        .def("to_dict", &PersistentMultiMap::toDict,
+             "Convert to a plain dict of key -> set of values.")
+
+        .def("__eq__",
+             [](const PersistentMultiMap& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentMultiMap>(other)) {
+                     return false;
+                 }
+                 return self == other.cast<const PersistentMultiMap&>();
+             },
+             py::arg("other"),
+             "Check equality with another multimap.")
+
+        .def("__ne__",
+             [](const PersistentMultiMap& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentMultiMap>(other)) {
+                     return true;
+                 }
+                 return self != other.cast<const PersistentMultiMap&>();
+             },
+             py::arg("other"),
+             "Check inequality with another multimap.")
+
+        .def("__repr__", &PersistentMultiMap::repr,
+             "String representation of the multimap.")
+
+        // Factory methods
+        .def_static("from_pairs", &PersistentMultiMap::fromPairs,
+                   py::arg("pairs"),
+                   "Create PersistentMultiMap from an iterable of (key, value) pairs.\n\n"
+                   "Pairs are grouped in C++ and the trees are built in one bulk pass.\n\n"
+                   "Args:\n"
+                   "    pairs: Iterable of (key, value) pairs\n\n"
+                   "Returns:\n"
+                   "    A new PersistentMultiMap")
+
+        .def_static("from_dict", &PersistentMultiMap::fromDict,
+                   py::arg("dict"),
+                   "Create PersistentMultiMap from a dict of key -> iterable of values.\n\n"
+                   "Args:\n"
+                   "    dict: A Python dict whose values are iterables\n\n"
+                   "Returns:\n"
+                   "    A new PersistentMultiMap")
+
+        // Pickle support
+        .def(py::pickle(
+            [](const PersistentMultiMap &p) { // __getstate__
+                return p.pairsList();
+            },
+            [](py::list pairs) { // __setstate__
+                return PersistentMultiMap::fromPairs(pairs);
+            }
+        ));
+
+    // PersistentBag
+    py::class_<PersistentBag>(m, "PersistentBag")
+        .def(py::init<>(),
+             "Create an empty PersistentBag (multiset / counter)")
+
+        // Core methods
+        .def("add", &PersistentBag::add,
+             py::arg("elem"),
+             "Add one occurrence of elem, returning new bag.\n\n"
+             "Args:\n"
+             "    elem: The element to add\n\n"
+             "Returns:\n"
+             "    A new PersistentBag with the count of elem incremented\n\n"
+             "Complexity: O(log32 n), single descent")
+
+        .def("increment", &PersistentBag::increment,
+             py::arg("elem"), py::arg("n") = 1,
+             "Add n occurrences of elem, returning new bag.\n\n"
+             "Args:\n"
+             "    elem: The element to add\n"
+             "    n: Number of occurrences (default: 1)\n\n"
+             "Returns:\n"
+             "    A new PersistentBag with the count of elem increased by n")
+
+        .def("remove", &PersistentBag::remove,
+             py::arg("elem"), py::arg("n") = 1,
+             "Remove up to n occurrences of elem, returning new bag.\n\n"
+             "The element is dropped when its count reaches zero.\n\n"
+             "Args:\n"
+             "    elem: The element to remove\n"
+             "    n: Number of occurrences (default: 1)\n\n"
+             "Returns:\n"
+             "    A new PersistentBag with the count of elem decreased")
+
+        .def("remove_all", &PersistentBag::removeAll,
+             py::arg("elem"),
+             "Remove every occurrence of elem, returning new bag.")
+
+        .def("count", &PersistentBag::count,
+             py::arg("elem"),
+             "Return the count of elem (0 if absent).")
+
+        .def("distinct_count", &PersistentBag::distinctCount,
+             "Return number of distinct elements.")
+
+        .def("merge", &PersistentBag::merge,
+             py::arg("other"),
+             "Merge with another bag, summing counts.\n\n"
+             "Args:\n"
+             "    other: Another PersistentBag\n\n"
+             "Returns:\n"
+             "    A new PersistentBag with counts of both added together\n\n"
+             "Complexity: O(n + m) structural merge for large inputs")
+
+        .def("__add__", &PersistentBag::merge,
+             py::arg("other"),
+             "Sum counts using + operator (alias for merge).")
+
+        .def("most_common", &PersistentBag::mostCommon,
+             py::arg("n") = py::none(),
+             "Return list of (elem, count) tuples, most common first.\n\n"
+             "Args:\n"
+             "    n: Maximum number of elements to return (default: all)\n\n"
+             "Returns:\n"
+             "    List of (elem, count) tuples ordered by descending count")
+
+        .def("elements", &PersistentBag::elements,
+             "Return list of elements, each repeated by its count.")
+
+        .def("items_list", &PersistentBag::itemsList,
+             "Return list of (elem, count) tuples.")
+
+        .def("dict", &PersistentBag::dict,
+             "Convert to Python dict of elem -> count.")
+
+        .def("to_dict", &PersistentBag::dict,
+             "Convert to Python dict of elem -> count. Same as dict().")
+
+        // Python protocols
+        .def("__getitem__", &PersistentBag::count,
+             py::arg("elem"),
+             "Return the count of elem (0 if absent), like collections.Counter.")
+
+        .def("__contains__", &PersistentBag::contains,
+             py::arg("elem"),
+             "Check if elem occurs at least once.")
+
+        .def("__len__", &PersistentBag::size,
+             "Return total number of occurrences.")
+
+        .def("__iter__", &PersistentBag::iter,
+             "Iterate over distinct elements.")
+
+        .def("__eq__",
+             [](const PersistentBag& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentBag>(other)) {
+                     return false;
+                 }
+                 return self == other.cast<const PersistentBag&>();
+             },
+             py::arg("other"),
+             "Check equality with another bag.")
+
+        .def("__ne__",
+             [](const PersistentBag& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentBag>(other)) {
+                     return true;
+                 }
+                 return self != other.cast<const PersistentBag&>();
+             },
+             py::arg("other"),
+             "Check inequality with another bag.")
+
+        .def("__repr__", &PersistentBag::repr,
+             "String representation of the bag.")
+
+        // Factory methods
+        .def_static("from_iterable", &PersistentBag::fromIterable,
+                   py::arg("iterable"),
+                   "Create PersistentBag by counting the elements of an iterable.\n\n"
+                   "Counts are accumulated in C++ and the tree is built in one bulk pass.\n\n"
+                   "Args:\n"
+                   "    iterable: Any Python iterable\n\n"
+                   "Returns:\n"
+                   "    A new PersistentBag")
+
+        .def_static("from_counts", &PersistentBag::fromCounts,
+                   py::arg("counts"),
+                   "Create PersistentBag from a dict of elem -> count.\n\n"
+                   "Args:\n"
+                   "    counts: A Python dict with non-negative integer counts\n\n"
+                   "Returns:\n"
+                   "    A new PersistentBag (zero counts are dropped)")
+
+        // Pickle support
+        .def(py::pickle(
+            [](const PersistentBag &p) { // __getstate__
+                return p.dict();
+            },
+            [](py::dict counts) { // __setstate__
+                return PersistentBag::fromCounts(counts);
+            }
+        ));
+
+    // PersistentOrderedDict iterator
+    py::class_<OrderedDictIterator>(m, "OrderedDictIterator")
+        .def("__iter__", [](OrderedDictIterator &it) -> OrderedDictIterator& { return it; })
+        .def("__next__", &OrderedDictIterator::next);
+
+    // PersistentOrderedDict
+    py::class_<PersistentOrderedDict>(m, "PersistentOrderedDict")
+        .def(py::init<>(),
+             "Create an empty PersistentOrderedDict (insertion-ordered map)")
+
+        // Core methods
+        .def("assoc", &PersistentOrderedDict::assoc,
+             py::arg("key"), py::arg("val"),
+             "Associate key with value, returning new map.\n\n"
+             "New keys go to the end; existing keys keep their position.\n\n"
+             "Args:\n"
+             "    key: The key\n"
+             "    val: The value\n\n"
+             "Returns:\n"
+             "    A new PersistentOrderedDict with the association added\n\n"
+             "Complexity: O(log32 n)")
+
+        .def("dissoc", &PersistentOrderedDict::dissoc,
+             py::arg("key"),
+             "Remove key, returning new map.\n\n"
+             "Args:\n"
+             "    key: The key to remove\n\n"
+             "Returns:\n"
+             "    A new PersistentOrderedDict with the key removed\n\n"
+             "Complexity: O(log32 n) amortised (periodic compaction)")
+
+        .def("get", &PersistentOrderedDict::get,
+             py::arg("key"), py::arg("default") = py::none(),
+             "Get value for key, or default if not found.\n\n"
+             "Args:\n"
+             "    key: The key to look up\n"
+             "    default: Value to return if key not found (default: None)\n\n"
+             "Returns:\n"
+             "    The value associated with key, or default\n\n"
+             "Complexity: O(log32 n)")
+
+        .def("first", &PersistentOrderedDict::first,
+             "Get (key, value) of the oldest entry.\n\n"
+             "Raises:\n"
+             "    RuntimeError: If map is empty")
+
+        .def("last", &PersistentOrderedDict::last,
+             "Get (key, value) of the newest entry.\n\n"
+             "Raises:\n"
+             "    RuntimeError: If map is empty")
+
+        // Python-friendly aliases
+        .def("set", &PersistentOrderedDict::set,
+             py::arg("key"), py::arg("val"),
+             "Pythonic alias for assoc(). Set key to value.")
+
+        .def("delete", &PersistentOrderedDict::delete_,
+             py::arg("key"),
+             "Pythonic alias for dissoc(). Delete key.")
+
+        .def("update", &PersistentOrderedDict::update,
+             py::arg("other"),
+             "Update with entries from another mapping, returning new map.\n\n"
+             "Args:\n"
+             "    other: A dict, PersistentOrderedDict, or any mapping\n\n"
+             "Returns:\n"
+             "    A new PersistentOrderedDict (right side wins, new keys appended in order)")
+
+        .def("__or__", &PersistentOrderedDict::update,
+             py::arg("other"),
+             "Merge using | operator (alias for update).")
+
+        // Python protocols
+        .def("__getitem__", &PersistentOrderedDict::pyGetItem,
+             py::arg("key"),
+             "Get item using bracket notation. Raises KeyError if not found.")
+
+        .def("__contains__", &PersistentOrderedDict::contains,
+             py::arg("key"),
+             "Check if key is in map.")
+
+        .def("__len__", &PersistentOrderedDict::size,
+             "Return number of entries in the map.")
+
+        .def("__iter__", &PersistentOrderedDict::keys,
+             "Iterate over keys in insertion order.")
+
+        .def("keys", &PersistentOrderedDict::keys,
+             "Return iterator over keys in insertion order.")
+
+        .def("values", &PersistentOrderedDict::values,
+             "Return iterator over values in insertion order.")
+
+        .def("items", &PersistentOrderedDict::items,
+             "Return iterator over (key, value) tuples in insertion order.")
+
+        .def("keys_list", &PersistentOrderedDict::keysList,
+             "Return list of all keys in insertion order.")
+
+        .def("values_list", &PersistentOrderedDict::valuesList,
+             "Return list of all values in insertion order.")
+
+        .def("items_list", &PersistentOrderedDict::itemsList,
+             "Return list of (key, value) tuples in insertion order.")
+
+        .def("to_dict", &PersistentOrderedDict::toDict,
+             "Convert to a plain Python dict in insertion order (presized).")
+
+        .def("__eq__",
+             [](const PersistentOrderedDict& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentOrderedDict>(other)) {
+                     return false;
+                 }
+                 return self == other.cast<const PersistentOrderedDict&>();
+             },
+             py::arg("other"),
+             "Check equality with another ordered map (order-sensitive).")
+
+        .def("__ne__",
+             [](const PersistentOrderedDict& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentOrderedDict>(other)) {
+                     return true;
+                 }
+                 return self != other.cast<const PersistentOrderedDict&>();
+             },
+             py::arg("other"),
+             "Check inequality with another ordered map.")
+
+        .def("__repr__", &PersistentOrderedDict::repr,
+             "String representation of the map.")
+
+        // Factory methods
+        .def_static("from_dict", &PersistentOrderedDict::fromDict,
+                   py::arg("dict"),
+                   "Create PersistentOrderedDict from a dict, keeping its order.\n\n"
+                   "Args:\n"
+                   "    dict: A Python dictionary\n\n"
+                   "Returns:\n"
+                   "    A new PersistentOrderedDict")
+
+        .def_static("from_items", &PersistentOrderedDict::fromItems,
+                   py::arg("items"),
+                   "Create PersistentOrderedDict from (key, value) pairs.\n\n"
+                   "Duplicate keys keep their first position and last value.\n\n"
+                   "Args:\n"
+                   "    items: Iterable of (key, value) pairs\n\n"
+                   "Returns:\n"
+                   "    A new PersistentOrderedDict")
+
+        .def_static("create", &PersistentOrderedDict::create,
+                   "Create PersistentOrderedDict from keyword arguments.\n\n"
+                   "Example:\n"
+                   "    m = PersistentOrderedDict.create(a=1, b=2, c=3)\n\n"
+                   "Returns:\n"
+                   "    A new PersistentOrderedDict containing the keyword arguments")
+
+        // Pickle support
+        .def(py::pickle(
+            [](const PersistentOrderedDict &p) { // __getstate__
+                return p.itemsList();
+            },
+            [](py::list items) { // __setstate__
+                return PersistentOrderedDict::fromItems(items);
+            }
+        ));
+
+    // PersistentIntervalMap
+    py::class_<PersistentIntervalMap>(m, "PersistentIntervalMap")
+        .def(py::init<>(),
+             "Create an empty PersistentIntervalMap (closed intervals [lo, hi] -> value)")
+
+        // Core methods
+        .def("assoc", &PersistentIntervalMap::assoc,
+             py::arg("lo"), py::arg("hi"), py::arg("val"),
+             "Associate the closed interval [lo, hi] with a value, returning new map.\n\n"
+             "Args:\n"
+             "    lo: Lower bound (inclusive)\n"
+             "    hi: Upper bound (inclusive)\n"
+             "    val: The value\n\n"
+             "Returns:\n"
+             "    A new PersistentIntervalMap with the interval added\n\n"
+             "Raises:\n"
+             "    ValueError: If lo > hi\n\n"
+             "Complexity: O(log n)")
+
+        .def("dissoc", &PersistentIntervalMap::dissoc,
+             py::arg("lo"), py::arg("hi"),
+             "Remove the interval [lo, hi], returning new map.\n\n"
+             "Complexity: O(log n)")
+
+        .def("get", &PersistentIntervalMap::get,
+             py::arg("lo"), py::arg("hi"), py::arg("default") = py::none(),
+             "Get value stored for exactly [lo, hi], or default if not found.")
+
+        .def("contains", &PersistentIntervalMap::contains,
+             py::arg("lo"), py::arg("hi"),
+             "Check if exactly [lo, hi] is stored.")
+
+        // Queries
+        .def("stabbing", &PersistentIntervalMap::stabbing,
+             py::arg("point"),
+             "Find all intervals containing point (lo <= point <= hi).\n\n"
+             "Args:\n"
+             "    point: The point to look up\n\n"
+             "Returns:\n"
+             "    List of (lo, hi, value) tuples in interval order\n\n"
+             "Complexity: O(log n + k) where k is the number of matches")
+
+        .def("stabbing_values", &PersistentIntervalMap::stabbingValues,
+             py::arg("point"),
+             "Like stabbing(), but return only the values.\n\n"
+             "Complexity: O(log n + k) where k is the number of matches")
+
+        .def("overlapping", &PersistentIntervalMap::overlapping,
+             py::arg("lo"), py::arg("hi"),
+             "Find all intervals overlapping [lo, hi].\n\n"
+             "Args:\n"
+             "    lo: Query lower bound (inclusive)\n"
+             "    hi: Query upper bound (inclusive)\n\n"
+             "Returns:\n"
+             "    List of (lo, hi, value) tuples in interval order\n\n"
+             "Complexity: O(log n + k) where k is the number of matches")
+
+        // Python protocols
+        .def("__len__", &PersistentIntervalMap::size,
+             "Return number of intervals in the map.")
+
+        .def("__iter__",
+             [](const PersistentIntervalMap& m) -> py::iterator {
+                 return py::iter(m.itemsList());
+             },
+             "Iterate over (lo, hi, value) tuples in interval order.")
+
+        .def("items_list", &PersistentIntervalMap::itemsList,
+             "Return list of (lo, hi, value) tuples in interval order.")
+
+        .def("__eq__",
+             [](const PersistentIntervalMap& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentIntervalMap>(other)) {
+                     return false;
+                 }
+                 return self == other.cast<const PersistentIntervalMap&>();
+             },
+             py::arg("other"),
+             "Check equality with another interval map.")
+
+        .def("__ne__",
+             [](const PersistentIntervalMap& self, py::object other) -> bool {
+                 if (!py::isinstance<PersistentIntervalMap>(other)) {
+                     return true;
+                 }
+                 return self != other.cast<const PersistentIntervalMap&>();
+             },
+             py::arg("other"),
+             "Check inequality with another interval map.")
+
+        .def("__repr__", &PersistentIntervalMap::repr,
+             "String representation of the interval map.")
+
+        // Factory methods
+        .def_static("from_items", &PersistentIntervalMap::fromItems,
+                   py::arg("items"),
+                   "Create PersistentIntervalMap from (lo, hi, value) triples.\n\n"
+                   "Items are sorted once and the tree is built bottom-up.\n"
+                   "Duplicate intervals keep the last value.\n\n"
+                   "Args:\n"
+                   "    items: Iterable of (lo, hi, value) triples\n\n"
+                   "Returns:\n"
+                   "    A new PersistentIntervalMap")
+
+        // Pickle support
+        .def(py::pickle(
+            [](const PersistentIntervalMap &p) { // __getstate__
+                return p.itemsList();
+            },
+            [](py::list items) { // __setstate__
+                return PersistentIntervalMap::fromItems(items);
+            }
+        ));
+
+    // History (see persistent_history.hpp)
+    py::class_<History>(m, "History")
+        .def(py::init([](const py::object& initial, std::optional<size_t> max_versions,
+                         std::optional<size_t> max_bytes) {
+                 PersistentDict state = initial.is_none() ? PersistentDict()
+                                                          : initial.cast<PersistentDict>();
+                 return History(state, max_versions, max_bytes);
+             }),
+             py::arg("initial") = py::none(), py::arg("max_versions") = py::none(),
+             py::arg("max_bytes") = py::none(),
+             "Create a version history of PersistentDict states.\n\n"
+             "Args:\n"
+             "    initial: First version (default: empty PersistentDict)\n"
+             "    max_versions: Keep at most this many versions (None: unbounded)\n"
+             "    max_bytes: Keep the native bytes retained by all versions under\n"
+             "        this budget, dropping the oldest first (None: unbounded)\n\n"
+             "Raises:\n"
+             "    ValueError: If max_versions is 0")
+
+        .def("snapshot", &History::snapshot,
+             py::arg("state"),
+             "Record state as the new current version.\n\n"
+             "Only a reference to the root is kept; nodes shared with the\n"
+             "previous version are not copied. Applies the retention policy.\n\n"
+             "Args:\n"
+             "    state: The new PersistentDict version\n\n"
+             "Complexity: O(1) plus a walk over the nodes the edit changed")
+
+        .def("rollback", &History::rollback,
+             py::arg("n") = 1,
+             "Drop the n most recent versions and return the new current one.\n\n"
+             "Args:\n"
+             "    n: Number of versions to undo (default: 1)\n\n"
+             "Returns:\n"
+             "    The version that is now current\n\n"
+             "Raises:\n"
+             "    IndexError: If n would remove every version\n\n"
+             "Complexity: O(n)")
+
+        .def("compact", &History::compact,
+             py::arg("start") = 0, py::arg("stop") = -1,
+             "Drop the versions strictly between start and stop.\n\n"
+             "Squashes a run of edits into one step: the versions at start\n"
+             "and stop are kept.\n\n"
+             "Args:\n"
+             "    start: Index of the first kept version (default: oldest)\n"
+             "    stop: Index of the last kept version (default: current)\n\n"
+             "Raises:\n"
+             "    IndexError: If an index is out of range")
+
+        // Copy: the version lives in the history's deque, which rollback,
+        // compact and retention drop from
+        .def_property_readonly("current", &History::current, py::return_value_policy::copy,
+             "The most recent version.")
+
+        .def("__len__", &History::size,
+             "Number of retained versions.")
+
+        .def("__getitem__", &History::at,
+             py::arg("index"),
+             "Version at index (0 is the oldest, -1 the current).\n\n"
+             "Raises:\n"
+             "    IndexError: If index is out of range")
+
+        .def("versions", &History::versions,
+             "List of retained versions, oldest first.")
+
+        .def("retained_bytes", &History::retainedBytes,
+             "Native bytes (trie nodes and entries) retained by all versions.\n\n"
+             "Tracked incrementally from the nodes each version does not share\n"
+             "with its predecessor. Keys and values are not counted. Exact for\n"
+             "histories of successive edits, otherwise an upper bound.\n\n"
+             "Complexity: O(1)")
+
+        .def("unique_bytes", &History::uniqueBytes,
+             "Native bytes held by each version and by no other, oldest first.\n\n"
+             "This is what dropping that version alone would free.\n\n"
+             "Complexity: O(distinct nodes across all versions)")
+
+        .def("set_retention", &History::setRetention,
+             py::arg("max_versions") = py::none(), py::arg("max_bytes") = py::none(),
+             "Replace the retention policy and apply it immediately.\n\n"
+             "Args:\n"
+             "    max_versions: Keep at most this many versions (None: unbounded)\n"
+             "    max_bytes: Retained native bytes budget (None: unbounded)")
+
+        .def_property_readonly("max_versions", &History::maxVersions)
+        .def_property_readonly("max_bytes", &History::maxBytes)
+
+        .def("__repr__", &History::repr);
+
+    // Change feed (see persistent_store.hpp)
+    py::class_<ChangeSet>(m, "ChangeSet")
+        .def_readonly("before", &ChangeSet::before, "State before the changes.")
+        .def_readonly("after", &ChangeSet::after, "State after the changes.")
+        .def_readonly("added", &ChangeSet::added, "List of (key, value) tuples for new keys.")
+        .def_readonly("removed", &ChangeSet::removed, "List of (key, value) tuples for removed keys.")
+        .def_readonly("changed", &ChangeSet::changed,
+                      "List of (key, old_value, new_value) tuples for updated keys.")
+        .def("__len__", &ChangeSet::size, "Total number of changed entries.")
+        .def("__repr__", &ChangeSet::repr);
+
+    dict_class.def("diff",
+             [](const PersistentDict& self, const PersistentDict& other) {
+                 return ChangeSet::between(self, other);
+             },
+             py::arg("other"),
+             "Entries added, removed and changed going from this dict to other.\n\n"
+             "Walks both tries in parallel and skips subtrees they share, so\n"
+             "comparing a dict with an edited version of itself costs time\n"
+             "proportional to the edit.\n\n"
+             "Args:\n"
+             "    other: The newer PersistentDict\n\n"
+             "Returns:\n"
+             "    A ChangeSet with added, removed and changed entries\n\n"
+             "Complexity: O(changed nodes); O(n) for unrelated dicts");
+
+    py::class_<StoreBatch>(m, "StoreBatch")
+        .def("__enter__", [](StoreBatch& self) { self.enter(); })
+        .def("__exit__", [](StoreBatch& self, const py::args&) {
+            self.exit();
+            return false;
+        });
+
+    py::class_<Store>(m, "Store")
+        .def(py::init([](const py::object& initial) {
+                 return Store(initial.is_none() ? PersistentDict() : initial.cast<PersistentDict>());
+             }),
+             py::arg("initial") = py::none(),
+             "Create a mutable cell holding a PersistentDict, with a change feed.\n\n"
+             "Args:\n"
+             "    initial: Initial state (default: empty PersistentDict)")
+
+        // Copy: every update overwrites the store's state in place
+        .def_property_readonly("state", &Store::state, py::return_value_policy::copy,
+             "The current PersistentDict.")
+
+        .def("assoc", &Store::assoc,
+             py::arg("key"), py::arg("val"),
+             "Set key to val and publish the change.\n\n"
+             "Returns:\n"
+             "    The new state")
+
+        .def("dissoc", &Store::dissoc,
+             py::arg("key"),
+             "Remove key and publish the change.\n\n"
+             "Returns:\n"
+             "    The new state")
+
+        .def("update", &Store::update,
+             py::arg("other"),
+             "Merge a mapping into the state and publish one ChangeSet.\n\n"
+             "Returns:\n"
+             "    The new state")
+
+        .def("reset", &Store::reset,
+             py::arg("state"),
+             "Replace the whole state; subscribers receive the diff.\n\n"
+             "Returns:\n"
+             "    The new state")
+
+        .def("subscribe", &Store::subscribe,
+             py::arg("fn"),
+             "Call fn(changes) with a ChangeSet after every published update.\n\n"
+             "Args:\n"
+             "    fn: Callable taking a ChangeSet\n\n"
+             "Returns:\n"
+             "    Token for unsubscribe()\n\n"
+             "Raises:\n"
+             "    TypeError: If fn is not callable")
+
+        .def("unsubscribe", &Store::unsubscribe,
+             py::arg("token"),
+             "Remove a subscriber.\n\n"
+             "Returns:\n"
+             "    True if the token was subscribed")
+
+        .def("batch",
+             [](py::object self) { return StoreBatch(self); },
+             "Context manager that publishes one ChangeSet for all updates\n"
+             "made inside it, when the outermost batch exits.\n\n"
+             "Example:\n"
+             "    with store.batch():\n"
+             "        store.assoc('a', 1)\n"
+             "        store.dissoc('b')\n"
+             "    # subscribers are called once here")
+
+        .def_property_readonly("in_batch", &Store::inBatch)
+        .def_property_readonly("subscriber_count", &Store::subscriberCount)
+        .def("__repr__", &Store::repr);
+
+    // IndexedPersistentDict (see persistent_indexed_dict.hpp)
+    py::class_<IndexedPersistentDict>(m, "IndexedPersistentDict")
+        .def(py::init([](const py::object& indexes, const py::object& sorted_indexes,
+                         const py::object& data) {
+                 return IndexedPersistentDict(
+                     indexes.is_none() ? py::dict() : indexes.cast<py::dict>(),
+                     sorted_indexes.is_none() ? py::dict() : sorted_indexes.cast<py::dict>(),
+                     data);
+             }),
+             py::arg("indexes") = py::none(), py::arg("sorted_indexes") = py::none(),
+             py::arg("data") = py::none(),
+             "Create a PersistentDict of records with secondary indexes.\n\n"
+             "Args:\n"
+             "    indexes: Dict of index name -> key function for hash indexes\n"
+             "    sorted_indexes: Dict of index name -> key function for sorted\n"
+             "        indexes (support range queries; keys must be orderable)\n"
+             "    data: Optional initial mapping of id -> record, indexed in bulk\n\n"
+             "A record whose key function returns None is not indexed there.\n\n"
+             "Raises:\n"
+             "    ValueError: If an index name is declared twice\n"
+             "    TypeError: If a key function is not callable\n\n"
+             "Example:\n"
+             "    users = IndexedPersistentDict(\n"
+             "        indexes={'city': lambda r: r['city']},\n"
+             "        sorted_indexes={'age': lambda r: r['age']})")
+
+        .def("assoc", &IndexedPersistentDict::assoc,
+             py::arg("key"), py::arg("record"),
+             "Set key to record, updating every index.\n\n"
+             "Indexes whose key is unchanged are left as they are.\n\n"
+             "Returns:\n"
+             "    A new IndexedPersistentDict\n\n"
+             "Complexity: O(log n) per index whose key changed")
+
+        .def("set", &IndexedPersistentDict::assoc,
+             py::arg("key"), py::arg("record"),
+             "Alias for assoc().")
+
+        .def("dissoc", &IndexedPersistentDict::dissoc,
+             py::arg("key"),
+             "Remove key and its record from every index.\n\n"
+             "Returns:\n"
+             "    A new IndexedPersistentDict (the same contents if key is absent)")
+
+        .def("update", &IndexedPersistentDict::update,
+             py::arg("other"),
+             "Set every key of a mapping, updating the indexes.\n\n"
+             "Batches at least as large as the dict rebuild the indexes in bulk.\n\n"
+             "Returns:\n"
+             "    A new IndexedPersistentDict")
+
+        .def("get", &IndexedPersistentDict::get,
+             py::arg("key"), py::arg("default") = py::none(),
+             "Record for key, or default if absent.")
+
+        .def("__getitem__", &IndexedPersistentDict::pyGetItem,
+             py::arg("key"),
+             "Record for key.\n\n"
+             "Raises:\n"
+             "    KeyError: If key not found")
+
+        .def("__contains__", &IndexedPersistentDict::contains, py::arg("key"))
+        .def("__len__", &IndexedPersistentDict::size)
+        .def("__iter__", &IndexedPersistentDict::keys, "Iterate over primary keys.")
+
+        .def("lookup", &IndexedPersistentDict::lookup,
+             py::arg("index"), py::arg("value"),
+             "Keys of the records whose index key equals value.\n\n"
+             "Args:\n"
+             "    index: Index name\n"
+             "    value: Index key to look up\n\n"
+             "Returns:\n"
+             "    PersistentSet of keys (empty if none)\n\n"
+             "Raises:\n"
+             "    KeyError: If there is no such index")
+
+        .def("range",
+             [](const IndexedPersistentDict& self, const std::string& index, const py::object& start,
+                const py::object& stop, std::pair<bool, bool> inclusive) {
+                 return self.range(index, start, stop, inclusive.first, inclusive.second);
+             },
+             py::arg("index"), py::arg("start") = py::none(), py::arg("stop") = py::none(),
+             py::arg("inclusive") = std::make_pair(true, false),
+             "Lazy view of a sorted index between two index keys.\n\n"
+             "Args:\n"
+             "    index: Sorted index name\n"
+             "    start: Lower bound, or None for no lower bound\n"
+             "    stop: Upper bound, or None for no upper bound\n"
+             "    inclusive: (start_inclusive, stop_inclusive), default (True, False)\n\n"
+             "Returns:\n"
+             "    SortedDictRange of index key -> PersistentSet of keys\n\n"
+             "Raises:\n"
+             "    KeyError: If there is no such index\n"
+             "    ValueError: If the index is a hash index")
+
+        .def("index", &IndexedPersistentDict::index,
+             py::arg("name"),
+             "The index itself: a PersistentMultiMap (hash index) or a\n"
+             "PersistentSortedDict of key -> PersistentSet (sorted index).")
+
+        .def("index_names", &IndexedPersistentDict::indexNames,
+             "Names of the declared indexes, hash indexes first.")
+
+        .def_property_readonly("data", &IndexedPersistentDict::data,
+             "The primary PersistentDict of key -> record.")
+
+        .def("__repr__", &IndexedPersistentDict::repr);
+
+    addPathMethods(dict_class);
+    addPathMethods(array_map_class);
+    addPathMethods(list_class);
+    addPathMethods(sorted_dict_class);
+
+    // Exception-free subscript misses and iterator exhaustion; installed
+    // after every def() so no later dunder assignment resets the slots
+    pslots::installSubscript<PersistentDict>(
+        dict_class, &pslots::mapSubscript<PersistentDict, findInDict>);
+    pslots::installSubscript<PersistentArrayMap>(
+        array_map_class, &pslots::mapSubscript<PersistentArrayMap, findInArrayMap>);
+    pslots::installSubscript<PersistentSortedDict>(sorted_dict_class, &sortedDictSubscript);
+    pslots::installSubscript<PersistentList>(list_class, &listSubscript);
+    pslots::installSubscript<PersistentMultiMap>(
+        m.attr("PersistentMultiMap"), &pslots::mapSubscript<PersistentMultiMap, findInMultiMap>);
+    pslots::installSubscript<PersistentOrderedDict>(
+        m.attr("PersistentOrderedDict"), &pslots::mapSubscript<PersistentOrderedDict, findInOrderedDict>);
+    pslots::installSubscript<IndexedPersistentDict>(
+        m.attr("IndexedPersistentDict"),
+        &pslots::mapSubscript<IndexedPersistentDict, findInIndexedDict>);
+
+    pslots::installIterNext<KeyIterator>(m.attr("KeyIterator"));
+    pslots::installIterNext<ValueIterator>(m.attr("ValueIterator"));
+    pslots::installIterNext<ItemIterator>(m.attr("ItemIterator"));
+    pslots::installIterNext<ArrayMapKeyIterator>(m.attr("ArrayMapKeyIterator"));
+    pslots::installIterNext<ArrayMapValueIterator>(m.attr("ArrayMapValueIterator"));
+    pslots::installIterNext<ArrayMapItemIterator>(m.attr("ArrayMapItemIterator"));
+    pslots::installIterNext<SetIterator>(m.attr("SetIterator"));
+    pslots::installIterNext<VectorIterator>(m.attr("VectorIterator"));
+    pslots::installIterNext<ReverseVectorIterator>(m.attr("ReverseVectorIterator"));
+    pslots::installIterNext<TreeMapIteratorWrapper>(m.attr("TreeMapIteratorWrapper"));
+    pslots::installIterNext<SortedRangeIterator>(m.attr("SortedRangeIterator"));
+    pslots::installIterNext<OrderedDictIterator>(m.attr("OrderedDictIterator"));
+
+    // tracemalloc domains for native allocations (see tracked_alloc.hpp)
+    py::dict domains;
+    domains["PersistentDict"] = static_cast<unsigned int>(pmalloc::DOMAIN_DICT);
+    domains["PersistentSortedDict"] = static_cast<unsigned int>(pmalloc::DOMAIN_SORTED_DICT);
+    domains["PersistentList"] = static_cast<unsigned int>(pmalloc::DOMAIN_LIST);
+    domains["PersistentIntervalMap"] = static_cast<unsigned int>(pmalloc::DOMAIN_INTERVAL_MAP);
+    domains["BulkOpArena"] = static_cast<unsigned int>(pmalloc::DOMAIN_ARENA);
+    m.attr("TRACEMALLOC_DOMAINS") = domains;
+
+    // Deep conversion (see persistent_freeze.hpp)
+    m.def("freeze", &pfreeze::freeze,
+          py::arg("obj"), py::arg("array_maps") = true,
+          "Recursively convert plain containers to persistent ones.\n\n"
+          "dict becomes PersistentDict (PersistentArrayMap for 8 or fewer\n"
+          "items when array_maps is true), list becomes PersistentList,\n"
+          "set/frozenset become PersistentSet and tuples get frozen elements.\n"
+          "Runs in one native pass using the bulk builders at every level.\n"
+          "Shared sub-objects are converted once and stay shared.\n\n"
+          "Args:\n"
+          "    obj: The value to convert\n"
+          "    array_maps: Use PersistentArrayMap for small dicts\n\n"
+          "Returns:\n"
+          "    The frozen value (other objects are returned unchanged)\n\n"
+          "Raises:\n"
+          "    ValueError: If obj contains a reference cycle\n\n"
+          "Complexity: O(n) in the total number of elements");
+
+    m.def("thaw", &pfreeze::thaw,
+          py::arg("obj"),
+          "Recursively convert persistent containers to plain ones.\n\n"
+          "PersistentDict, PersistentArrayMap, PersistentSortedDict and\n"
+          "PersistentOrderedDict become dict (in their iteration order),\n"
+          "PersistentList becomes list and PersistentSet becomes set.\n"
+          "Plain containers are copied with their contents thawed.\n\n"
+          "Args:\n"
+          "    obj: The value to convert\n\n"
+          "Returns:\n"
+          "    The thawed value (other objects are returned unchanged)\n\n"
+          "Raises:\n"
+          "    ValueError: If obj contains a reference cycle\n\n"
+          "Complexity: O(n) in the total number of elements");
+
+    // JSON codec (see persistent_json.hpp)
+    m.def("loads_json", &pjson::loads,
+          py::arg("data"), py::arg("array_maps") = true,
+          "Parse JSON directly into persistent structures.\n\n"
+          "Objects become PersistentDict (PersistentArrayMap for 8 or fewer\n"
+          "members when array_maps is true) and arrays become PersistentList.\n"
+          "No intermediate dict/list tree is built, object keys are interned\n"
+          "and shared across the document, and duplicate keys keep the last\n"
+          "value like json.loads. NaN and Infinity are accepted.\n\n"
+          "Args:\n"
+          "    data: UTF-8 JSON as bytes, bytearray, memoryview or str\n"
+          "    array_maps: Use PersistentArrayMap for small objects\n\n"
+          "Returns:\n"
+          "    The parsed value\n\n"
+          "Raises:\n"
+          "    ValueError: If the document is malformed (with line and column)\n\n"
+          "Complexity: O(n) in the document size");
+
+    m.def("dumps_json", &pjson::dumps,
+          py::arg("obj"), py::arg("sort_keys") = false,
+          "Serialize persistent structures to compact UTF-8 JSON.\n\n"
+          "Walks PersistentDict, PersistentArrayMap and PersistentList\n"
+          "directly, without materializing dicts or lists. Plain dict, list,\n"
+          "tuple, str, int, float, bool and None are also accepted. Output\n"
+          "matches json.dumps(obj, separators=(',', ':'), ensure_ascii=False).\n\n"
+          "Args:\n"
+          "    obj: The value to serialize\n"
+          "    sort_keys: Emit object members sorted by key with <, as json.dumps\n"
+          "        does (deterministic output; hash order otherwise)\n\n"
+          "Returns:\n"
+          "    JSON document as bytes\n\n"
+          "Raises:\n"
+          "    TypeError: If a value or key is not JSON serializable, or if\n"
+          "        sort_keys is set and an object's keys cannot be ordered\n\n"
+          "Complexity: O(n), plus O(k log k) per object when sort_keys is set");
+
     // Module-level documentation
     m.attr("__version__") = "2.0.0";
     m.attr("__doc__") = R"doc(
@@ -155,6 +155,16 @@ py::list PersistentArrayMap::itemsList() const {
     return result;
 }
 
+py::dict PersistentArrayMap::toDict() const {
+    py::dict result = pmutils::presizedDict(size());
+    if (entries_) {
+        for (const auto& entry : *entries_) {
+            pmutils::dictSetItem(result, entry.key, entry.value);
+        }
+    }
+    return result;
+}
+
 py::list PersistentArrayMap::keysList() const {
     py::list result;
     if (entries_) {
@@ -90,6 +90,9 @@ public:
     py::list keysList() const;
     py::list valuesList() const;
 
+    // Plain dict, presized
+    py::dict toDict() const;
+
     // Equality
     bool operator==(const PersistentArrayMap& other) const;
     bool operator!=(const PersistentArrayMap& other) const { return !(*this == other); }
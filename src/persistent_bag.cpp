@@ -0,0 +1,182 @@
+#include "persistent_bag.hpp"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+// Core operations
+PersistentBag PersistentBag::increment(const py::object& elem, size_t n) const {
+    if (n == 0) {
+        return *this;
+    }
+    PersistentDict newMap = map_.alter(elem, [n](const py::object& old) -> py::object {
+        size_t current = old ? old.cast<size_t>() : 0;
+        return py::int_(current + n);
+    });
+    return PersistentBag(newMap, count_ + n);
+}
+
+PersistentBag PersistentBag::remove(const py::object& elem, size_t n) const {
+    size_t removed = 0;
+    PersistentDict newMap = map_.alter(elem, [&](const py::object& old) -> py::object {
+        if (!old) {
+            return py::object();
+        }
+        size_t current = old.cast<size_t>();
+        removed = std::min(current, n);
+        if (current <= n) {
+            return py::object();  // Count reached zero - drop the element
+        }
+        return py::int_(current - n);
+    });
+
+    if (removed == 0) {
+        return *this;
+    }
+    return PersistentBag(newMap, count_ - removed);
+}
+
+PersistentBag PersistentBag::removeAll(const py::object& elem) const {
+    size_t removed = 0;
+    PersistentDict newMap = map_.alter(elem, [&](const py::object& old) -> py::object {
+        if (old) {
+            removed = old.cast<size_t>();
+        }
+        return py::object();
+    });
+
+    if (removed == 0) {
+        return *this;
+    }
+    return PersistentBag(newMap, count_ - removed);
+}
+
+size_t PersistentBag::count(const py::object& elem) const {
+    py::object c = map_.get(elem, PersistentDict::NOT_FOUND);
+    return c.is(PersistentDict::NOT_FOUND) ? 0 : c.cast<size_t>();
+}
+
+PersistentBag PersistentBag::merge(const PersistentBag& other) const {
+    PersistentDict merged = map_.mergeWith(other.map_,
+        [](const py::object& left, const py::object& right) -> py::object {
+            return py::int_(left.cast<size_t>() + right.cast<size_t>());
+        });
+    return PersistentBag(merged, count_ + other.count_);
+}
+
+// Materialization
+py::list PersistentBag::elements() const {
+    py::list result(count_);
+    size_t idx = 0;
+    for (auto item : map_.itemsList()) {
+        py::tuple kv = item.cast<py::tuple>();
+        py::object elem = kv[0];
+        size_t c = kv[1].cast<size_t>();
+        for (size_t i = 0; i < c; ++i) {
+            result[idx++] = elem;
+        }
+    }
+    return result;
+}
+
+py::list PersistentBag::mostCommon(const py::object& n) const {
+    std::vector<std::pair<size_t, py::object>> counted;
+    counted.reserve(map_.size());
+    for (auto item : map_.itemsList()) {
+        py::tuple kv = item.cast<py::tuple>();
+        counted.emplace_back(kv[1].cast<size_t>(), kv[0]);
+    }
+
+    // Stable so ties keep iteration order, as collections.Counter does
+    std::stable_sort(counted.begin(), counted.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    size_t limit = counted.size();
+    if (!n.is_none()) {
+        limit = std::min(limit, n.cast<size_t>());
+    }
+
+    py::list result(limit);
+    for (size_t i = 0; i < limit; ++i) {
+        result[i] = py::make_tuple(counted[i].second, counted[i].first);
+    }
+    return result;
+}
+
+py::dict PersistentBag::dict() const {
+    return map_.toDict();
+}
+
+// Equality
+bool PersistentBag::operator==(const PersistentBag& other) const {
+    if (count_ != other.count_) return false;
+    return map_ == other.map_;
+}
+
+// String representation
+std::string PersistentBag::repr() const {
+    std::ostringstream oss;
+    oss << "PersistentBag({";
+
+    bool first = true;
+    for (auto item : map_.itemsList()) {
+        if (!first) oss << ", ";
+        first = false;
+
+        py::tuple kv = item.cast<py::tuple>();
+        oss << py::repr(kv[0]).cast<std::string>() << ": "
+            << py::repr(kv[1]).cast<std::string>();
+    }
+
+    oss << "})";
+    return oss.str();
+}
+
+// Factory methods
+PersistentBag PersistentBag::fromIterable(const py::object& iterable) {
+    // Count in C++ buffers, then build the HAMT in one bulk pass
+    py::dict index;  // element -> position in elems/counts
+    std::vector<py::object> elems;
+    std::vector<size_t> counts;
+
+    py::iterator it = py::iter(iterable);
+    while (it != py::iterator::sentinel()) {
+        py::object elem = py::reinterpret_borrow<py::object>(*it);
+        PyObject* slot = PyDict_GetItemWithError(index.ptr(), elem.ptr());
+        if (slot != nullptr) {
+            counts[PyLong_AsSize_t(slot)]++;
+        } else {
+            if (PyErr_Occurred()) {
+                throw py::error_already_set();
+            }
+            index[elem] = py::int_(elems.size());
+            elems.push_back(elem);
+            counts.push_back(1);
+        }
+        ++it;
+    }
+
+    std::vector<std::pair<py::object, py::object>> entries;
+    entries.reserve(elems.size());
+    size_t total = 0;
+    for (size_t i = 0; i < elems.size(); ++i) {
+        entries.emplace_back(elems[i], py::int_(counts[i]));
+        total += counts[i];
+    }
+
+    return PersistentBag(PersistentDict::fromEntries(entries), total);
+}
+
+PersistentBag PersistentBag::fromCounts(const py::dict& counts) {
+    std::vector<std::pair<py::object, py::object>> entries;
+    entries.reserve(counts.size());
+    size_t total = 0;
+    for (auto item : counts) {
+        size_t c = py::reinterpret_borrow<py::object>(item.second).cast<size_t>();
+        if (c == 0) {
+            continue;  // Zero counts are not stored
+        }
+        entries.emplace_back(py::reinterpret_borrow<py::object>(item.first), py::int_(c));
+        total += c;
+    }
+    return PersistentBag(PersistentDict::fromEntries(entries), total);
+}
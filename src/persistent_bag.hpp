@@ -0,0 +1,67 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <string>
+#include "persistent_dict.hpp"
+
+namespace py = pybind11;
+
+/**
+ * PersistentBag - Immutable multiset / counter
+ *
+ * Stored as a PersistentDict mapping each element to its (positive) count.
+ * increment/remove read and rewrite the count in a single descent of the
+ * HAMT (PersistentDict::alter). merge() sums counts via the structural merge.
+ *
+ * len() is the total multiplicity; distinct_count() is the number of
+ * distinct elements.
+ */
+class PersistentBag {
+private:
+    PersistentDict map_;  // element -> count (Python int > 0)
+    size_t count_;        // Total multiplicity
+
+public:
+    // Constructors
+    PersistentBag() : map_(), count_(0) {}
+    PersistentBag(const PersistentDict& map, size_t count) : map_(map), count_(count) {}
+
+    // Core operations (functional style)
+    PersistentBag add(const py::object& elem) const { return increment(elem, 1); }
+    PersistentBag increment(const py::object& elem, size_t n = 1) const;
+    PersistentBag remove(const py::object& elem, size_t n = 1) const;  // Removes up to n
+    PersistentBag removeAll(const py::object& elem) const;
+
+    size_t count(const py::object& elem) const;
+    bool contains(const py::object& elem) const { return map_.contains(elem); }
+
+    // Sum of counts
+    PersistentBag merge(const PersistentBag& other) const;
+
+    // Size
+    size_t size() const { return count_; }
+    size_t distinctCount() const { return map_.size(); }
+
+    // Iteration
+    KeyIterator iter() const { return map_.keys(); }   // Distinct elements
+    py::list distinctList() const { return map_.keysList(); }
+    py::list itemsList() const { return map_.itemsList(); }  // (element, count)
+    py::list elements() const;                               // Repeated by count
+    py::list mostCommon(const py::object& n) const;          // n=None -> all
+    py::dict dict() const;
+
+    // Equality
+    bool operator==(const PersistentBag& other) const;
+    bool operator!=(const PersistentBag& other) const { return !(*this == other); }
+
+    // String representation
+    std::string repr() const;
+
+    // Factory methods
+    static PersistentBag fromIterable(const py::object& iterable);
+    static PersistentBag fromCounts(const py::dict& counts);
+
+    // Access to underlying map (for implementation)
+    const PersistentDict& getMap() const { return map_; }
+};
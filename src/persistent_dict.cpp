@@ -1,18 +1,42 @@
 #include "persistent_dict.hpp"
+#include "persistent_list.hpp"
 #include <sstream>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unordered_map>
 
 // Initialize static sentinel value
 py::object PersistentDict::NOT_FOUND = py::object();
 
+namespace {
+
+uint64_t readHashSeed() {
+    const char* env = std::getenv("PYPERSISTENT_HASH_SEED");
+    if (env == nullptr || *env == '\0') {
+        return 0;
+    }
+    if (std::strcmp(env, "random") == 0) {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+    return std::strtoull(env, nullptr, 0);
+}
+
+} // namespace
+
+const uint64_t pmutils::HASH_SEED = readHashSeed();
+
 //=============================================================================
 // BitmapNode Implementation
 //=============================================================================
 
-py::object BitmapNode::get(uint32_t shift, uint32_t hash,
+py::object BitmapNode::get(uint32_t shift, hash_t hash,
                            const py::object& key, const py::object& notFound) const {
-    uint32_t bit_pos = 1 << ((hash >> shift) & HASH_MASK);
+    bitmap_t bit_pos = slotBit((hash >> shift) & HASH_MASK);
 
     // Check if this slot is occupied
     if ((bitmap_ & bit_pos) == 0) {
@@ -27,7 +51,7 @@ py::object BitmapNode::get(uint32_t shift, uint32_t hash,
     if (std::holds_alternative<std::shared_ptr<Entry>>(elem)) {
         // It's a key-value entry
         const auto& entry = std::get<std::shared_ptr<Entry>>(elem);
-        if (pmutils::keysEqual(entry->key, key)) {
+        if (entry->hash == hash && pmutils::keysEqual(entry->key, key)) {
             return entry->value;
         }
         return notFound;
@@ -38,9 +62,9 @@ py::object BitmapNode::get(uint32_t shift, uint32_t hash,
     }
 }
 
-NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
+NodeBase* BitmapNode::assoc(uint32_t shift, hash_t hash,
                             const py::object& key, const py::object& val) const {
-    uint32_t bit_pos = 1 << ((hash >> shift) & HASH_MASK);
+    bitmap_t bit_pos = slotBit((hash >> shift) & HASH_MASK);
     uint32_t idx = popcount(bitmap_ & (bit_pos - 1));
 
     if ((bitmap_ & bit_pos) != 0) {
@@ -51,7 +75,7 @@ NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
             // It's a key-value entry
             const auto& entry = std::get<std::shared_ptr<Entry>>(elem);
 
-            if (pmutils::keysEqual(entry->key, key)) {
+            if (entry->hash == hash && pmutils::keysEqual(entry->key, key)) {
                 // Same key, update value
                 if (entry->value.is(val)) {
                     // Value unchanged, return same node
@@ -59,23 +83,22 @@ NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
                 }
 
                 // Copy-on-write: copy array (cheap shared_ptr copies!) and update one entry
-                std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray = array_;
+                NodeArray newArray = array_;
                 // Only increment refcount for nodes
                 for (auto& e : newArray) {
                     if (std::holds_alternative<NodeBase*>(e)) {
                         std::get<NodeBase*>(e)->addRef();
                     }
                 }
-                newArray[idx] = std::make_shared<Entry>(key, val);
+                newArray[idx] = makeEntry(key, val, hash);
                 return new BitmapNode(bitmap_, std::move(newArray));
             } else {
                 // Different key, same hash slot - create a sub-node
-                NodeBase* newChild = createNode(shift + HASH_BITS,
-                                               entry->key, entry->value,
-                                               hash, key, val);
+                NodeBase* newChild = createNode(shift + HASH_BITS, entry,
+                                               makeEntry(key, val, hash));
 
                 // Copy array and replace entry with child node
-                std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray = array_;
+                NodeArray newArray = array_;
                 newChild->addRef();
                 for (auto& e : newArray) {
                     if (std::holds_alternative<NodeBase*>(e)) {
@@ -96,7 +119,7 @@ NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
             }
 
             // Copy array and update child node
-            std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray = array_;
+            NodeArray newArray = array_;
             newChild->addRef();
             for (auto& e : newArray) {
                 if (std::holds_alternative<NodeBase*>(e)) {
@@ -108,7 +131,7 @@ NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
         }
     } else {
         // Slot is empty, insert new entry
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray;
+        NodeArray newArray;
         newArray.reserve(array_.size() + 1);
 
         // Copy elements before insertion point
@@ -122,7 +145,7 @@ NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
         }
 
         // Insert new entry
-        newArray.push_back(std::make_shared<Entry>(key, val));
+        newArray.push_back(makeEntry(key, val, hash));
 
         // Copy elements after insertion point
         for (size_t i = idx; i < array_.size(); ++i) {
@@ -138,9 +161,9 @@ NodeBase* BitmapNode::assoc(uint32_t shift, uint32_t hash,
     }
 }
 
-NodeBase* BitmapNode::dissoc(uint32_t shift, uint32_t hash,
+NodeBase* BitmapNode::dissoc(uint32_t shift, hash_t hash,
                              const py::object& key) const {
-    uint32_t bit_pos = 1 << ((hash >> shift) & HASH_MASK);
+    bitmap_t bit_pos = slotBit((hash >> shift) & HASH_MASK);
 
     if ((bitmap_ & bit_pos) == 0) {
         // Key not in this node
@@ -154,7 +177,7 @@ NodeBase* BitmapNode::dissoc(uint32_t shift, uint32_t hash,
         // It's a key-value entry
         const auto& entry = std::get<std::shared_ptr<Entry>>(elem);
 
-        if (!pmutils::keysEqual(entry->key, key)) {
+        if (entry->hash != hash || !pmutils::keysEqual(entry->key, key)) {
             // Different key, no change
             return const_cast<BitmapNode*>(this);
         }
@@ -166,7 +189,7 @@ NodeBase* BitmapNode::dissoc(uint32_t shift, uint32_t hash,
         }
 
         // Create new array without this entry
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray;
+        NodeArray newArray;
         newArray.reserve(array_.size() - 1);
         for (size_t i = 0; i < array_.size(); ++i) {
             if (i == static_cast<size_t>(idx)) {
@@ -200,7 +223,7 @@ NodeBase* BitmapNode::dissoc(uint32_t shift, uint32_t hash,
             }
 
             // Create new array without this entry
-            std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray;
+            NodeArray newArray;
             newArray.reserve(array_.size() - 1);
             for (size_t i = 0; i < array_.size(); ++i) {
                 if (i == static_cast<size_t>(idx)) {
@@ -218,7 +241,7 @@ NodeBase* BitmapNode::dissoc(uint32_t shift, uint32_t hash,
             return new BitmapNode(bitmap_ & ~bit_pos, std::move(newArray));
         } else {
             // Child changed - copy array and update
-            std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray;
+            NodeArray newArray;
             newArray.reserve(array_.size());
             for (size_t i = 0; i < array_.size(); ++i) {
                 if (i == static_cast<size_t>(idx)) {
@@ -249,125 +272,564 @@ void BitmapNode::iterate(const std::function<void(const py::object&, const py::o
     }
 }
 
-NodeBase* BitmapNode::createNode(uint32_t shift,
-                                const py::object& key1, const py::object& val1,
-                                uint32_t hash2, const py::object& key2, const py::object& val2) const {
-    uint32_t hash1 = pmutils::hashKey(key1);
+NodeBase* BitmapNode::alter(uint32_t shift, hash_t hash, const py::object& key,
+                            const AlterFn& fn, int& delta) const {
+    bitmap_t bit_pos = slotBit((hash >> shift) & HASH_MASK);
+    uint32_t idx = popcount(bitmap_ & (bit_pos - 1));
+    delta = 0;
+
+    if ((bitmap_ & bit_pos) == 0) {
+        // Key absent, slot free
+        py::object newVal = fn(py::object());
+        if (!newVal) {
+            return const_cast<BitmapNode*>(this);
+        }
+        delta = 1;
+        return insertSlot(idx, bit_pos, makeEntry(key, newVal, hash));
+    }
+
+    const auto& elem = array_[idx];
+
+    if (std::holds_alternative<std::shared_ptr<Entry>>(elem)) {
+        const auto& entry = std::get<std::shared_ptr<Entry>>(elem);
+
+        if (entry->hash == hash && pmutils::keysEqual(entry->key, key)) {
+            py::object newVal = fn(entry->value);
+            if (!newVal) {
+                delta = -1;
+                if (popcount(bitmap_) == 1) {
+                    return nullptr;
+                }
+                return removeSlot(idx, bit_pos);
+            }
+            if (newVal.is(entry->value)) {
+                return const_cast<BitmapNode*>(this);
+            }
+            // Keep the stored key object, only the value changes
+            return replaceSlot(idx, makeEntry(entry->key, newVal, entry->hash));
+        }
+
+        // Key absent, slot taken by a different key - push both down a level
+        py::object newVal = fn(py::object());
+        if (!newVal) {
+            return const_cast<BitmapNode*>(this);
+        }
+        delta = 1;
+        NodeBase* newChild = createNode(shift + HASH_BITS, entry,
+                                        makeEntry(key, newVal, hash));
+        return replaceSlot(idx, newChild);
+    }
+
+    // Child node, recurse
+    NodeBase* child = std::get<NodeBase*>(elem);
+    NodeBase* newChild = child->alter(shift + HASH_BITS, hash, key, fn, delta);
+
+    if (newChild == child) {
+        return const_cast<BitmapNode*>(this);
+    }
+    if (newChild == nullptr) {
+        if (popcount(bitmap_) == 1) {
+            return nullptr;
+        }
+        return removeSlot(idx, bit_pos);
+    }
+    return replaceSlot(idx, newChild);
+}
 
-    if (shift >= 64) {
-        // Too deep, use collision node
-        std::vector<Entry*> entries;
-        entries.push_back(new Entry(key1, val1));
-        entries.push_back(new Entry(key2, val2));
-        return new CollisionNode(hash1, std::move(entries));
+NodeBase* BitmapNode::replaceSlot(uint32_t idx,
+                                  const std::variant<std::shared_ptr<Entry>, NodeBase*>& slot) const {
+    NodeArray newArray = array_;
+    for (size_t i = 0; i < newArray.size(); ++i) {
+        if (i != static_cast<size_t>(idx) && std::holds_alternative<NodeBase*>(newArray[i])) {
+            std::get<NodeBase*>(newArray[i])->addRef();
+        }
+    }
+    if (std::holds_alternative<NodeBase*>(slot)) {
+        std::get<NodeBase*>(slot)->addRef();
     }
+    newArray[idx] = slot;
+    return new BitmapNode(bitmap_, std::move(newArray));
+}
 
-    uint32_t idx1 = (hash1 >> shift) & HASH_MASK;
-    uint32_t idx2 = (hash2 >> shift) & HASH_MASK;
+NodeBase* BitmapNode::insertSlot(uint32_t idx, bitmap_t bit_pos,
+                                 const std::variant<std::shared_ptr<Entry>, NodeBase*>& slot) const {
+    NodeArray newArray;
+    newArray.reserve(array_.size() + 1);
+    for (size_t i = 0; i <= array_.size(); ++i) {
+        if (i == static_cast<size_t>(idx)) {
+            if (std::holds_alternative<NodeBase*>(slot)) {
+                std::get<NodeBase*>(slot)->addRef();
+            }
+            newArray.push_back(slot);
+        }
+        if (i == array_.size()) {
+            break;
+        }
+        const auto& e = array_[i];
+        if (std::holds_alternative<NodeBase*>(e)) {
+            std::get<NodeBase*>(e)->addRef();
+        }
+        newArray.push_back(e);
+    }
+    return new BitmapNode(bitmap_ | bit_pos, std::move(newArray));
+}
+
+NodeBase* BitmapNode::removeSlot(uint32_t idx, bitmap_t bit_pos) const {
+    NodeArray newArray;
+    newArray.reserve(array_.size() - 1);
+    for (size_t i = 0; i < array_.size(); ++i) {
+        if (i == static_cast<size_t>(idx)) {
+            continue;
+        }
+        const auto& e = array_[i];
+        if (std::holds_alternative<NodeBase*>(e)) {
+            std::get<NodeBase*>(e)->addRef();
+        }
+        newArray.push_back(e);
+    }
+    return new BitmapNode(bitmap_ & ~bit_pos, std::move(newArray));
+}
+
+NodeBase* BitmapNode::createNode(uint32_t shift, const std::shared_ptr<Entry>& existing,
+                                 const std::shared_ptr<Entry>& added) {
+    if (shift >= MAX_TRIE_SHIFT) {
+        // Hash bits exhausted - the full hashes are equal, use collision node
+        std::vector<std::shared_ptr<Entry>> entries;
+        entries.push_back(existing);
+        entries.push_back(added);
+        return new CollisionNode(existing->hash, std::move(entries));
+    }
+
+    uint32_t idx1 = (existing->hash >> shift) & HASH_MASK;
+    uint32_t idx2 = (added->hash >> shift) & HASH_MASK;
 
     if (idx1 == idx2) {
         // Same index at this level, recurse deeper
-        NodeBase* child = createNode(shift + HASH_BITS, key1, val1, hash2, key2, val2);
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> array;
+        NodeBase* child = createNode(shift + HASH_BITS, existing, added);
+        NodeArray array;
         array.push_back(child);
         child->addRef();
-        return new BitmapNode(1 << idx1, std::move(array));
+        return new BitmapNode(slotBit(idx1), std::move(array));
     } else {
         // Different indices, create node with both entries
-        uint32_t bitmap = (1 << idx1) | (1 << idx2);
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> array;
+        bitmap_t bitmap = slotBit(idx1) | slotBit(idx2);
+        NodeArray array;
 
         if (idx1 < idx2) {
-            array.push_back(std::make_shared<Entry>(key1, val1));
-            array.push_back(std::make_shared<Entry>(key2, val2));
+            array.push_back(existing);
+            array.push_back(added);
         } else {
-            array.push_back(std::make_shared<Entry>(key2, val2));
-            array.push_back(std::make_shared<Entry>(key1, val1));
+            array.push_back(added);
+            array.push_back(existing);
         }
 
         return new BitmapNode(bitmap, std::move(array));
     }
 }
 
+namespace {
+
+using Slot = std::variant<std::shared_ptr<Entry>, NodeBase*>;
+
+// Slot array of a node under construction. Holds a reference on every child
+// node until build() hands them over, so a throwing callback midway through
+// a bulk transform does not leak the children built so far.
+class PendingSlots {
+public:
+    PendingSlots() = default;
+    PendingSlots(const PendingSlots&) = delete;
+    PendingSlots& operator=(const PendingSlots&) = delete;
+
+    ~PendingSlots() {
+        for (const auto& slot : slots_) {
+            if (std::holds_alternative<NodeBase*>(slot)) {
+                std::get<NodeBase*>(slot)->release();
+            }
+        }
+    }
+
+    bool started() const { return started_; }
+    bool empty() const { return slots_.empty(); }
+    size_t size() const { return slots_.size(); }
+
+    // Start from a copy of the first count slots of an existing node
+    void startFrom(const NodeArray& array, size_t count) {
+        started_ = true;
+        slots_.reserve(array.size());
+        for (size_t i = 0; i < count; ++i) {
+            push(array[i]);
+        }
+    }
+
+    // Adds a reference for child nodes (new nodes start at refcount 0)
+    void push(const Slot& slot) {
+        if (std::holds_alternative<NodeBase*>(slot)) {
+            std::get<NodeBase*>(slot)->addRef();
+        }
+        slots_.push_back(slot);
+    }
+
+    NodeBase* build(bitmap_t bitmap) {
+        return new BitmapNode(bitmap, std::move(slots_));
+    }
+
+private:
+    NodeArray slots_;
+    bool started_ = false;
+};
+
+// The single entry left in a node, if any - lifted into the parent slot
+// when a filter shrinks a subtree to one entry
+std::shared_ptr<Entry> soleEntry(const NodeBase* node) {
+    if (auto* bitmapNode = dynamic_cast<const BitmapNode*>(node)) {
+        const NodeArray& array = bitmapNode->getArray();
+        if (array.size() == 1 && std::holds_alternative<std::shared_ptr<Entry>>(array[0])) {
+            return std::get<std::shared_ptr<Entry>>(array[0]);
+        }
+    } else if (auto* collisionNode = dynamic_cast<const CollisionNode*>(node)) {
+        if (collisionNode->getEntries().size() == 1) {
+            return collisionNode->getEntries()[0];
+        }
+    }
+    return nullptr;
+}
+
+// Frees a node that was never attached to a parent (refcount 0)
+void discard(NodeBase* node) {
+    node->addRef();
+    node->release();
+}
+
+} // namespace
+
+NodeBase* BitmapNode::mapValues(const MapFn& fn) const {
+    PendingSlots pending;
+    for (size_t i = 0; i < array_.size(); ++i) {
+        const auto& elem = array_[i];
+        Slot replacement;
+        if (std::holds_alternative<std::shared_ptr<Entry>>(elem)) {
+            const auto& entry = std::get<std::shared_ptr<Entry>>(elem);
+            py::object newVal = fn(entry->value);
+            if (newVal.is(entry->value)) {
+                if (pending.started()) pending.push(elem);
+                continue;
+            }
+            // Key and hash are reused as-is - no rehashing
+            replacement = makeEntry(entry->key, newVal, entry->hash);
+        } else {
+            NodeBase* child = std::get<NodeBase*>(elem);
+            NodeBase* newChild = child->mapValues(fn);
+            if (newChild == child) {
+                if (pending.started()) pending.push(elem);
+                continue;
+            }
+            replacement = newChild;
+        }
+        if (!pending.started()) {
+            pending.startFrom(array_, i);
+        }
+        pending.push(replacement);
+    }
+
+    if (!pending.started()) {
+        return const_cast<BitmapNode*>(this);
+    }
+    return pending.build(bitmap_);
+}
+
+NodeBase* BitmapNode::filter(const EntryPredicate& pred, size_t& removed) const {
+    PendingSlots pending;
+    bitmap_t newBitmap = 0;
+    bitmap_t remaining = bitmap_;
+
+    for (size_t i = 0; i < array_.size(); ++i) {
+        bitmap_t bit_pos = remaining & (~remaining + 1);  // Lowest set bit = slot i
+        remaining &= remaining - 1;
+
+        const auto& elem = array_[i];
+        bool keep = true;
+        Slot replacement;
+        bool replaced = false;
+
+        if (std::holds_alternative<std::shared_ptr<Entry>>(elem)) {
+            const auto& entry = std::get<std::shared_ptr<Entry>>(elem);
+            if (!pred(entry->key, entry->value)) {
+                keep = false;
+                removed++;
+            }
+        } else {
+            NodeBase* child = std::get<NodeBase*>(elem);
+            NodeBase* newChild = child->filter(pred, removed);
+            if (newChild == nullptr) {
+                keep = false;
+            } else if (newChild != child) {
+                replaced = true;
+                // Compact on the way up: a subtree reduced to one entry is
+                // stored directly in this slot
+                if (auto entry = soleEntry(newChild)) {
+                    discard(newChild);
+                    replacement = entry;
+                } else {
+                    replacement = newChild;
+                }
+            }
+        }
+
+        if (keep && !replaced) {
+            if (pending.started()) pending.push(elem);
+            newBitmap |= bit_pos;
+            continue;
+        }
+        if (!pending.started()) {
+            pending.startFrom(array_, i);
+        }
+        if (keep) {
+            pending.push(replacement);
+            newBitmap |= bit_pos;
+        }
+    }
+
+    if (!pending.started()) {
+        return const_cast<BitmapNode*>(this);
+    }
+    if (pending.empty()) {
+        return nullptr;
+    }
+    return pending.build(newBitmap);
+}
+
 //=============================================================================
 // CollisionNode Implementation
 //=============================================================================
 
-py::object CollisionNode::get(uint32_t /*shift*/, uint32_t /*hash*/,
-                              const py::object& key, const py::object& notFound) const {
-    for (Entry* entry : *entries_) {
-        if (pmutils::keysEqual(entry->key, key)) {
-            return entry->value;
+namespace {
+
+// Exact types whose < ordering is total and agrees with ==, so a bucket of
+// such keys can be bisected. Subclasses may override either, so only exact
+// instances qualify.
+bool isOrderableKeyType(PyTypeObject* type) {
+    return type == &PyLong_Type || type == &PyUnicode_Type || type == &PyBytes_Type;
+}
+
+bool keyLess(const py::object& a, const py::object& b) {
+    int result = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_LT);
+    if (result == -1) {
+        throw py::error_already_set();
+    }
+    return result == 1;
+}
+
+} // namespace
+
+CollisionNode::CollisionNode(hash_t hash, std::vector<std::shared_ptr<Entry>>&& entries)
+    : hash_(hash), entries_(std::move(entries)), sorted_(false) {
+    if (entries_.size() < COLLISION_SORT_THRESHOLD) {
+        return;
+    }
+    PyTypeObject* type = Py_TYPE(entries_[0]->key.ptr());
+    if (!isOrderableKeyType(type)) {
+        return;
+    }
+    for (const auto& entry : entries_) {
+        if (Py_TYPE(entry->key.ptr()) != type) {
+            return;
         }
     }
-    return notFound;
+    std::sort(entries_.begin(), entries_.end(),
+              [](const std::shared_ptr<Entry>& a, const std::shared_ptr<Entry>& b) {
+                  return keyLess(a->key, b->key);
+              });
+    sorted_ = true;
 }
 
-NodeBase* CollisionNode::assoc(uint32_t /*shift*/, uint32_t /*hash*/,
-                               const py::object& key, const py::object& val) const {
-    // Check if key already exists
-    for (size_t i = 0; i < entries_->size(); ++i) {
-        if (pmutils::keysEqual((*entries_)[i]->key, key)) {
-            // Key exists, update value
-            if ((*entries_)[i]->value.is(val)) {
-                // Value unchanged
-                return const_cast<CollisionNode*>(this);
-            }
+bool CollisionNode::bisectable(const py::object& key) const {
+    // A key of another type may still compare equal (1.0 == 1), so those
+    // fall back to a linear scan
+    return sorted_ && Py_TYPE(key.ptr()) == Py_TYPE(entries_[0]->key.ptr());
+}
+
+size_t CollisionNode::lowerBound(const py::object& key) const {
+    auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+                               [](const std::shared_ptr<Entry>& e, const py::object& k) {
+                                   return keyLess(e->key, k);
+                               });
+    return static_cast<size_t>(it - entries_.begin());
+}
 
-            // Copy-on-write: only copy the vector, reuse Entry pointers except for the changed one
-            auto newEntries = std::make_shared<std::vector<Entry*>>(*entries_);
-            delete (*newEntries)[i];  // Delete the old entry
-            (*newEntries)[i] = new Entry(key, val);  // Replace with new entry
-            return new CollisionNode(hash_, newEntries);
+size_t CollisionNode::find(const py::object& key) const {
+    if (bisectable(key)) {
+        size_t idx = lowerBound(key);
+        if (idx < entries_.size() && pmutils::keysEqual(entries_[idx]->key, key)) {
+            return idx;
         }
+        return entries_.size();
     }
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (pmutils::keysEqual(entries_[i]->key, key)) {
+            return i;
+        }
+    }
+    return entries_.size();
+}
 
-    // Key not found, append
-    // Copy-on-write: copy vector and add new entry
-    auto newEntries = std::make_shared<std::vector<Entry*>>(*entries_);
-    newEntries->push_back(new Entry(key, val));
-    return new CollisionNode(hash_, newEntries);
+NodeBase* CollisionNode::withAdded(const std::shared_ptr<Entry>& entry) const {
+    std::vector<std::shared_ptr<Entry>> newEntries;
+    newEntries.reserve(entries_.size() + 1);
+    if (bisectable(entry->key)) {
+        // Already sorted - splice the new entry into place
+        size_t pos = lowerBound(entry->key);
+        newEntries.insert(newEntries.end(), entries_.begin(), entries_.begin() + pos);
+        newEntries.push_back(entry);
+        newEntries.insert(newEntries.end(), entries_.begin() + pos, entries_.end());
+        return new CollisionNode(hash_, std::move(newEntries), true);
+    }
+    // Unsorted (or the new key breaks type uniformity): let the constructor
+    // decide whether the grown bucket qualifies for sorting
+    newEntries = entries_;
+    newEntries.push_back(entry);
+    return new CollisionNode(hash_, std::move(newEntries));
+}
+
+NodeBase* CollisionNode::withReplaced(size_t idx, const std::shared_ptr<Entry>& entry) const {
+    std::vector<std::shared_ptr<Entry>> newEntries = entries_;
+    newEntries[idx] = entry;
+    return new CollisionNode(hash_, std::move(newEntries), sorted_);
+}
+
+NodeBase* CollisionNode::withRemoved(size_t idx) const {
+    std::vector<std::shared_ptr<Entry>> newEntries;
+    newEntries.reserve(entries_.size() - 1);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (i != idx) {
+            newEntries.push_back(entries_[i]);
+        }
+    }
+    // Removing keeps a sorted bucket sorted
+    return new CollisionNode(hash_, std::move(newEntries), sorted_);
+}
+
+py::object CollisionNode::get(uint32_t /*shift*/, hash_t hash,
+                              const py::object& key, const py::object& notFound) const {
+    if (hash != hash_) {
+        return notFound;
+    }
+    size_t idx = find(key);
+    if (idx == entries_.size()) {
+        return notFound;
+    }
+    return entries_[idx]->value;
+}
+
+NodeBase* CollisionNode::assoc(uint32_t /*shift*/, hash_t /*hash*/,
+                               const py::object& key, const py::object& val) const {
+    size_t idx = find(key);
+    if (idx < entries_.size()) {
+        const auto& entry = entries_[idx];
+        if (entry->value.is(val)) {
+            // Value unchanged
+            return const_cast<CollisionNode*>(this);
+        }
+        // Keep the stored key object so the bucket's key types (and order) hold
+        return withReplaced(idx, makeEntry(entry->key, val, hash_));
+    }
+
+    // Key not found, add
+    return withAdded(makeEntry(key, val, hash_));
 }
 
-NodeBase* CollisionNode::dissoc(uint32_t /*shift*/, uint32_t /*hash*/,
+NodeBase* CollisionNode::dissoc(uint32_t /*shift*/, hash_t hash,
                                 const py::object& key) const {
-    for (size_t i = 0; i < entries_->size(); ++i) {
-        if (pmutils::keysEqual((*entries_)[i]->key, key)) {
-            // Found it
-            if (entries_->size() == 1) {
-                // Last entry, return null
-                return nullptr;
-            }
+    if (hash != hash_) {
+        return const_cast<CollisionNode*>(this);
+    }
+    size_t idx = find(key);
+    if (idx == entries_.size()) {
+        // Key not found
+        return const_cast<CollisionNode*>(this);
+    }
+    if (entries_.size() == 1) {
+        // Last entry, return null
+        return nullptr;
+    }
+    return withRemoved(idx);
+}
 
-            if (entries_->size() == 2) {
-                // Only one entry left, return null (will be handled by parent)
+NodeBase* CollisionNode::alter(uint32_t /*shift*/, hash_t /*hash*/, const py::object& key,
+                               const AlterFn& fn, int& delta) const {
+    delta = 0;
+    size_t idx = find(key);
+
+    if (idx < entries_.size()) {
+        const auto& entry = entries_[idx];
+        py::object newVal = fn(entry->value);
+        if (!newVal) {
+            delta = -1;
+            if (entries_.size() == 1) {
                 return nullptr;
             }
-
-            // Create new collision node without this entry
-            // Copy-on-write: copy vector and remove entry, but need to duplicate Entry objects
-            // since the old node will delete them
-            auto newEntries = std::make_shared<std::vector<Entry*>>();
-            newEntries->reserve(entries_->size() - 1);
-            for (size_t j = 0; j < entries_->size(); ++j) {
-                if (j != i) {
-                    newEntries->push_back(new Entry((*entries_)[j]->key, (*entries_)[j]->value));
-                }
-            }
-            return new CollisionNode(hash_, newEntries);
+            return withRemoved(idx);
+        }
+        if (newVal.is(entry->value)) {
+            return const_cast<CollisionNode*>(this);
         }
+        return withReplaced(idx, makeEntry(entry->key, newVal, hash_));
     }
 
     // Key not found
-    return const_cast<CollisionNode*>(this);
+    py::object newVal = fn(py::object());
+    if (!newVal) {
+        return const_cast<CollisionNode*>(this);
+    }
+    delta = 1;
+    return withAdded(makeEntry(key, newVal, hash_));
 }
 
 void CollisionNode::iterate(const std::function<void(const py::object&, const py::object&)>& callback) const {
-    for (Entry* entry : *entries_) {
+    for (const auto& entry : entries_) {
         callback(entry->key, entry->value);
     }
 }
 
+NodeBase* CollisionNode::mapValues(const MapFn& fn) const {
+    std::vector<std::shared_ptr<Entry>> newEntries;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const auto& entry = entries_[i];
+        py::object newVal = fn(entry->value);
+        if (newVal.is(entry->value)) {
+            if (!newEntries.empty()) newEntries.push_back(entry);
+            continue;
+        }
+        if (newEntries.empty()) {
+            newEntries.reserve(entries_.size());
+            newEntries.insert(newEntries.end(), entries_.begin(), entries_.begin() + i);
+        }
+        newEntries.push_back(makeEntry(entry->key, newVal, entry->hash));
+    }
+    if (newEntries.empty()) {
+        return const_cast<CollisionNode*>(this);
+    }
+    // Keys are unchanged, so a sorted bucket stays sorted
+    return new CollisionNode(hash_, std::move(newEntries), sorted_);
+}
+
+NodeBase* CollisionNode::filter(const EntryPredicate& pred, size_t& removed) const {
+    std::vector<std::shared_ptr<Entry>> kept;
+    kept.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        if (pred(entry->key, entry->value)) {
+            kept.push_back(entry);
+        }
+    }
+    if (kept.size() == entries_.size()) {
+        return const_cast<CollisionNode*>(this);
+    }
+    removed += entries_.size() - kept.size();
+    if (kept.empty()) {
+        return nullptr;
+    }
+    return new CollisionNode(hash_, std::move(kept), sorted_);
+}
+
 //=============================================================================
 // MapIterator Implementation - O(log n) memory tree traversal
 //=============================================================================
@@ -500,8 +962,7 @@ std::pair<py::object, py::object> MapIterator::next() {
         key = entry->key;
         value = entry->value;
     } else if (auto* collisionNode = dynamic_cast<const CollisionNode*>(current_node_)) {
-        const auto& entries = collisionNode->getEntries();
-        Entry* entry = entries[current_index_];
+        const auto& entry = collisionNode->getEntries()[current_index_];
         key = entry->key;
         value = entry->value;
     }
@@ -515,13 +976,13 @@ std::pair<py::object, py::object> MapIterator::next() {
 //=============================================================================
 
 PersistentDict PersistentDict::assoc(const py::object& key, const py::object& val) const {
-    uint32_t hash = pmutils::hashKey(key);
+    hash_t hash = pmutils::hashKey(key);
 
     if (root_ == nullptr) {
         // Empty map, create first node
-        uint32_t bit_pos = 1 << (hash & HASH_MASK);
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> array;
-        array.push_back(std::make_shared<Entry>(key, val));
+        bitmap_t bit_pos = slotBit(hash & HASH_MASK);
+        NodeArray array;
+        array.push_back(makeEntry(key, val, hash));
         NodeBase* newRoot = new BitmapNode(bit_pos, std::move(array));
         return PersistentDict(newRoot, 1);
     }
@@ -544,7 +1005,7 @@ PersistentDict PersistentDict::dissoc(const py::object& key) const {
         return *this;
     }
 
-    uint32_t hash = pmutils::hashKey(key);
+    hash_t hash = pmutils::hashKey(key);
     py::object oldVal = root_->get(0, hash, key, NOT_FOUND);
 
     if (oldVal.is(NOT_FOUND)) {
@@ -556,12 +1017,36 @@ PersistentDict PersistentDict::dissoc(const py::object& key) const {
     return PersistentDict(newRoot, count_ - 1);
 }
 
+PersistentDict PersistentDict::alter(const py::object& key, const AlterFn& fn) const {
+    hash_t hash = pmutils::hashKey(key);
+
+    if (root_ == nullptr) {
+        py::object newVal = fn(py::object());
+        if (!newVal) {
+            return *this;
+        }
+        NodeArray array;
+        array.push_back(makeEntry(key, newVal, hash));
+        NodeBase* newRoot = new BitmapNode(slotBit(hash & HASH_MASK), std::move(array));
+        return PersistentDict(newRoot, 1);
+    }
+
+    // One descent: lookup, callback and path copy happen together
+    int delta = 0;
+    NodeBase* newRoot = root_->alter(0, hash, key, fn, delta);
+
+    if (newRoot == root_) {
+        return *this;
+    }
+    return PersistentDict(newRoot, count_ + delta);
+}
+
 py::object PersistentDict::get(const py::object& key, const py::object& default_val) const {
     if (root_ == nullptr) {
         return default_val;
     }
 
-    uint32_t hash = pmutils::hashKey(key);
+    hash_t hash = pmutils::hashKey(key);
     py::object result = root_->get(0, hash, key, NOT_FOUND);
 
     return result.is(NOT_FOUND) ? default_val : result;
@@ -572,7 +1057,7 @@ bool PersistentDict::contains(const py::object& key) const {
         return false;
     }
 
-    uint32_t hash = pmutils::hashKey(key);
+    hash_t hash = pmutils::hashKey(key);
     py::object result = root_->get(0, hash, key, NOT_FOUND);
     return !result.is(NOT_FOUND);
 }
@@ -646,6 +1131,40 @@ py::list PersistentDict::valuesList() const {
     return result;
 }
 
+namespace {
+
+void visitEntries(const NodeBase* node, const std::function<void(const Entry&)>& fn) {
+    if (auto* collisionNode = dynamic_cast<const CollisionNode*>(node)) {
+        for (const auto& entry : collisionNode->getEntries()) {
+            fn(*entry);
+        }
+        return;
+    }
+    for (const auto& slot : static_cast<const BitmapNode*>(node)->getArray()) {
+        if (std::holds_alternative<NodeBase*>(slot)) {
+            visitEntries(std::get<NodeBase*>(slot), fn);
+        } else {
+            fn(*std::get<std::shared_ptr<Entry>>(slot));
+        }
+    }
+}
+
+} // namespace
+
+void PersistentDict::forEachEntry(const std::function<void(const Entry&)>& fn) const {
+    if (root_) {
+        visitEntries(root_, fn);
+    }
+}
+
+py::dict PersistentDict::toDict() const {
+    py::dict result = pmutils::presizedDict(count_);
+    forEachEntry([&](const Entry& entry) {
+        pmutils::dictSetItemKnownHash(result, entry.key, entry.value, entry.hash);
+    });
+    return result;
+}
+
 bool PersistentDict::operator==(const PersistentDict& other) const {
     if (count_ != other.count_) {
         return false;
@@ -708,6 +1227,56 @@ std::string PersistentDict::repr() const {
     return oss.str();
 }
 
+py::dict PersistentDict::trieStats() const {
+    size_t bitmapNodes = 0;
+    size_t collisionNodes = 0;
+    size_t slots = 0;
+    size_t maxCollision = 0;
+    std::vector<size_t> levelNodes;
+    std::vector<size_t> levelEntries;
+
+    std::function<void(const NodeBase*, size_t)> walk = [&](const NodeBase* node, size_t level) {
+        if (levelNodes.size() <= level) {
+            levelNodes.resize(level + 1, 0);
+            levelEntries.resize(level + 1, 0);
+        }
+        levelNodes[level]++;
+
+        if (auto* bitmapNode = dynamic_cast<const BitmapNode*>(node)) {
+            bitmapNodes++;
+            const auto& array = bitmapNode->getArray();
+            slots += array.size();
+            for (const auto& elem : array) {
+                if (std::holds_alternative<std::shared_ptr<Entry>>(elem)) {
+                    levelEntries[level]++;
+                } else {
+                    walk(std::get<NodeBase*>(elem), level + 1);
+                }
+            }
+        } else if (auto* collisionNode = dynamic_cast<const CollisionNode*>(node)) {
+            collisionNodes++;
+            size_t n = collisionNode->getEntries().size();
+            levelEntries[level] += n;
+            maxCollision = std::max(maxCollision, n);
+        }
+    };
+
+    if (root_ != nullptr) {
+        walk(root_, 0);
+    }
+
+    py::dict stats;
+    stats["entries"] = count_;
+    stats["depth"] = levelNodes.size();
+    stats["bitmap_nodes"] = bitmapNodes;
+    stats["collision_nodes"] = collisionNodes;
+    stats["max_collision_bucket"] = maxCollision;
+    stats["avg_fanout"] = bitmapNodes ? static_cast<double>(slots) / bitmapNodes : 0.0;
+    stats["level_nodes"] = py::cast(levelNodes);
+    stats["level_entries"] = py::cast(levelEntries);
+    return stats;
+}
+
 // ============================================================================
 // Phase 2: Bottom-Up Tree Construction
 // ============================================================================
@@ -726,34 +1295,14 @@ NodeBase* PersistentDict::buildTreeBulk(std::vector<HashedEntry>& entries,
     if (count == 1) {
         auto& entry = entries[start];
         uint32_t idx = (entry.hash >> shift) & HASH_MASK;
-        uint32_t bitmap = 1 << idx;
+        bitmap_t bitmap = slotBit(idx);
 
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> array;
-        array.push_back(std::make_shared<Entry>(entry.key, entry.value));
+        NodeArray array;
+        array.push_back(makeEntry(entry.key, entry.value, entry.hash));
 
         return arena.allocate<BitmapNode>(bitmap, std::move(array));
     }
 
-    // Check if all entries have the same hash (collision case)
-    bool all_same_hash = true;
-    uint32_t first_hash = entries[start].hash;
-    for (size_t i = start + 1; i < end; ++i) {
-        if (entries[i].hash != first_hash) {
-            all_same_hash = false;
-            break;
-        }
-    }
-
-    if (all_same_hash) {
-        // Create CollisionNode
-        std::vector<Entry*> collision_entries;
-        collision_entries.reserve(count);
-        for (size_t i = start; i < end; ++i) {
-            collision_entries.push_back(new Entry(entries[i].key, entries[i].value));
-        }
-        return arena.allocate<CollisionNode>(first_hash, std::move(collision_entries));
-    }
-
     // Group entries by their hash bucket at this level
     // Buckets[i] contains entries whose (hash >> shift) & HASH_MASK == i
     std::vector<std::vector<size_t>> buckets(MAX_BITMAP_SIZE);
@@ -764,32 +1313,34 @@ NodeBase* PersistentDict::buildTreeBulk(std::vector<HashedEntry>& entries,
     }
 
     // Build bitmap and array for this node
-    uint32_t bitmap = 0;
-    std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> array;
+    bitmap_t bitmap = 0;
+    NodeArray array;
 
     for (uint32_t idx = 0; idx < MAX_BITMAP_SIZE; ++idx) {
         if (buckets[idx].empty()) {
             continue;
         }
 
-        bitmap |= (1 << idx);
+        bitmap |= slotBit(idx);
 
         if (buckets[idx].size() == 1) {
             // Single entry in this bucket - store as Entry
             size_t entry_idx = buckets[idx][0];
-            array.push_back(std::make_shared<Entry>(entries[entry_idx].key,
-                                                     entries[entry_idx].value));
+            array.push_back(makeEntry(entries[entry_idx].key,
+                                                     entries[entry_idx].value,
+                                                     entries[entry_idx].hash));
         } else {
             // Multiple entries - need to recurse deeper or create collision node
 
-            // Check if we've reached max depth (shift >= 30)
-            if (shift >= 30) {
-                // Max tree depth reached, create collision node
-                std::vector<Entry*> collision_entries;
+            // Check if the next level would run out of hash bits
+            if (shift + HASH_BITS >= MAX_TRIE_SHIFT) {
+                // Max tree depth reached, the full hashes are equal - create collision node
+                std::vector<std::shared_ptr<Entry>> collision_entries;
                 collision_entries.reserve(buckets[idx].size());
                 for (size_t entry_idx : buckets[idx]) {
-                    collision_entries.push_back(new Entry(entries[entry_idx].key,
-                                                         entries[entry_idx].value));
+                    collision_entries.push_back(makeEntry(entries[entry_idx].key,
+                                                                        entries[entry_idx].value,
+                                                                        entries[entry_idx].hash));
                 }
                 NodeBase* collision_node = arena.allocate<CollisionNode>(entries[buckets[idx][0]].hash,
                                                                           std::move(collision_entries));
@@ -810,7 +1361,7 @@ NodeBase* PersistentDict::buildTreeBulk(std::vector<HashedEntry>& entries,
                     array.push_back(child);
                 } else {
                     // Shouldn't happen, but handle gracefully
-                    bitmap &= ~(1 << idx);  // Clear bit if no child created
+                    bitmap &= ~slotBit(idx);  // Clear bit if no child created
                 }
             }
         }
@@ -849,7 +1400,7 @@ PersistentDict PersistentDict::fromDict(const py::dict& d) {
     for (auto item : d) {
         py::object key = py::reinterpret_borrow<py::object>(item.first);
         py::object val = py::reinterpret_borrow<py::object>(item.second);
-        uint32_t hash = pmutils::hashKey(key);
+        hash_t hash = pmutils::hashKey(key);
 
         entries.push_back(HashedEntry{hash, key, val});
     }
@@ -892,7 +1443,7 @@ PersistentDict PersistentDict::create(const py::kwargs& kw) {
     for (auto item : kw) {
         py::object key = py::reinterpret_borrow<py::object>(item.first);
         py::object val = py::reinterpret_borrow<py::object>(item.second);
-        uint32_t hash = pmutils::hashKey(key);
+        hash_t hash = pmutils::hashKey(key);
 
         entries.push_back(HashedEntry{hash, key, val});
     }
@@ -909,6 +1460,119 @@ PersistentDict PersistentDict::create(const py::kwargs& kw) {
     return PersistentDict(heap_root, n);
 }
 
+PersistentDict PersistentDict::fromEntries(const std::vector<std::pair<py::object, py::object>>& entries) {
+    size_t n = entries.size();
+
+    if (n == 0) {
+        return PersistentDict();
+    }
+
+    if (n < 1000) {
+        PersistentDict m;
+        for (const auto& [key, val] : entries) {
+            m = m.assoc(key, val);
+        }
+        return m;
+    }
+
+    std::vector<HashedEntry> hashed;
+    hashed.reserve(n);
+    for (const auto& [key, val] : entries) {
+        hashed.push_back(HashedEntry{pmutils::hashKey(key), key, val});
+    }
+    return fromHashedEntries(hashed);
+}
+
+PersistentDict PersistentDict::fromHashedEntries(std::vector<HashedEntry>& entries) {
+    BulkOpArena arena;
+    NodeBase* root = buildTreeBulk(entries, 0, entries.size(), 0, arena);
+    NodeBase* heap_root = root ? root->cloneToHeap() : nullptr;
+
+    return PersistentDict(heap_root, entries.size());
+}
+
+namespace {
+
+// Distinct keys in first-seen order, found by (mixed) hash and Python
+// equality. Each key is hashed once; the hash is reused for the trie.
+class KeyGroups {
+public:
+    struct Group {
+        hash_t hash;
+        py::object key;
+        size_t next;  // Next group with the same hash, or NONE
+    };
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    // Index of key's group, appending a new group for an unseen key
+    size_t indexOf(const py::object& key) {
+        hash_t hash = pmutils::hashKey(key);
+        auto [it, inserted] = heads_.try_emplace(hash, groups_.size());
+        if (!inserted) {
+            for (size_t i = it->second; i != NONE; i = groups_[i].next) {
+                if (pmutils::keysEqual(groups_[i].key, key)) {
+                    return i;
+                }
+            }
+            groups_.push_back(Group{hash, key, it->second});
+            it->second = groups_.size() - 1;
+            return it->second;
+        }
+        groups_.push_back(Group{hash, key, NONE});
+        return groups_.size() - 1;
+    }
+
+    const std::vector<Group>& groups() const { return groups_; }
+
+private:
+    std::unordered_map<hash_t, size_t> heads_;
+    std::vector<Group> groups_;
+};
+
+} // namespace
+
+PersistentDict PersistentDict::groupBy(const py::object& iterable, const py::object& keyfn) {
+    KeyGroups index;
+    std::vector<std::vector<py::object>> members;
+    for (auto item : py::iter(iterable)) {
+        py::object value = py::reinterpret_borrow<py::object>(item);
+        size_t i = index.indexOf(keyfn(value));
+        if (i == members.size()) {
+            members.emplace_back();
+        }
+        members[i].push_back(std::move(value));
+    }
+
+    std::vector<HashedEntry> entries;
+    entries.reserve(members.size());
+    for (size_t i = 0; i < members.size(); ++i) {
+        const auto& group = index.groups()[i];
+        entries.push_back(HashedEntry{group.hash, group.key,
+                                      py::cast(PersistentList::fromVector(std::move(members[i])))});
+    }
+    return fromHashedEntries(entries);
+}
+
+PersistentDict PersistentDict::frequencies(const py::object& iterable) {
+    KeyGroups index;
+    std::vector<size_t> counts;
+    for (auto item : py::iter(iterable)) {
+        size_t i = index.indexOf(py::reinterpret_borrow<py::object>(item));
+        if (i == counts.size()) {
+            counts.push_back(0);
+        }
+        ++counts[i];
+    }
+
+    std::vector<HashedEntry> entries;
+    entries.reserve(counts.size());
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const auto& group = index.groups()[i];
+        entries.push_back(HashedEntry{group.hash, group.key, py::int_(counts[i])});
+    }
+    return fromHashedEntries(entries);
+}
+
 PersistentDict PersistentDict::update(const py::object& other) const {
     PersistentDict result = *this;
 
@@ -979,13 +1643,218 @@ PersistentDict PersistentDict::update(const py::object& other) const {
     return result;
 }
 
+PersistentDict PersistentDict::mergeWith(const PersistentDict& other, const MergeFn& fn) const {
+    if (other.root_ == nullptr) {
+        return *this;
+    }
+    if (root_ == nullptr) {
+        return other;
+    }
+
+    if (other.count_ < 100) {
+        // Small right side: one alter per key
+        PersistentDict result = *this;
+        other.root_->iterate([&](const py::object& k, const py::object& v) {
+            result = result.alter(k, [&](const py::object& old) -> py::object {
+                return old ? fn(old, v) : v;
+            });
+        });
+        return result;
+    }
+
+    NodeBase* merged = mergeNodes(root_, other.root_, 0, &fn);
+    size_t actual_count = 0;
+    merged->iterate([&](const py::object&, const py::object&) {
+        actual_count++;
+    });
+    return PersistentDict(merged, actual_count);
+}
+
+PersistentDict PersistentDict::mapValues(const MapFn& fn) const {
+    if (root_ == nullptr) {
+        return *this;
+    }
+    NodeBase* newRoot = root_->mapValues(fn);
+    if (newRoot == root_) {
+        return *this;
+    }
+    return PersistentDict(newRoot, count_);
+}
+
+PersistentDict PersistentDict::filter(const EntryPredicate& pred) const {
+    if (root_ == nullptr) {
+        return *this;
+    }
+    size_t removed = 0;
+    NodeBase* newRoot = root_->filter(pred, removed);
+    if (newRoot == root_) {
+        return *this;
+    }
+    if (newRoot == nullptr) {
+        return PersistentDict();
+    }
+    return PersistentDict(newRoot, count_ - removed);
+}
+
+namespace {
+
+size_t countEntries(const NodeBase* node) {
+    if (auto* collisionNode = dynamic_cast<const CollisionNode*>(node)) {
+        return collisionNode->getEntries().size();
+    }
+    size_t count = 0;
+    for (const auto& slot : static_cast<const BitmapNode*>(node)->getArray()) {
+        count += std::holds_alternative<NodeBase*>(slot)
+                     ? countEntries(std::get<NodeBase*>(slot)) : 1;
+    }
+    return count;
+}
+
+// A trie slot taken whole into one partition, with the bit index at each
+// level on the way down to it
+struct SplitUnit {
+    std::vector<uint32_t> path;
+    Slot slot;
+    size_t count;
+};
+
+// Slots in trie order, expanded until none is large enough to unbalance a
+// part, then grouped into k contiguous runs of roughly equal entry counts.
+// Returns the end of each run in units.
+std::vector<size_t> planSplit(const NodeBase* root, size_t total, size_t k,
+                              std::vector<SplitUnit>& units) {
+    if (k == 0) {
+        throw std::invalid_argument("split count must be at least 1");
+    }
+    if (root) {
+        units.push_back({{}, const_cast<NodeBase*>(root), total});
+    }
+    size_t threshold = std::max<size_t>(1, total / (8 * k));
+    bool expanded = true;
+    while (expanded) {
+        expanded = false;
+        std::vector<SplitUnit> next;
+        next.reserve(units.size());
+        for (SplitUnit& unit : units) {
+            auto* node = std::holds_alternative<NodeBase*>(unit.slot)
+                             ? dynamic_cast<BitmapNode*>(std::get<NodeBase*>(unit.slot)) : nullptr;
+            if (!node || (unit.count <= threshold && !unit.path.empty())) {
+                next.push_back(std::move(unit));
+                continue;
+            }
+            expanded = true;
+            const NodeArray& array = node->getArray();
+            bitmap_t bitmap = node->getBitmap();
+            size_t i = 0;
+            for (uint32_t bit = 0; bit < MAX_BITMAP_SIZE; ++bit) {
+                if (!(bitmap & slotBit(bit))) continue;
+                const Slot& slot = array[i++];
+                SplitUnit child{unit.path, slot, 1};
+                child.path.push_back(bit);
+                if (std::holds_alternative<NodeBase*>(slot)) {
+                    child.count = countEntries(std::get<NodeBase*>(slot));
+                }
+                next.push_back(std::move(child));
+            }
+        }
+        units = std::move(next);
+    }
+
+    // Close a run once adding the next unit would overshoot the fair share
+    // of what is left by more than half that unit
+    std::vector<size_t> ends(k);
+    size_t remaining = total;
+    size_t pos = 0;
+    for (size_t part = 0; part < k; ++part) {
+        if (part == k - 1) {
+            ends[part] = units.size();
+            break;
+        }
+        size_t target = remaining / (k - part);
+        size_t taken = 0;
+        while (pos < units.size() && (taken == 0 || taken + units[pos].count / 2 <= target)) {
+            taken += units[pos++].count;
+        }
+        ends[part] = pos;
+        remaining -= taken;
+    }
+    return ends;
+}
+
+// Rebuilds the spine above units[begin, end), which share path[0, depth).
+// Lone entries are lifted to the shallowest level their group reaches.
+NodeBase* buildSplitNode(const std::vector<SplitUnit>& units, size_t begin, size_t end,
+                         size_t depth) {
+    PendingSlots pending;
+    bitmap_t bitmap = 0;
+    size_t i = begin;
+    while (i < end) {
+        uint32_t bit = units[i].path[depth];
+        size_t j = i + 1;
+        while (j < end && units[j].path[depth] == bit) {
+            ++j;
+        }
+        if (j == i + 1 && (units[i].path.size() == depth + 1 ||
+                           std::holds_alternative<std::shared_ptr<Entry>>(units[i].slot))) {
+            pending.push(units[i].slot);
+        } else {
+            pending.push(buildSplitNode(units, i, j, depth + 1));
+        }
+        bitmap |= slotBit(bit);
+        i = j;
+    }
+    return pending.build(bitmap);
+}
+
+} // namespace
+
+std::vector<PersistentDict> PersistentDict::split(size_t k) const {
+    std::vector<SplitUnit> units;
+    std::vector<size_t> ends = planSplit(root_, count_, k, units);
+    std::vector<PersistentDict> parts;
+    parts.reserve(k);
+    size_t begin = 0;
+    for (size_t end : ends) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            count += units[i].count;
+        }
+        if (count == count_) {
+            parts.push_back(*this);
+        } else if (count == 0) {
+            parts.emplace_back();
+        } else {
+            parts.emplace_back(buildSplitNode(units, begin, end, 0), count);
+        }
+        begin = end;
+    }
+    return parts;
+}
+
+std::vector<size_t> PersistentDict::partitionSizes(size_t k) const {
+    std::vector<SplitUnit> units;
+    std::vector<size_t> ends = planSplit(root_, count_, k, units);
+    std::vector<size_t> sizes;
+    sizes.reserve(k);
+    size_t begin = 0;
+    for (size_t end : ends) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            count += units[i].count;
+        }
+        sizes.push_back(count);
+        begin = end;
+    }
+    return sizes;
+}
+
 // ============================================================================
 // Phase 3: Arena-to-Heap Node Transfer (cloneToHeap implementations)
 // ============================================================================
 
 NodeBase* BitmapNode::cloneToHeap() const {
     // Clone the array, recursively cloning any child nodes
-    std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> new_array;
+    NodeArray new_array;
     new_array.reserve(array_.size());
 
     for (const auto& elem : array_) {
@@ -1006,10 +1875,9 @@ NodeBase* BitmapNode::cloneToHeap() const {
 }
 
 NodeBase* CollisionNode::cloneToHeap() const {
-    // Clone the entries vector (Entry* are already heap-allocated)
-    // Note: entries_ is a shared_ptr, so we can just copy it
-    // The shared_ptr will keep the vector alive
-    return new CollisionNode(hash_, entries_);
+    // Entries are heap-allocated shared_ptrs, only the vector is copied
+    std::vector<std::shared_ptr<Entry>> entries = entries_;
+    return new CollisionNode(hash_, std::move(entries), sorted_);
 }
 
 // ============================================================================
@@ -1031,7 +1899,8 @@ NodeBase* CollisionNode::cloneToHeap() const {
  *
  * Performance: O(n + m) instead of O(n * log m)
  */
-NodeBase* PersistentDict::mergeNodes(NodeBase* left, NodeBase* right, uint32_t shift) {
+NodeBase* PersistentDict::mergeNodes(NodeBase* left, NodeBase* right, uint32_t shift,
+                                     const MergeFn* combine) {
     // Handle null cases
     if (!left) {
         // Return right without addRef - caller will handle ownership
@@ -1042,6 +1911,33 @@ NodeBase* PersistentDict::mergeNodes(NodeBase* left, NodeBase* right, uint32_t s
         return left;
     }
 
+    // Value for a key present on both sides
+    auto resolve = [combine](const py::object& l, const py::object& r) -> py::object {
+        return combine ? (*combine)(l, r) : r;
+    };
+
+    // Fold entries into a node via alter. Intermediate nodes created here are
+    // never shared, so they are deleted as soon as they are superseded.
+    auto foldInto = [&](NodeBase* base, uint32_t foldShift,
+                        const std::vector<std::shared_ptr<Entry>>& entries,
+                        bool entriesOnLeft) -> NodeBase* {
+        NodeBase* result = base;
+        for (const auto& entry : entries) {
+            const py::object& v = entry->value;
+            int delta = 0;
+            NodeBase* next = result->alter(foldShift, entry->hash, entry->key,
+                [&](const py::object& old) -> py::object {
+                    if (!old) return v;
+                    return entriesOnLeft ? resolve(v, old) : resolve(old, v);
+                }, delta);
+            if (next != result && result != base) {
+                delete result;
+            }
+            result = next;
+        }
+        return result;
+    };
+
     // Both nodes exist - determine types and merge appropriately
     BitmapNode* leftBitmap = dynamic_cast<BitmapNode*>(left);
     BitmapNode* rightBitmap = dynamic_cast<BitmapNode*>(right);
@@ -1050,22 +1946,22 @@ NodeBase* PersistentDict::mergeNodes(NodeBase* left, NodeBase* right, uint32_t s
 
     // Case 1: BitmapNode + BitmapNode (most common)
     if (leftBitmap && rightBitmap) {
-        uint32_t leftBmp = leftBitmap->getBitmap();
-        uint32_t rightBmp = rightBitmap->getBitmap();
-        uint32_t combinedBmp = leftBmp | rightBmp;  // Union of bitmaps
+        bitmap_t leftBmp = leftBitmap->getBitmap();
+        bitmap_t rightBmp = rightBitmap->getBitmap();
+        bitmap_t combinedBmp = leftBmp | rightBmp;  // Union of bitmaps
 
         const auto& leftArray = leftBitmap->getArray();
         const auto& rightArray = rightBitmap->getArray();
 
-        std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> newArray;
+        NodeArray newArray;
         newArray.reserve(popcount(combinedBmp));
 
         uint32_t leftIdx = 0;
         uint32_t rightIdx = 0;
 
-        // Iterate through all possible slots (32 max)
+        // Iterate through all possible slots (MAX_BITMAP_SIZE max)
         for (uint32_t bit = 0; bit < MAX_BITMAP_SIZE; ++bit) {
-            uint32_t mask = 1u << bit;
+            bitmap_t mask = slotBit(bit);
 
             if (combinedBmp & mask) {
                 bool inLeft = (leftBmp & mask) != 0;
@@ -1075,28 +1971,50 @@ NodeBase* PersistentDict::mergeNodes(NodeBase* left, NodeBase* right, uint32_t s
                     // Both trees have this slot - need to merge
                     const auto& leftElem = leftArray[leftIdx];
                     const auto& rightElem = rightArray[rightIdx];
-
-                    if (std::holds_alternative<std::shared_ptr<Entry>>(leftElem) &&
-                        std::holds_alternative<std::shared_ptr<Entry>>(rightElem)) {
-                        // Both are entries - right wins (overwrite semantics)
-                        newArray.push_back(rightElem);
-                    } else if (std::holds_alternative<NodeBase*>(leftElem) &&
-                               std::holds_alternative<NodeBase*>(rightElem)) {
+                    bool leftIsEntry = std::holds_alternative<std::shared_ptr<Entry>>(leftElem);
+                    bool rightIsEntry = std::holds_alternative<std::shared_ptr<Entry>>(rightElem);
+
+                    if (leftIsEntry && rightIsEntry) {
+                        const auto& leftEntry = std::get<std::shared_ptr<Entry>>(leftElem);
+                        const auto& rightEntry = std::get<std::shared_ptr<Entry>>(rightElem);
+
+                        if (leftEntry->hash == rightEntry->hash &&
+                            pmutils::keysEqual(leftEntry->key, rightEntry->key)) {
+                            if (combine) {
+                                newArray.push_back(makeEntry(
+                                    leftEntry->key, (*combine)(leftEntry->value, rightEntry->value),
+                                    leftEntry->hash));
+                            } else {
+                                // Right wins (overwrite semantics)
+                                newArray.push_back(rightElem);
+                            }
+                        } else {
+                            // Different keys sharing a slot - push both down a level
+                            NodeBase* child = BitmapNode::createNode(shift + HASH_BITS, leftEntry, rightEntry);
+                            child->addRef();
+                            newArray.push_back(child);
+                        }
+                    } else if (!leftIsEntry && !rightIsEntry) {
                         // Both are nodes - recursively merge
                         NodeBase* leftChild = std::get<NodeBase*>(leftElem);
                         NodeBase* rightChild = std::get<NodeBase*>(rightElem);
-                        NodeBase* merged = mergeNodes(leftChild, rightChild, shift + HASH_BITS);
+                        NodeBase* merged = mergeNodes(leftChild, rightChild, shift + HASH_BITS, combine);
                         newArray.push_back(merged);
                         merged->addRef();  // Must increment refcount for array ownership
+                    } else if (leftIsEntry) {
+                        // Entry on the left, subtree on the right - insert the entry into it
+                        const auto& leftEntry = std::get<std::shared_ptr<Entry>>(leftElem);
+                        NodeBase* merged = foldInto(std::get<NodeBase*>(rightElem), shift + HASH_BITS,
+                                                    {leftEntry}, true);
+                        merged->addRef();
+                        newArray.push_back(merged);
                     } else {
-                        // Mixed entry/node - right wins
-                        if (std::holds_alternative<std::shared_ptr<Entry>>(rightElem)) {
-                            newArray.push_back(rightElem);
-                        } else {
-                            NodeBase* node = std::get<NodeBase*>(rightElem);
-                            node->addRef();
-                            newArray.push_back(node);
-                        }
+                        // Subtree on the left, entry on the right
+                        const auto& rightEntry = std::get<std::shared_ptr<Entry>>(rightElem);
+                        NodeBase* merged = foldInto(std::get<NodeBase*>(leftElem), shift + HASH_BITS,
+                                                    {rightEntry}, false);
+                        merged->addRef();
+                        newArray.push_back(merged);
                     }
 
                     leftIdx++;
@@ -1130,67 +2048,10 @@ NodeBase* PersistentDict::mergeNodes(NodeBase* left, NodeBase* right, uint32_t s
         return new BitmapNode(combinedBmp, std::move(newArray));
     }
 
-    // Case 2: CollisionNode + CollisionNode
-    if (leftCollision && rightCollision) {
-        // Both are collision nodes - merge entry lists
-        // Right entries overwrite left entries with same key
-        std::vector<Entry*> mergedEntries;
-        const auto& leftEntries = leftCollision->getEntries();
-        const auto& rightEntries = rightCollision->getEntries();
-
-        // Start with left entries
-        for (Entry* leftEntry : leftEntries) {
-            bool overwritten = false;
-            // Check if right has same key
-            for (Entry* rightEntry : rightEntries) {
-                if (pmutils::keysEqual(leftEntry->key, rightEntry->key)) {
-                    overwritten = true;
-                    break;
-                }
-            }
-            if (!overwritten) {
-                mergedEntries.push_back(new Entry(leftEntry->key, leftEntry->value));
-            }
-        }
-
-        // Add all right entries (they override)
-        for (Entry* rightEntry : rightEntries) {
-            mergedEntries.push_back(new Entry(rightEntry->key, rightEntry->value));
-        }
-
-        return new CollisionNode(leftCollision->getHash(), std::move(mergedEntries));
+    // Case 2 and 3: at least one CollisionNode (rare) - fold the collision
+    // node's entries into the other side one key at a time
+    if (rightCollision) {
+        return foldInto(left, shift, rightCollision->getEntries(), false);
     }
-
-    // Case 3: Mixed BitmapNode + CollisionNode
-    // Fall back to iterative assoc for mixed cases (rare)
-    if (leftCollision || rightCollision) {
-        // Use assoc to add entries from one into the other
-        // This is a rare case, so performance impact is minimal
-        NodeBase* result = left;
-        result->addRef();
-
-        if (rightBitmap) {
-            // Right is bitmap, left is collision - add collision entries
-            leftCollision->iterate([&](const py::object& k, const py::object& v) {
-                uint32_t hash = pmutils::hashKey(k);
-                NodeBase* newResult = result->assoc(0, hash, k, v);
-                result->release();
-                result = newResult;
-            });
-        } else if (rightCollision) {
-            // Right is collision - add its entries
-            rightCollision->iterate([&](const py::object& k, const py::object& v) {
-                uint32_t hash = pmutils::hashKey(k);
-                NodeBase* newResult = result->assoc(0, hash, k, v);
-                result->release();
-                result = newResult;
-            });
-        }
-
-        return result;
-    }
-
-    // Should never reach here
-    left->addRef();
-    return left;
+    return foldInto(right, shift, leftCollision->getEntries(), true);
 }
@@ -10,13 +10,37 @@
 #include <cstdint>
 #include <string>
 #include "arena_allocator.hpp"
+#include "tracked_alloc.hpp"
 
 namespace py = pybind11;
 
 // Constants for HAMT structure
-constexpr uint32_t HASH_BITS = 5;
-constexpr uint32_t HASH_MASK = (1 << HASH_BITS) - 1;  // 0b11111
-constexpr uint32_t MAX_BITMAP_SIZE = 1 << HASH_BITS;  // 32
+//
+// Bits of hash consumed per trie level, fixed at compile time with
+// -DPYPERSISTENT_HAMT_BITS=4|5|6 (16-, 32- or 64-way nodes). Wider nodes
+// make the trie shallower (faster lookups) but copy more slots on every
+// update; 5 is the default.
+#ifndef PYPERSISTENT_HAMT_BITS
+#define PYPERSISTENT_HAMT_BITS 5
+#endif
+static_assert(PYPERSISTENT_HAMT_BITS >= 4 && PYPERSISTENT_HAMT_BITS <= 6,
+              "PYPERSISTENT_HAMT_BITS must be 4, 5 or 6");
+
+// One bit per slot: 64-way nodes need a 64-bit bitmap
+#if PYPERSISTENT_HAMT_BITS == 6
+using bitmap_t = uint64_t;
+#else
+using bitmap_t = uint32_t;
+#endif
+
+constexpr uint32_t HASH_BITS = PYPERSISTENT_HAMT_BITS;
+constexpr uint32_t HASH_MASK = (1 << HASH_BITS) - 1;  // 0b11111 by default
+constexpr uint32_t MAX_BITMAP_SIZE = 1 << HASH_BITS;  // 32 by default
+
+// Bitmap with only the given slot set
+inline bitmap_t slotBit(uint32_t idx) {
+    return bitmap_t(1) << idx;
+}
 
 // Forward declarations
 class BitmapNode;
@@ -28,12 +52,19 @@ class CollisionNode;
     inline uint32_t popcount(uint32_t x) {
         return __builtin_popcount(x);
     }
+    inline uint32_t popcount(uint64_t x) {
+        return __builtin_popcountll(x);
+    }
 #elif defined(_MSC_VER)
     // MSVC intrinsic
     #include <intrin.h>
     inline uint32_t popcount(uint32_t x) {
         return __popcnt(x);
     }
+    inline uint32_t popcount(uint64_t x) {
+        return static_cast<uint32_t>(__popcnt(static_cast<uint32_t>(x)) +
+                                     __popcnt(static_cast<uint32_t>(x >> 32)));
+    }
 #else
     // Fallback implementation
     inline uint32_t popcount(uint32_t x) {
@@ -41,17 +72,100 @@ class CollisionNode;
         x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
         return (((x + (x >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
     }
+    inline uint32_t popcount(uint64_t x) {
+        return popcount(static_cast<uint32_t>(x)) + popcount(static_cast<uint32_t>(x >> 32));
+    }
 #endif
 
+// Trie hash: Python's full 64-bit hash after mixing. The trie consumes
+// HASH_BITS per level for as long as bits remain, so CollisionNodes only
+// hold keys whose Python hashes are identical.
+using hash_t = uint64_t;
+
+// Depth at which hash bits run out and CollisionNodes take over
+constexpr uint32_t MAX_TRIE_SHIFT = 64;
+
 // Python utility functions
 namespace pmutils {
-    inline uint32_t hashKey(const py::object& key) {
+    // Optional per-process seed mixed into trie hashing, read once from the
+    // PYPERSISTENT_HASH_SEED environment variable ("random" draws one).
+    // 0 means unseeded.
+    extern const uint64_t HASH_SEED;
+
+    // MurmurHash3 64-bit finalizer (bijective, full avalanche)
+    inline uint64_t fmix64(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Python hashes are poorly distributed for trie indexing (ints hash to
+    // themselves, small-int tuples share low bits), so every hash is
+    // avalanched before its bits pick trie slots. Being a bijection, the
+    // finalizer never introduces new full-hash collisions.
+    inline hash_t mixHash(Py_hash_t h) {
+        return fmix64(static_cast<uint64_t>(h) ^ HASH_SEED);
+    }
+
+    // Inverse of fmix64 (inverse multipliers mod 2^64)
+    inline uint64_t fmix64Inverse(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0x9cb4b2f8129337dbULL;
+        x ^= x >> 33;
+        x *= 0x4f74430c22a54005ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // Python hash of a key recovered from its trie hash, without __hash__
+    inline Py_hash_t pythonHash(hash_t hash) {
+        return static_cast<Py_hash_t>(fmix64Inverse(hash) ^ HASH_SEED);
+    }
+
+    // Empty dict with room for n items. _PyDict_NewPresized and
+    // _PyDict_SetItem_KnownHash are private CPython API, so they are only
+    // used on versions before 3.13; newer versions take the public calls.
+    inline py::dict presizedDict(size_t n) {
+#if PY_VERSION_HEX < 0x030D0000
+        PyObject* dict = _PyDict_NewPresized(static_cast<Py_ssize_t>(n));
+#else
+        (void)n;
+        PyObject* dict = PyDict_New();
+#endif
+        if (!dict) {
+            throw py::error_already_set();
+        }
+        return py::reinterpret_steal<py::dict>(dict);
+    }
+
+    inline void dictSetItem(const py::dict& dict, const py::object& key, const py::object& value) {
+        if (PyDict_SetItem(dict.ptr(), key.ptr(), value.ptr()) < 0) {
+            throw py::error_already_set();
+        }
+    }
+
+    // Insert reusing the key's trie hash instead of calling __hash__
+    inline void dictSetItemKnownHash(const py::dict& dict, const py::object& key,
+                                     const py::object& value, hash_t hash) {
+#if PY_VERSION_HEX < 0x030D0000
+        if (_PyDict_SetItem_KnownHash(dict.ptr(), key.ptr(), value.ptr(), pythonHash(hash)) < 0) {
+            throw py::error_already_set();
+        }
+#else
+        (void)hash;
+        dictSetItem(dict, key, value);
+#endif
+    }
+
+    inline hash_t hashKey(const py::object& key) {
         Py_hash_t h = PyObject_Hash(key.ptr());
         if (h == -1) {
             throw py::error_already_set();
         }
-        // Convert to positive uint32
-        return static_cast<uint32_t>(h >= 0 ? h : -h);
+        return mixHash(h);
     }
 
     inline bool keysEqual(const py::object& k1, const py::object& k2) {
@@ -65,18 +179,67 @@ namespace pmutils {
         }
         return result == 1;
     }
+
+    // Python truthiness of a callback result
+    inline bool truthy(const py::object& obj) {
+        int result = PyObject_IsTrue(obj.ptr());
+        if (result == -1) {
+            throw py::error_already_set();
+        }
+        return result == 1;
+    }
+
+    // Py_EnterRecursiveCall scope for native recursion over user data, so
+    // hostile nesting raises RecursionError instead of overflowing the C stack
+    class RecursionGuard {
+    public:
+        explicit RecursionGuard(const char* where) {
+            if (Py_EnterRecursiveCall(where)) {
+                throw py::error_already_set();
+            }
+        }
+        ~RecursionGuard() { Py_LeaveRecursiveCall(); }
+
+        RecursionGuard(const RecursionGuard&) = delete;
+        RecursionGuard& operator=(const RecursionGuard&) = delete;
+    };
 }
 
+// Read-modify-write callback for single-descent updates (see PersistentDict::alter).
+// Receives the current value, or a null py::object when the key is absent, and
+// returns the new value, or a null py::object to remove the key.
+using AlterFn = std::function<py::object(const py::object&)>;
+
+// Combines the values of a key present on both sides of a merge (left, right).
+using MergeFn = std::function<py::object(const py::object&, const py::object&)>;
+
+// Replaces each value in a shape-preserving transform (see PersistentDict::mapValues).
+// Returning the same object keeps the entry, and unchanged subtrees, shared.
+using MapFn = std::function<py::object(const py::object&)>;
+
+// Decides whether an entry (key, value) survives PersistentDict::filter.
+using EntryPredicate = std::function<bool(const py::object&, const py::object&)>;
+
 // Entry structure for key-value pairs
 struct Entry {
     py::object key;
     py::object value;
+    hash_t hash;  // Trie hash of key - compared before calling __eq__
 
-    Entry(const py::object& k, const py::object& v) : key(k), value(v) {}
+    Entry(const py::object& k, const py::object& v, hash_t h) : key(k), value(v), hash(h) {}
+
+    // For containers that scan by equality and never consult hash (ArrayMap)
+    Entry(const py::object& k, const py::object& v) : key(k), value(v), hash(0) {}
 };
 
+// Entries are allocated with their shared_ptr control block, reported to tracemalloc
+inline std::shared_ptr<Entry> makeEntry(const py::object& k, const py::object& v, hash_t h) {
+    return std::allocate_shared<Entry>(
+        pmalloc::TrackedAllocator<Entry, pmalloc::DOMAIN_DICT>(), k, v, h);
+}
+
 // Abstract base class for all node types with intrusive reference counting
-class NodeBase {
+class NodeBase : public pmalloc::Tracked<pmalloc::DOMAIN_DICT> {
 protected:
     mutable std::atomic<uint32_t> refcount_;
 
@@ -101,37 +264,58 @@ public:
     }
 
     // Pure virtual methods that all nodes must implement
-    virtual py::object get(uint32_t shift, uint32_t hash,
+    virtual py::object get(uint32_t shift, hash_t hash,
                           const py::object& key, const py::object& notFound) const = 0;
 
-    virtual NodeBase* assoc(uint32_t shift, uint32_t hash,
+    virtual NodeBase* assoc(uint32_t shift, hash_t hash,
                            const py::object& key, const py::object& val) const = 0;
 
-    virtual NodeBase* dissoc(uint32_t shift, uint32_t hash,
+    virtual NodeBase* dissoc(uint32_t shift, hash_t hash,
                             const py::object& key) const = 0;
 
+    // Single-descent read-modify-write. delta receives +1 if an entry was
+    // added, -1 if one was removed, 0 otherwise. Returns this if unchanged,
+    // nullptr if the node became empty.
+    virtual NodeBase* alter(uint32_t shift, hash_t hash, const py::object& key,
+                            const AlterFn& fn, int& delta) const = 0;
+
     virtual void iterate(const std::function<void(const py::object&, const py::object&)>& callback) const = 0;
 
+    // Bulk transforms that keep keys, hashes and bitmaps. Both return this
+    // if nothing changed; filter returns nullptr if no entry survived and
+    // adds the number of dropped entries to removed.
+    virtual NodeBase* mapValues(const MapFn& fn) const = 0;
+    virtual NodeBase* filter(const EntryPredicate& pred, size_t& removed) const = 0;
+
     // Clone node from arena to heap (deep copy for Phase 3 arena allocator)
     virtual NodeBase* cloneToHeap() const = 0;
 };
 
+// Slot array of a BitmapNode: shared_ptr<Entry> OR NodeBase*
+using NodeArray = std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>,
+                              pmalloc::TrackedAllocator<std::variant<std::shared_ptr<Entry>, NodeBase*>,
+                                                        pmalloc::DOMAIN_DICT>>;
+
 // BitmapNode: Main HAMT node using bitmap indexing
 class BitmapNode : public NodeBase {
 private:
-    uint32_t bitmap_;
-    std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>> array_;  // shared_ptr<Entry> OR NodeBase*
+    bitmap_t bitmap_;
+    NodeArray array_;  // shared_ptr<Entry> OR NodeBase*
 
-    // Helper to create a new node with two key-value pairs
-    NodeBase* createNode(uint32_t shift,
-                        const py::object& key1, const py::object& val1,
-                        uint32_t hash2, const py::object& key2, const py::object& val2) const;
+    // Copy-on-write helpers: return a new node sharing every other slot
+    NodeBase* replaceSlot(uint32_t idx, const std::variant<std::shared_ptr<Entry>, NodeBase*>& slot) const;
+    NodeBase* insertSlot(uint32_t idx, bitmap_t bit_pos, const std::variant<std::shared_ptr<Entry>, NodeBase*>& slot) const;
+    NodeBase* removeSlot(uint32_t idx, bitmap_t bit_pos) const;
 
 public:
-    BitmapNode(uint32_t bitmap, const std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>>& array)
+    // Helper to create a new node holding an existing entry and a new entry
+    static NodeBase* createNode(uint32_t shift, const std::shared_ptr<Entry>& existing,
+                                const std::shared_ptr<Entry>& added);
+
+    BitmapNode(bitmap_t bitmap, const NodeArray& array)
         : bitmap_(bitmap), array_(array) {}
 
-    BitmapNode(uint32_t bitmap, std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>>&& array)
+    BitmapNode(bitmap_t bitmap, NodeArray&& array)
         : bitmap_(bitmap), array_(std::move(array)) {}
 
     ~BitmapNode() override {
@@ -145,64 +329,96 @@ public:
     }
 
     // Implement virtual methods
-    py::object get(uint32_t shift, uint32_t hash,
+    py::object get(uint32_t shift, hash_t hash,
                   const py::object& key, const py::object& notFound) const override;
 
-    NodeBase* assoc(uint32_t shift, uint32_t hash,
+    NodeBase* assoc(uint32_t shift, hash_t hash,
                    const py::object& key, const py::object& val) const override;
 
-    NodeBase* dissoc(uint32_t shift, uint32_t hash,
+    NodeBase* dissoc(uint32_t shift, hash_t hash,
                     const py::object& key) const override;
 
+    NodeBase* alter(uint32_t shift, hash_t hash, const py::object& key,
+                    const AlterFn& fn, int& delta) const override;
+
     void iterate(const std::function<void(const py::object&, const py::object&)>& callback) const override;
 
+    NodeBase* mapValues(const MapFn& fn) const override;
+    NodeBase* filter(const EntryPredicate& pred, size_t& removed) const override;
+
     NodeBase* cloneToHeap() const override;
 
-    uint32_t getBitmap() const { return bitmap_; }
-    const std::vector<std::variant<std::shared_ptr<Entry>, NodeBase*>>& getArray() const { return array_; }
+    bitmap_t getBitmap() const { return bitmap_; }
+    const NodeArray& getArray() const { return array_; }
 };
 
-// CollisionNode: Handles hash collisions when multiple keys have the same hash
+// Slot of node at the position of bit (one bit set, see slotBit()), or null
+// if node is null or has no slot there. Used to pair the slots of two
+// versions of the same trie position.
+inline const NodeArray::value_type* slotAt(const BitmapNode* node, bitmap_t bit) {
+    if (!node || !(node->getBitmap() & bit)) return nullptr;
+    return &node->getArray()[popcount(node->getBitmap() & (bit - 1))];
+}
+
+// CollisionNode: Handles keys whose (full 64-bit) hashes are identical
+//
+// Lives below the last trie level, so every entry has the same hash. Small
+// buckets are scanned linearly. Buckets of COLLISION_SORT_THRESHOLD or more
+// keys that are all exact int, str or bytes (types whose ordering agrees
+// with equality) are kept sorted and searched by bisection, so a flood of
+// colliding keys costs O(log n) comparisons instead of O(n).
 class CollisionNode : public NodeBase {
 private:
-    uint32_t hash_;
-    std::shared_ptr<std::vector<Entry*>> entries_;
+    hash_t hash_;
+    std::vector<std::shared_ptr<Entry>> entries_;
+    bool sorted_;  // entries_ ordered by key, all keys share one exact type
 
-public:
-    CollisionNode(uint32_t hash, const std::vector<Entry*>& entries)
-        : hash_(hash), entries_(std::make_shared<std::vector<Entry*>>(entries)) {}
+    CollisionNode(hash_t hash, std::vector<std::shared_ptr<Entry>>&& entries, bool sorted)
+        : hash_(hash), entries_(std::move(entries)), sorted_(sorted) {}
 
-    CollisionNode(uint32_t hash, std::vector<Entry*>&& entries)
-        : hash_(hash), entries_(std::make_shared<std::vector<Entry*>>(std::move(entries))) {}
+    // Index of key in entries_, or entries_.size() if absent
+    size_t find(const py::object& key) const;
 
-    CollisionNode(uint32_t hash, std::shared_ptr<std::vector<Entry*>> entries)
-        : hash_(hash), entries_(entries) {}
+    // Position where key would be inserted to keep a sorted bucket sorted
+    size_t lowerBound(const py::object& key) const;
 
-    ~CollisionNode() override {
-        // Only delete entries if we're the last owner
-        if (entries_.use_count() == 1) {
-            for (Entry* entry : *entries_) {
-                delete entry;
-            }
-        }
-    }
+    // Can key be located by bisection in this bucket?
+    bool bisectable(const py::object& key) const;
+
+    // New node with entry inserted (keeps or establishes sorted order)
+    NodeBase* withAdded(const std::shared_ptr<Entry>& entry) const;
+    NodeBase* withReplaced(size_t idx, const std::shared_ptr<Entry>& entry) const;
+    NodeBase* withRemoved(size_t idx) const;
+
+public:
+    static constexpr size_t COLLISION_SORT_THRESHOLD = 8;
+
+    // Builds a node from arbitrary entries, sorting if the bucket qualifies
+    CollisionNode(hash_t hash, std::vector<std::shared_ptr<Entry>>&& entries);
 
     // Implement virtual methods
-    py::object get(uint32_t shift, uint32_t hash,
+    py::object get(uint32_t shift, hash_t hash,
                   const py::object& key, const py::object& notFound) const override;
 
-    NodeBase* assoc(uint32_t shift, uint32_t hash,
+    NodeBase* assoc(uint32_t shift, hash_t hash,
                    const py::object& key, const py::object& val) const override;
 
-    NodeBase* dissoc(uint32_t shift, uint32_t hash,
+    NodeBase* dissoc(uint32_t shift, hash_t hash,
                     const py::object& key) const override;
 
+    NodeBase* alter(uint32_t shift, hash_t hash, const py::object& key,
+                    const AlterFn& fn, int& delta) const override;
+
     void iterate(const std::function<void(const py::object&, const py::object&)>& callback) const override;
 
+    NodeBase* mapValues(const MapFn& fn) const override;
+    NodeBase* filter(const EntryPredicate& pred, size_t& removed) const override;
+
     NodeBase* cloneToHeap() const override;
 
-    uint32_t getHash() const { return hash_; }
-    const std::vector<Entry*>& getEntries() const { return *entries_; }
+    hash_t getHash() const { return hash_; }
+    bool isSorted() const { return sorted_; }
+    const std::vector<std::shared_ptr<Entry>>& getEntries() const { return entries_; }
 };
 
 // Forward declaration
@@ -246,6 +462,7 @@ private:
     MapIterator iter_;
 public:
     KeyIterator(const NodeBase* root) : iter_(root) {}
+    bool hasNext() const { return iter_.hasNext(); }
     py::object next() {
         auto pair = iter_.next();
         return pair.first;
@@ -257,6 +474,7 @@ private:
     MapIterator iter_;
 public:
     ValueIterator(const NodeBase* root) : iter_(root) {}
+    bool hasNext() const { return iter_.hasNext(); }
     py::object next() {
         auto pair = iter_.next();
         return pair.second;
@@ -268,6 +486,7 @@ private:
     MapIterator iter_;
 public:
     ItemIterator(const NodeBase* root) : iter_(root) {}
+    bool hasNext() const { return iter_.hasNext(); }
     py::tuple next() {
         auto pair = iter_.next();
         return py::make_tuple(pair.first, pair.second);
@@ -282,7 +501,7 @@ private:
 
     // Helper structure for bulk construction
     struct HashedEntry {
-        uint32_t hash;
+        hash_t hash;
         py::object key;
         py::object value;
     };
@@ -292,8 +511,13 @@ private:
                                    size_t start, size_t end, uint32_t shift,
                                    BulkOpArena& arena);
 
+    // Arena build + heap clone of entries with unique keys
+    static PersistentDict fromHashedEntries(std::vector<HashedEntry>& entries);
+
     // Structural merge helpers (Phase 4)
-    static NodeBase* mergeNodes(NodeBase* left, NodeBase* right, uint32_t shift);
+    // combine == nullptr means right-wins semantics
+    static NodeBase* mergeNodes(NodeBase* left, NodeBase* right, uint32_t shift,
+                                const MergeFn* combine = nullptr);
 
 public:
     // Sentinel value for "not found"
@@ -360,6 +584,21 @@ public:
     PersistentDict clear() const { return PersistentDict(); }
     PersistentDict copy() const { return *this; }  // Immutable, so copy = self
 
+    // Single-descent read-modify-write (see AlterFn)
+    PersistentDict alter(const py::object& key, const AlterFn& fn) const;
+
+    // Merge where keys present on both sides are combined with fn(left, right)
+    PersistentDict mergeWith(const PersistentDict& other, const MergeFn& fn) const;
+
+    // Shape-preserving bulk transforms: no rehashing, unchanged subtrees shared
+    PersistentDict mapValues(const MapFn& fn) const;
+    PersistentDict filter(const EntryPredicate& pred) const;
+
+    // Partitioning: k sub-dicts carved from top-level trie slots, sharing
+    // subtrees with this dict
+    std::vector<PersistentDict> split(size_t k) const;
+    std::vector<size_t> partitionSizes(size_t k) const;
+
     // Size
     size_t size() const { return count_; }
 
@@ -368,12 +607,24 @@ public:
     ValueIterator values() const;
     ItemIterator items() const;
 
+    // Raw (key, value) traversal for native consumers (e.g. JSON encoding)
+    MapIterator entries() const { return MapIterator(root_); }
+
+    // Trie root for structural analysis (node sharing between versions)
+    const NodeBase* root() const { return root_; }
+
     // Fast materialized iteration (returns pre-allocated list)
     // 3-4x faster than items() iterator for full iteration
     py::list itemsList() const;
     py::list keysList() const;
     py::list valuesList() const;
 
+    // Plain dict, presized and filled with the stored hashes
+    py::dict toDict() const;
+
+    // Visit every stored entry (key, value and trie hash)
+    void forEachEntry(const std::function<void(const Entry&)>& fn) const;
+
     // Equality
     bool operator==(const PersistentDict& other) const;
     bool operator!=(const PersistentDict& other) const { return !(*this == other); }
@@ -384,4 +635,15 @@ public:
     // Factory methods
     static PersistentDict fromDict(const py::dict& d);
     static PersistentDict create(const py::kwargs& kw);
+
+    // Trie shape introspection: depth, node counts, fan-out per level
+    py::dict trieStats() const;
+
+    // Bulk construction from entries with unique keys (caller guarantees no duplicates)
+    static PersistentDict fromEntries(const std::vector<std::pair<py::object, py::object>>& entries);
+
+    // Aggregating builders: accumulate per key in native buffers, then
+    // bulk-build the result trie once
+    static PersistentDict groupBy(const py::object& iterable, const py::object& keyfn);
+    static PersistentDict frequencies(const py::object& iterable);
 };
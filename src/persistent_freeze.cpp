@@ -0,0 +1,270 @@
+#include "persistent_freeze.hpp"
+#include "persistent_dict.hpp"
+#include "persistent_array_map.hpp"
+#include "persistent_list.hpp"
+#include "persistent_set.hpp"
+#include "persistent_sorted_dict.hpp"
+#include "persistent_ordered_dict.hpp"
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace pfreeze {
+
+namespace {
+
+constexpr size_t ARRAY_MAP_MAX = 8;  // Matches PersistentArrayMap's small-map limit
+
+// Shared bookkeeping: containers on the current path (cycle detection) and
+// finished conversions (shared sub-objects are converted once)
+class Walk {
+public:
+    explicit Walk(const char* name) : name_(name) {}
+
+protected:
+    template <typename Convert>
+    py::object visit(py::handle obj, Convert&& convert) {
+        PyObject* o = obj.ptr();
+        auto done = memo_.find(o);
+        if (done != memo_.end()) {
+            return done->second;
+        }
+        if (!active_.insert(o).second) {
+            throw std::invalid_argument(std::string(name_) + "(): circular reference detected");
+        }
+        pmutils::RecursionGuard guard(" while converting a nested structure");
+        py::object result = convert();
+        active_.erase(o);
+        memo_.emplace(o, result);
+        return result;
+    }
+
+private:
+    const char* name_;
+    std::unordered_map<PyObject*, py::object> memo_;
+    std::unordered_set<PyObject*> active_;
+};
+
+class Freezer : public Walk {
+public:
+    explicit Freezer(bool array_maps) : Walk("freeze"), array_maps_(array_maps) {}
+
+    py::object freeze(py::handle obj) {
+        PyObject* o = obj.ptr();
+        if (PyDict_Check(o)) {
+            return visit(obj, [&] { return freezeDict(o); });
+        }
+        if (PyList_Check(o)) {
+            return visit(obj, [&] { return freezeList(o); });
+        }
+        if (PyTuple_CheckExact(o) && PyTuple_GET_SIZE(o) > 0) {
+            return visit(obj, [&] { return freezeTuple(o); });
+        }
+        if (PyAnySet_Check(o)) {
+            return visit(obj, [&] { return freezeSet(o); });
+        }
+        return py::reinterpret_borrow<py::object>(obj);
+    }
+
+private:
+    bool array_maps_;
+
+    py::object freezeDict(PyObject* d) {
+        Py_ssize_t n = PyDict_GET_SIZE(d);
+        std::vector<std::pair<py::object, py::object>> entries;
+        entries.reserve(static_cast<size_t>(n));
+        Py_ssize_t pos = 0;
+        PyObject* k;
+        PyObject* v;
+        while (PyDict_Next(d, &pos, &k, &v)) {
+            entries.emplace_back(py::reinterpret_borrow<py::object>(k), freeze(v));
+        }
+
+        if (array_maps_ && entries.size() <= ARRAY_MAP_MAX) {
+            auto small = std::make_shared<std::vector<Entry>>();
+            small->reserve(entries.size());
+            for (auto& [key, val] : entries) {
+                small->emplace_back(key, val);
+            }
+            return py::cast(PersistentArrayMap(std::move(small)));
+        }
+        // dict keys are already unique
+        return py::cast(PersistentDict::fromEntries(entries));
+    }
+
+    py::object freezeList(PyObject* l) {
+        std::vector<py::object> items;
+        items.reserve(static_cast<size_t>(PyList_GET_SIZE(l)));
+        for (Py_ssize_t i = 0; i < PyList_GET_SIZE(l); ++i) {
+            items.push_back(freeze(PyList_GET_ITEM(l, i)));
+        }
+        return py::cast(PersistentList::fromVector(std::move(items)));
+    }
+
+    py::object freezeTuple(PyObject* t) {
+        Py_ssize_t n = PyTuple_GET_SIZE(t);
+        std::vector<py::object> items;
+        items.reserve(static_cast<size_t>(n));
+        bool changed = false;
+        for (Py_ssize_t i = 0; i < n; ++i) {
+            items.push_back(freeze(PyTuple_GET_ITEM(t, i)));
+            changed = changed || items.back().ptr() != PyTuple_GET_ITEM(t, i);
+        }
+        if (!changed) {
+            return py::reinterpret_borrow<py::object>(t);
+        }
+        py::tuple result(n);
+        for (Py_ssize_t i = 0; i < n; ++i) {
+            PyTuple_SET_ITEM(result.ptr(), i, items[i].release().ptr());
+        }
+        return std::move(result);
+    }
+
+    py::object freezeSet(PyObject* s) {
+        // Elements are hashable and used as-is
+        std::vector<std::pair<py::object, py::object>> entries;
+        entries.reserve(static_cast<size_t>(PySet_GET_SIZE(s)));
+        py::object none = py::none();
+        for (auto elem : py::reinterpret_borrow<py::iterable>(s)) {
+            entries.emplace_back(py::reinterpret_borrow<py::object>(elem), none);
+        }
+        return py::cast(PersistentSet(PersistentDict::fromEntries(entries)));
+    }
+};
+
+class Thawer : public Walk {
+public:
+    Thawer() : Walk("thaw") {}
+
+    py::object thaw(py::handle obj) {
+        PyObject* o = obj.ptr();
+        if (py::isinstance<PersistentDict>(obj)) {
+            return visit(obj, [&] {
+                const auto& m = obj.cast<const PersistentDict&>();
+                py::dict result;
+                MapIterator it = m.entries();
+                while (it.hasNext()) {
+                    auto kv = it.next();
+                    setItem(result, kv.first, thaw(kv.second));
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (py::isinstance<PersistentArrayMap>(obj)) {
+            return visit(obj, [&] {
+                const auto& m = obj.cast<const PersistentArrayMap&>();
+                py::dict result;
+                if (const auto* entries = m.getEntries()) {
+                    for (const Entry& e : *entries) {
+                        setItem(result, e.key, thaw(e.value));
+                    }
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (py::isinstance<PersistentList>(obj)) {
+            return visit(obj, [&] {
+                const auto& l = obj.cast<const PersistentList&>();
+                py::list result(l.size());
+                Py_ssize_t i = 0;
+                l.forEach([&](const py::object& elem) {
+                    PyList_SET_ITEM(result.ptr(), i++, thaw(elem).release().ptr());
+                });
+                return py::object(std::move(result));
+            });
+        }
+        if (py::isinstance<PersistentSet>(obj)) {
+            return visit(obj, [&] {
+                const auto& s = obj.cast<const PersistentSet&>();
+                py::set result;
+                MapIterator it = s.getMap().entries();
+                while (it.hasNext()) {
+                    if (PySet_Add(result.ptr(), it.next().first.ptr()) != 0) {
+                        throw py::error_already_set();
+                    }
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (py::isinstance<PersistentSortedDict>(obj)) {
+            return visit(obj, [&] {
+                const auto& m = obj.cast<const PersistentSortedDict&>();
+                py::dict result;
+                TreeMapIterator it = m.iter();
+                while (it.hasNext()) {
+                    py::object kv = it.next();  // [key, value]
+                    setItem(result, kv[py::int_(0)], thaw(kv[py::int_(1)]));
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (py::isinstance<PersistentOrderedDict>(obj)) {
+            return visit(obj, [&] {
+                const auto& m = obj.cast<const PersistentOrderedDict&>();
+                py::dict result;
+                for (auto item : m.itemsList()) {
+                    py::tuple kv = py::reinterpret_borrow<py::tuple>(item);
+                    setItem(result, kv[0], thaw(kv[1]));
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (PyDict_Check(o)) {
+            return visit(obj, [&] {
+                py::dict result;
+                Py_ssize_t pos = 0;
+                PyObject* k;
+                PyObject* v;
+                while (PyDict_Next(o, &pos, &k, &v)) {
+                    setItem(result, k, thaw(v));
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (PyList_Check(o)) {
+            return visit(obj, [&] {
+                Py_ssize_t n = PyList_GET_SIZE(o);
+                py::list result(n);
+                for (Py_ssize_t i = 0; i < n; ++i) {
+                    PyList_SET_ITEM(result.ptr(), i, thaw(PyList_GET_ITEM(o, i)).release().ptr());
+                }
+                return py::object(std::move(result));
+            });
+        }
+        if (PyTuple_CheckExact(o) && PyTuple_GET_SIZE(o) > 0) {
+            return visit(obj, [&] {
+                Py_ssize_t n = PyTuple_GET_SIZE(o);
+                py::tuple result(n);
+                for (Py_ssize_t i = 0; i < n; ++i) {
+                    PyTuple_SET_ITEM(result.ptr(), i, thaw(PyTuple_GET_ITEM(o, i)).release().ptr());
+                }
+                return py::object(std::move(result));
+            });
+        }
+        return py::reinterpret_borrow<py::object>(obj);
+    }
+
+private:
+    static void setItem(py::dict& d, py::handle key, const py::object& value) {
+        if (PyDict_SetItem(d.ptr(), key.ptr(), value.ptr()) != 0) {
+            throw py::error_already_set();
+        }
+    }
+};
+
+} // namespace
+
+py::object freeze(const py::object& obj, bool array_maps) {
+    Freezer freezer(array_maps);
+    return freezer.freeze(obj);
+}
+
+py::object thaw(const py::object& obj) {
+    Thawer thawer;
+    return thawer.thaw(obj);
+}
+
+} // namespace pfreeze
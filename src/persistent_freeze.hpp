@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+/**
+ * Deep conversion between plain Python containers and persistent ones
+ *
+ * freeze() replaces a recursive Python helper calling from_dict()/from_list()
+ * per level: the whole tree is converted in one native pass, every level
+ * using the bulk builders (PersistentDict::fromEntries,
+ * PersistentList::fromVector) with pre-sized entry buffers.
+ *
+ *   dict            -> PersistentArrayMap (≤8 items, if array_maps) or PersistentDict
+ *   list            -> PersistentList
+ *   set / frozenset -> PersistentSet
+ *   tuple           -> tuple with frozen elements (the same tuple if unchanged)
+ *
+ * thaw() is the inverse, producing dict/list/set from every persistent
+ * container (PersistentSortedDict and PersistentOrderedDict thaw to dicts
+ * in their iteration order).
+ *
+ * Both keep shared sub-objects shared (one conversion per source object,
+ * like copy.deepcopy), raise ValueError on reference cycles and
+ * RecursionError on excessive nesting. Other objects, including keys and
+ * persistent containers passed to freeze(), are used as-is.
+ */
+namespace pfreeze {
+
+py::object freeze(const py::object& obj, bool array_maps);
+
+py::object thaw(const py::object& obj);
+
+} // namespace pfreeze
@@ -0,0 +1,252 @@
+#include "persistent_history.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+using Slot = NodeArray::value_type;
+
+// Native footprint of one trie node or entry. Entries are allocated with
+// their shared_ptr control block (two reference counts and a vtable).
+size_t entryBytes() {
+    return sizeof(Entry) + 2 * sizeof(void*);
+}
+
+size_t nodeBytes(const NodeBase* node) {
+    if (auto* bitmapNode = dynamic_cast<const BitmapNode*>(node)) {
+        return sizeof(BitmapNode) + bitmapNode->getArray().capacity() * sizeof(Slot);
+    }
+    auto* collisionNode = static_cast<const CollisionNode*>(node);
+    return sizeof(CollisionNode) +
+           collisionNode->getEntries().capacity() * sizeof(std::shared_ptr<Entry>);
+}
+
+// Bytes reachable from a that are not shared with b. Shared subtrees sit at
+// the same trie position in both versions, so the walk pairs slots by bit
+// and skips any subtree whose pointer is the same on both sides.
+size_t addedBytes(const NodeBase* a, const NodeBase* b) {
+    if (!a || a == b) return 0;
+    size_t total = nodeBytes(a);
+
+    if (auto* bitmapNode = dynamic_cast<const BitmapNode*>(a)) {
+        auto* other = dynamic_cast<const BitmapNode*>(b);
+        const auto& array = bitmapNode->getArray();
+        size_t idx = 0;
+        for (bitmap_t bits = bitmapNode->getBitmap(); bits; bits &= bits - 1, ++idx) {
+            const Slot* otherSlot = slotAt(other, bits & (~bits + 1));
+            if (auto* entry = std::get_if<std::shared_ptr<Entry>>(&array[idx])) {
+                auto* otherEntry = otherSlot ? std::get_if<std::shared_ptr<Entry>>(otherSlot) : nullptr;
+                if (!otherEntry || otherEntry->get() != entry->get()) {
+                    total += entryBytes();
+                }
+            } else {
+                auto* otherChild = otherSlot ? std::get_if<NodeBase*>(otherSlot) : nullptr;
+                total += addedBytes(std::get<NodeBase*>(array[idx]), otherChild ? *otherChild : nullptr);
+            }
+        }
+        return total;
+    }
+
+    // Collision buckets are small: match entries by pointer
+    auto* other = dynamic_cast<const CollisionNode*>(b);
+    for (const auto& entry : static_cast<const CollisionNode*>(a)->getEntries()) {
+        bool shared = false;
+        if (other) {
+            for (const auto& otherEntry : other->getEntries()) {
+                if (otherEntry.get() == entry.get()) {
+                    shared = true;
+                    break;
+                }
+            }
+        }
+        if (!shared) total += entryBytes();
+    }
+    return total;
+}
+
+// Exact ownership: every node and entry reachable from some version is
+// tagged with the only version holding it, or SHARED. A node first reached
+// from a second version becomes SHARED together with its whole subtree;
+// subtrees already SHARED are not revisited, so each node is walked at most
+// twice overall.
+class OwnershipAnalysis {
+public:
+    static constexpr size_t SHARED = static_cast<size_t>(-1);
+
+    void addVersion(const NodeBase* root, size_t version) {
+        if (root) visit(root, version);
+    }
+
+    std::vector<size_t> bytesByOwner(size_t versions) const {
+        std::vector<size_t> result(versions, 0);
+        for (const auto& item : owners_) {
+            if (item.second.owner != SHARED) {
+                result[item.second.owner] += item.second.bytes;
+            }
+        }
+        return result;
+    }
+
+private:
+    struct Owner {
+        size_t owner;
+        size_t bytes;
+    };
+    std::unordered_map<const void*, Owner> owners_;
+
+    void visit(const NodeBase* node, size_t version) {
+        auto [it, inserted] = owners_.try_emplace(node, Owner{version, nodeBytes(node)});
+        if (!inserted) {
+            if (it->second.owner != SHARED) markShared(node);
+            return;
+        }
+        forEachChild(node, [&](const void* entry) { visitEntry(entry, version); },
+                     [&](const NodeBase* child) { visit(child, version); });
+    }
+
+    void visitEntry(const void* entry, size_t version) {
+        auto [it, inserted] = owners_.try_emplace(entry, Owner{version, entryBytes()});
+        if (!inserted) it->second.owner = SHARED;
+    }
+
+    void markShared(const NodeBase* node) {
+        owners_[node].owner = SHARED;
+        forEachChild(node, [&](const void* entry) { owners_[entry].owner = SHARED; },
+                     [&](const NodeBase* child) {
+                         if (owners_[child].owner != SHARED) markShared(child);
+                     });
+    }
+
+    template <typename OnEntry, typename OnNode>
+    static void forEachChild(const NodeBase* node, OnEntry onEntry, OnNode onNode) {
+        if (auto* bitmapNode = dynamic_cast<const BitmapNode*>(node)) {
+            for (const auto& slot : bitmapNode->getArray()) {
+                if (auto* entry = std::get_if<std::shared_ptr<Entry>>(&slot)) {
+                    onEntry(entry->get());
+                } else {
+                    onNode(std::get<NodeBase*>(slot));
+                }
+            }
+        } else {
+            for (const auto& entry : static_cast<const CollisionNode*>(node)->getEntries()) {
+                onEntry(entry.get());
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+History::History(const PersistentDict& initial, std::optional<size_t> maxVersions,
+                 std::optional<size_t> maxBytes)
+    : retained_(0), maxVersions_(maxVersions), maxBytes_(maxBytes) {
+    if (maxVersions_ && *maxVersions_ == 0) {
+        throw std::invalid_argument("max_versions must be at least 1");
+    }
+    versions_.push_back(initial);
+    added_.push_back(addedBytes(initial.root(), nullptr));
+    retained_ = added_.back();
+    enforce();
+}
+
+void History::snapshot(const PersistentDict& state) {
+    size_t added = addedBytes(state.root(), versions_.back().root());
+    versions_.push_back(state);
+    added_.push_back(added);
+    retained_ += added;
+    enforce();
+}
+
+const PersistentDict& History::rollback(size_t n) {
+    if (n >= versions_.size()) {
+        throw py::index_error("cannot roll back past the oldest version");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        retained_ -= added_.back();
+        versions_.pop_back();
+        added_.pop_back();
+    }
+    return versions_.back();
+}
+
+void History::compact(Py_ssize_t start, Py_ssize_t stop) {
+    size_t first = normalizeIndex(start);
+    size_t last = normalizeIndex(stop);
+    if (last <= first + 1) return;
+
+    for (size_t i = first + 1; i <= last; ++i) {
+        retained_ -= added_[i];
+    }
+    versions_.erase(versions_.begin() + first + 1, versions_.begin() + last);
+    added_.erase(added_.begin() + first + 1, added_.begin() + last);
+    // The version that was at stop now follows the one at start
+    added_[first + 1] = addedBytes(versions_[first + 1].root(), versions_[first].root());
+    retained_ += added_[first + 1];
+}
+
+const PersistentDict& History::at(Py_ssize_t index) const {
+    return versions_[normalizeIndex(index)];
+}
+
+py::list History::versions() const {
+    py::list result(versions_.size());
+    for (size_t i = 0; i < versions_.size(); ++i) {
+        PyList_SET_ITEM(result.ptr(), i, py::cast(versions_[i]).release().ptr());
+    }
+    return result;
+}
+
+std::vector<size_t> History::uniqueBytes() const {
+    OwnershipAnalysis analysis;
+    for (size_t i = 0; i < versions_.size(); ++i) {
+        analysis.addVersion(versions_[i].root(), i);
+    }
+    return analysis.bytesByOwner(versions_.size());
+}
+
+void History::setRetention(std::optional<size_t> maxVersions, std::optional<size_t> maxBytes) {
+    if (maxVersions && *maxVersions == 0) {
+        throw std::invalid_argument("max_versions must be at least 1");
+    }
+    maxVersions_ = maxVersions;
+    maxBytes_ = maxBytes;
+    enforce();
+}
+
+std::string History::repr() const {
+    std::ostringstream oss;
+    oss << "History(versions=" << versions_.size()
+        << ", retained_bytes=" << retained_ << ")";
+    return oss.str();
+}
+
+void History::dropOldest() {
+    // The bytes freed are those of the oldest version not shared with the
+    // next one. The next version then accounts for all of its own bytes:
+    // bytes(v1) = bytes(v0) + added(v1 | v0) - added(v0 | v1). Both walks
+    // are proportional to the edit between the two versions.
+    size_t dropped = addedBytes(versions_[0].root(), versions_[1].root());
+    retained_ -= dropped;
+    added_[1] = added_[0] + added_[1] - dropped;
+    versions_.pop_front();
+    added_.pop_front();
+}
+
+void History::enforce() {
+    while (maxVersions_ && versions_.size() > *maxVersions_) {
+        dropOldest();
+    }
+    while (maxBytes_ && retained_ > *maxBytes_ && versions_.size() > 1) {
+        dropOldest();
+    }
+}
+
+size_t History::normalizeIndex(Py_ssize_t index) const {
+    Py_ssize_t n = static_cast<Py_ssize_t>(versions_.size());
+    if (index < 0) index += n;
+    if (index < 0 || index >= n) {
+        throw py::index_error("history index out of range");
+    }
+    return static_cast<size_t>(index);
+}
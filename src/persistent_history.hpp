@@ -0,0 +1,80 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <deque>
+#include <optional>
+#include <vector>
+#include "persistent_dict.hpp"
+
+namespace py = pybind11;
+
+/**
+ * History - Bounded version history of a PersistentDict
+ *
+ * Versions are kept oldest first in a deque of roots, so snapshot() and
+ * rollback() only add or drop references (O(1) per version) and consecutive
+ * versions share every node an edit did not touch.
+ *
+ * Retention:
+ * - max_versions caps the number of versions
+ * - max_bytes caps the native bytes (HAMT nodes and entries) the history
+ *   retains; keys and values themselves are not counted
+ * The oldest versions are dropped first; the current version is always kept.
+ *
+ * Retained bytes are tracked incrementally: each version records the bytes
+ * of the nodes it does not share with its predecessor, found by walking the
+ * two tries in parallel and skipping shared subtrees. The walk is
+ * proportional to the edit, not the size of the map. A version that shares
+ * nodes only with a non-adjacent version is counted twice, so the total is
+ * an upper bound (exact for histories built by successive edits).
+ *
+ * uniqueBytes() is the exact per-version report: one pass over all versions
+ * that marks each node with the single version holding it, or as shared.
+ */
+class History {
+public:
+    History(const PersistentDict& initial, std::optional<size_t> maxVersions,
+            std::optional<size_t> maxBytes);
+
+    // Record a new current version; applies the retention policy
+    void snapshot(const PersistentDict& state);
+
+    // Drop the n most recent versions and return the new current version
+    const PersistentDict& rollback(size_t n);
+
+    // Drop the versions strictly between start and stop (indices, oldest = 0)
+    void compact(Py_ssize_t start, Py_ssize_t stop);
+
+    const PersistentDict& current() const { return versions_.back(); }
+    const PersistentDict& at(Py_ssize_t index) const;
+    size_t size() const { return versions_.size(); }
+    py::list versions() const;
+
+    // Native bytes retained by all versions together (upper bound, see above)
+    size_t retainedBytes() const { return retained_; }
+
+    // Native bytes held by each version and no other, oldest first
+    std::vector<size_t> uniqueBytes() const;
+
+    // Change the retention policy and apply it immediately
+    void setRetention(std::optional<size_t> maxVersions, std::optional<size_t> maxBytes);
+
+    std::optional<size_t> maxVersions() const { return maxVersions_; }
+    std::optional<size_t> maxBytes() const { return maxBytes_; }
+
+    std::string repr() const;
+
+private:
+    std::deque<PersistentDict> versions_;
+    // added_[i]: bytes of versions_[i] not shared with versions_[i - 1]
+    // (all of versions_[0])
+    std::deque<size_t> added_;
+    size_t retained_;
+    std::optional<size_t> maxVersions_;
+    std::optional<size_t> maxBytes_;
+
+    void dropOldest();
+    void enforce();
+    size_t normalizeIndex(Py_ssize_t index) const;
+};
@@ -0,0 +1,272 @@
+#include "persistent_indexed_dict.hpp"
+#include "type_slots.hpp"
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// keyfn(record), or a null object when the record is not indexed
+py::object indexKey(const IndexedPersistentDict::IndexSpec& spec, const py::object& record) {
+    py::object result = spec.keyfn(record);
+    return result.is_none() ? py::object() : result;
+}
+
+void addSpecs(std::vector<IndexedPersistentDict::IndexSpec>& specs, const py::dict& declared,
+              bool sorted) {
+    for (auto item : declared) {
+        std::string name = item.first.cast<std::string>();
+        for (const auto& spec : specs) {
+            if (spec.name == name) {
+                throw std::invalid_argument("duplicate index name: " + name);
+            }
+        }
+        if (!PyCallable_Check(item.second.ptr())) {
+            throw py::type_error("index '" + name + "' key function must be callable");
+        }
+        specs.push_back({name, py::reinterpret_borrow<py::object>(item.second), sorted});
+    }
+}
+
+} // anonymous namespace
+
+IndexedPersistentDict::IndexedPersistentDict(const py::dict& indexes, const py::dict& sortedIndexes,
+                                             const py::object& data) {
+    auto specs = std::make_shared<std::vector<IndexSpec>>();
+    addSpecs(*specs, indexes, false);
+    addSpecs(*specs, sortedIndexes, true);
+    specs_ = specs;
+    indexes_.resize(specs_->size());
+
+    if (!data.is_none()) {
+        if (py::isinstance<PersistentDict>(data)) {
+            data_ = data.cast<const PersistentDict&>();
+        } else if (py::isinstance<py::dict>(data)) {
+            data_ = PersistentDict::fromDict(data.cast<py::dict>());
+        } else {
+            data_ = PersistentDict().update(data);
+        }
+        rebuildIndexes();
+    }
+}
+
+// Core operations
+
+IndexedPersistentDict IndexedPersistentDict::assoc(const py::object& key, const py::object& record) const {
+    IndexedPersistentDict result(*this);
+    result.put(key, record);
+    return result;
+}
+
+IndexedPersistentDict IndexedPersistentDict::dissoc(const py::object& key) const {
+    IndexedPersistentDict result(*this);
+    result.erase(key);
+    return result;
+}
+
+IndexedPersistentDict IndexedPersistentDict::update(const py::object& other) const {
+    IndexedPersistentDict result(*this);
+    size_t incoming = py::len(other);
+    if (incoming == 0) {
+        return result;
+    }
+
+    // Large batches: merge the primary map, then bulk-build every index
+    if (incoming >= data_.size()) {
+        result.data_ = data_.update(other);
+        result.rebuildIndexes();
+        return result;
+    }
+
+    if (py::isinstance<PersistentDict>(other)) {
+        other.cast<const PersistentDict&>().forEachEntry([&](const Entry& entry) {
+            result.put(entry.key, entry.value);
+        });
+    } else if (py::isinstance<py::dict>(other)) {
+        for (auto item : other.cast<py::dict>()) {
+            result.put(py::reinterpret_borrow<py::object>(item.first),
+                       py::reinterpret_borrow<py::object>(item.second));
+        }
+    } else {
+        for (auto item : other.attr("items")()) {
+            py::tuple kv = item.cast<py::tuple>();
+            result.put(kv[0], kv[1]);
+        }
+    }
+    return result;
+}
+
+py::object IndexedPersistentDict::get(const py::object& key, const py::object& default_val) const {
+    return data_.get(key, default_val);
+}
+
+py::object IndexedPersistentDict::pyGetItem(const py::object& key) const {
+    py::object result = data_.get(key, PersistentDict::NOT_FOUND);
+    if (result.is(PersistentDict::NOT_FOUND)) {
+        pslots::throwKeyError(key);
+    }
+    return result;
+}
+
+// Queries
+
+PersistentSet IndexedPersistentDict::lookup(const std::string& index, const py::object& value) const {
+    size_t i = indexOf(index);
+    if (!(*specs_)[i].sorted) {
+        return indexes_[i].hash.get(value);
+    }
+    py::object ids = indexes_[i].sorted.get(value, py::object());
+    return ids ? ids.cast<PersistentSet>() : PersistentSet();
+}
+
+SortedDictRange IndexedPersistentDict::range(const std::string& index, const py::object& start,
+                                             const py::object& stop, bool startInclusive,
+                                             bool stopInclusive) const {
+    size_t i = indexOf(index);
+    if (!(*specs_)[i].sorted) {
+        throw std::invalid_argument("range() requires a sorted index, '" + index + "' is a hash index");
+    }
+    return indexes_[i].sorted.range(start, stop, startInclusive, stopInclusive);
+}
+
+py::object IndexedPersistentDict::index(const std::string& name) const {
+    size_t i = indexOf(name);
+    if ((*specs_)[i].sorted) {
+        return py::cast(indexes_[i].sorted);
+    }
+    return py::cast(indexes_[i].hash);
+}
+
+py::list IndexedPersistentDict::indexNames() const {
+    py::list result;
+    for (const auto& spec : *specs_) {
+        result.append(spec.name);
+    }
+    return result;
+}
+
+std::string IndexedPersistentDict::repr() const {
+    std::ostringstream oss;
+    oss << "IndexedPersistentDict(size=" << data_.size() << ", indexes=[";
+    for (size_t i = 0; i < specs_->size(); ++i) {
+        if (i > 0) oss << ", ";
+        oss << (*specs_)[i].name << ((*specs_)[i].sorted ? " (sorted)" : "");
+    }
+    oss << "])";
+    return oss.str();
+}
+
+// Index maintenance
+
+size_t IndexedPersistentDict::indexOf(const std::string& name) const {
+    for (size_t i = 0; i < specs_->size(); ++i) {
+        if ((*specs_)[i].name == name) return i;
+    }
+    throw py::key_error("no index named '" + name + "'");
+}
+
+void IndexedPersistentDict::put(const py::object& key, const py::object& record) {
+    py::object old;
+    data_ = data_.alter(key, [&](const py::object& current) -> py::object {
+        old = current;
+        return record;
+    });
+    if (old && old.is(record)) {
+        return;
+    }
+    for (size_t i = 0; i < indexes_.size(); ++i) {
+        reindex(i, key, old, record);
+    }
+}
+
+void IndexedPersistentDict::erase(const py::object& key) {
+    py::object old;
+    data_ = data_.alter(key, [&](const py::object& current) -> py::object {
+        old = current;
+        return py::object();
+    });
+    if (!old) {
+        return;
+    }
+    for (size_t i = 0; i < indexes_.size(); ++i) {
+        reindex(i, key, old, py::object());
+    }
+}
+
+void IndexedPersistentDict::reindex(size_t i, const py::object& key, const py::object& oldRecord,
+                                    const py::object& newRecord) {
+    const IndexSpec& spec = (*specs_)[i];
+    py::object oldKey = oldRecord ? indexKey(spec, oldRecord) : py::object();
+    py::object newKey = newRecord ? indexKey(spec, newRecord) : py::object();
+    if (oldKey && newKey && pmutils::keysEqual(oldKey, newKey)) {
+        return;  // Same bucket: the index is unchanged
+    }
+    if (oldKey) removeFromIndex(i, oldKey, key);
+    if (newKey) addToIndex(i, newKey, key);
+}
+
+void IndexedPersistentDict::addToIndex(size_t i, const py::object& indexKey, const py::object& key) {
+    IndexState& state = indexes_[i];
+    if (!(*specs_)[i].sorted) {
+        state.hash = state.hash.add(indexKey, key);
+        return;
+    }
+    py::object ids = state.sorted.get(indexKey, py::object());
+    PersistentSet bucket = ids ? ids.cast<PersistentSet>() : PersistentSet();
+    state.sorted = state.sorted.assoc(indexKey, py::cast(bucket.conj(key)));
+}
+
+void IndexedPersistentDict::removeFromIndex(size_t i, const py::object& indexKey, const py::object& key) {
+    IndexState& state = indexes_[i];
+    if (!(*specs_)[i].sorted) {
+        state.hash = state.hash.remove(indexKey, key);
+        return;
+    }
+    py::object ids = state.sorted.get(indexKey, py::object());
+    if (!ids) return;
+    PersistentSet bucket = ids.cast<PersistentSet>().disj(key);
+    state.sorted = bucket.size() == 0 ? state.sorted.dissoc(indexKey)
+                                      : state.sorted.assoc(indexKey, py::cast(bucket));
+}
+
+// Bulk build: group ids per index key in Python dicts, then build each
+// index once (PersistentMultiMap::fromPairs, or sorted keys straight into
+// PersistentSortedDict::fromSortedEntries)
+void IndexedPersistentDict::rebuildIndexes() {
+    size_t n = specs_->size();
+    std::vector<py::list> pairs(n);
+    std::vector<py::dict> groups(n);
+
+    data_.forEachEntry([&](const Entry& entry) {
+        for (size_t i = 0; i < n; ++i) {
+            py::object k = indexKey((*specs_)[i], entry.value);
+            if (!k) continue;
+            if (!(*specs_)[i].sorted) {
+                pairs[i].append(py::make_tuple(k, entry.key));
+                continue;
+            }
+            PyObject* ids = PyDict_GetItemWithError(groups[i].ptr(), k.ptr());
+            if (!ids) {
+                if (PyErr_Occurred()) throw py::error_already_set();
+                groups[i][k] = py::list();
+                ids = PyDict_GetItemWithError(groups[i].ptr(), k.ptr());
+            }
+            if (PyList_Append(ids, entry.key.ptr()) < 0) throw py::error_already_set();
+        }
+    });
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!(*specs_)[i].sorted) {
+            indexes_[i] = IndexState{PersistentMultiMap::fromPairs(pairs[i]), PersistentSortedDict()};
+            continue;
+        }
+        auto keys = py::reinterpret_steal<py::list>(PyDict_Keys(groups[i].ptr()));
+        if (!keys || PyList_Sort(keys.ptr()) < 0) throw py::error_already_set();
+        std::vector<std::pair<py::object, py::object>> entries;
+        entries.reserve(keys.size());
+        for (auto k : keys) {
+            py::object key = py::reinterpret_borrow<py::object>(k);
+            entries.emplace_back(key, py::cast(PersistentSet::fromList(groups[i][key])));
+        }
+        indexes_[i] = IndexState{PersistentMultiMap(), PersistentSortedDict::fromSortedEntries(entries)};
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "persistent_dict.hpp"
+#include "persistent_set.hpp"
+#include "persistent_multimap.hpp"
+#include "persistent_sorted_dict.hpp"
+
+namespace py = pybind11;
+
+/**
+ * IndexedPersistentDict - PersistentDict with secondary indexes
+ *
+ * Maps primary keys (ids) to records and keeps one index per declared key
+ * function, updated inside every assoc/dissoc/update:
+ * - hash indexes: PersistentMultiMap of keyfn(record) -> ids
+ * - sorted indexes: PersistentSortedDict of keyfn(record) -> PersistentSet
+ *   of ids, for range queries
+ * Records whose key function returns None are left out of that index.
+ *
+ * Every version shares structure with the previous one in the primary map
+ * and in each index; an update touches only the buckets of the old and new
+ * index keys, and none at all when the index key did not change. Index
+ * specs are shared by all versions.
+ *
+ * Updates are all-or-nothing: if a key function or comparison raises, the
+ * original dict is unchanged. update() with at least as many entries as
+ * the dict holds rebuilds the indexes with the bulk builders instead.
+ */
+class IndexedPersistentDict {
+public:
+    struct IndexSpec {
+        std::string name;
+        py::object keyfn;
+        bool sorted;
+    };
+
+    IndexedPersistentDict(const py::dict& indexes, const py::dict& sortedIndexes,
+                          const py::object& data);
+
+    // Core operations (functional style)
+    IndexedPersistentDict assoc(const py::object& key, const py::object& record) const;
+    IndexedPersistentDict dissoc(const py::object& key) const;
+    IndexedPersistentDict update(const py::object& other) const;
+    py::object get(const py::object& key, const py::object& default_val) const;
+    py::object pyGetItem(const py::object& key) const;
+    bool contains(const py::object& key) const { return data_.contains(key); }
+
+    // Ids whose record has keyfn(record) == value (empty set if none)
+    PersistentSet lookup(const std::string& index, const py::object& value) const;
+
+    // Sorted indexes only: lazy view of value -> ids between two bounds
+    SortedDictRange range(const std::string& index, const py::object& start, const py::object& stop,
+                          bool startInclusive, bool stopInclusive) const;
+
+    // The index itself: PersistentMultiMap or PersistentSortedDict
+    py::object index(const std::string& name) const;
+    py::list indexNames() const;
+
+    size_t size() const { return data_.size(); }
+    KeyIterator keys() const { return data_.keys(); }
+    const PersistentDict& data() const { return data_; }
+
+    std::string repr() const;
+
+private:
+    struct IndexState {
+        PersistentMultiMap hash;
+        PersistentSortedDict sorted;
+    };
+
+    PersistentDict data_;
+    std::shared_ptr<const std::vector<IndexSpec>> specs_;
+    std::vector<IndexState> indexes_;
+
+    size_t indexOf(const std::string& name) const;
+
+    // In-place steps, applied to a copy by the public operations
+    void put(const py::object& key, const py::object& record);
+    void erase(const py::object& key);
+    void reindex(size_t i, const py::object& key, const py::object& oldRecord,
+                 const py::object& newRecord);
+    void addToIndex(size_t i, const py::object& indexKey, const py::object& key);
+    void removeFromIndex(size_t i, const py::object& indexKey, const py::object& key);
+    void rebuildIndexes();
+};
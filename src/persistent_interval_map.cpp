@@ -0,0 +1,423 @@
+#include "persistent_interval_map.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+inline int heightOf(const IntervalNode* node) {
+    return node ? node->height : 0;
+}
+
+// Free a node that was built during this operation but not kept. Shared
+// nodes (refcount > 0) belong to other trees and are left alone.
+inline void retire(IntervalNode* node) {
+    if (node && node->getRefCount() == 0) {
+        delete node;
+    }
+}
+
+inline int compareIntervals(const py::object& lo1, const py::object& hi1,
+                            const py::object& lo2, const py::object& hi2) {
+    int c = PersistentIntervalMap::compare(lo1, lo2);
+    return c != 0 ? c : PersistentIntervalMap::compare(hi1, hi2);
+}
+
+}  // namespace
+
+// IntervalNode implementation
+
+IntervalNode::IntervalNode(const py::object& lo_, const py::object& hi_, const py::object& value_,
+                           IntervalNode* left_, IntervalNode* right_)
+    : lo(lo_), hi(hi_), value(value_), maxHi(hi_), left(left_), right(right_), refcount_(0) {
+    if (left) {
+        left->addRef();
+        if (PersistentIntervalMap::compare(left->maxHi, maxHi) > 0) maxHi = left->maxHi;
+    }
+    if (right) {
+        right->addRef();
+        if (PersistentIntervalMap::compare(right->maxHi, maxHi) > 0) maxHi = right->maxHi;
+    }
+    height = 1 + std::max(heightOf(left), heightOf(right));
+}
+
+IntervalNode::~IntervalNode() {
+    if (left) left->release();
+    if (right) right->release();
+}
+
+void IntervalNode::addRef() {
+    refcount_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IntervalNode::release() {
+    int oldVal = refcount_.fetch_sub(1, std::memory_order_acq_rel);
+    if (oldVal == 1) {
+        delete this;
+    }
+}
+
+// PersistentIntervalMap implementation
+
+PersistentIntervalMap::PersistentIntervalMap()
+    : root_(nullptr), count_(0) {}
+
+PersistentIntervalMap::PersistentIntervalMap(IntervalNode* root, size_t count)
+    : root_(root), count_(count) {
+    if (root_) root_->addRef();
+}
+
+PersistentIntervalMap::PersistentIntervalMap(const PersistentIntervalMap& other)
+    : root_(other.root_), count_(other.count_) {
+    if (root_) root_->addRef();
+}
+
+PersistentIntervalMap::PersistentIntervalMap(PersistentIntervalMap&& other) noexcept
+    : root_(other.root_), count_(other.count_) {
+    other.root_ = nullptr;
+    other.count_ = 0;
+}
+
+PersistentIntervalMap::~PersistentIntervalMap() {
+    if (root_) root_->release();
+}
+
+PersistentIntervalMap& PersistentIntervalMap::operator=(const PersistentIntervalMap& other) {
+    if (this != &other) {
+        if (other.root_) other.root_->addRef();
+        if (root_) root_->release();
+        root_ = other.root_;
+        count_ = other.count_;
+    }
+    return *this;
+}
+
+PersistentIntervalMap& PersistentIntervalMap::operator=(PersistentIntervalMap&& other) noexcept {
+    if (this != &other) {
+        if (root_) root_->release();
+        root_ = other.root_;
+        count_ = other.count_;
+        other.root_ = nullptr;
+        other.count_ = 0;
+    }
+    return *this;
+}
+
+int PersistentIntervalMap::compare(const py::object& a, const py::object& b) {
+    // Fast path: exact ints that fit in a long long (IPv4, timestamps)
+    if (PyLong_CheckExact(a.ptr()) && PyLong_CheckExact(b.ptr())) {
+        int overflowA = 0;
+        int overflowB = 0;
+        long long x = PyLong_AsLongLongAndOverflow(a.ptr(), &overflowA);
+        long long y = PyLong_AsLongLongAndOverflow(b.ptr(), &overflowB);
+        if (!overflowA && !overflowB) {
+            return (x > y) - (x < y);
+        }
+    }
+
+    int eq = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_EQ);
+    if (eq == 1) return 0;
+    if (eq == -1) throw py::error_already_set();
+
+    int lt = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_LT);
+    if (lt == -1) throw py::error_already_set();
+    return lt ? -1 : 1;
+}
+
+// Tree operations
+
+IntervalNode* PersistentIntervalMap::balance(const py::object& lo, const py::object& hi,
+                                             const py::object& val,
+                                             IntervalNode* left, IntervalNode* right) {
+    int hl = heightOf(left);
+    int hr = heightOf(right);
+
+    if (hl > hr + 1) {
+        IntervalNode* result;
+        if (heightOf(left->left) >= heightOf(left->right)) {
+            // Single right rotation
+            result = new IntervalNode(left->lo, left->hi, left->value, left->left,
+                                      new IntervalNode(lo, hi, val, left->right, right));
+        } else {
+            // Left-right double rotation
+            IntervalNode* lr = left->right;
+            result = new IntervalNode(lr->lo, lr->hi, lr->value,
+                                      new IntervalNode(left->lo, left->hi, left->value, left->left, lr->left),
+                                      new IntervalNode(lo, hi, val, lr->right, right));
+        }
+        retire(left);
+        return result;
+    }
+
+    if (hr > hl + 1) {
+        IntervalNode* result;
+        if (heightOf(right->right) >= heightOf(right->left)) {
+            // Single left rotation
+            result = new IntervalNode(right->lo, right->hi, right->value,
+                                      new IntervalNode(lo, hi, val, left, right->left),
+                                      right->right);
+        } else {
+            // Right-left double rotation
+            IntervalNode* rl = right->left;
+            result = new IntervalNode(rl->lo, rl->hi, rl->value,
+                                      new IntervalNode(lo, hi, val, left, rl->left),
+                                      new IntervalNode(right->lo, right->hi, right->value, rl->right, right->right));
+        }
+        retire(right);
+        return result;
+    }
+
+    return new IntervalNode(lo, hi, val, left, right);
+}
+
+IntervalNode* PersistentIntervalMap::insert(IntervalNode* node, const py::object& lo,
+                                            const py::object& hi, const py::object& val,
+                                            bool& inserted) {
+    if (node == nullptr) {
+        inserted = true;
+        return new IntervalNode(lo, hi, val, nullptr, nullptr);
+    }
+
+    int cmp = compareIntervals(lo, hi, node->lo, node->hi);
+    if (cmp < 0) {
+        IntervalNode* newLeft = insert(node->left, lo, hi, val, inserted);
+        return balance(node->lo, node->hi, node->value, newLeft, node->right);
+    }
+    if (cmp > 0) {
+        IntervalNode* newRight = insert(node->right, lo, hi, val, inserted);
+        return balance(node->lo, node->hi, node->value, node->left, newRight);
+    }
+
+    // Same interval, replace value
+    inserted = false;
+    return new IntervalNode(node->lo, node->hi, val, node->left, node->right);
+}
+
+IntervalNode* PersistentIntervalMap::removeMin(IntervalNode* node) {
+    if (node->left == nullptr) {
+        return node->right;
+    }
+    return balance(node->lo, node->hi, node->value, removeMin(node->left), node->right);
+}
+
+// Returns node itself when the interval is not present
+IntervalNode* PersistentIntervalMap::remove(IntervalNode* node, const py::object& lo,
+                                            const py::object& hi) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    int cmp = compareIntervals(lo, hi, node->lo, node->hi);
+    if (cmp < 0) {
+        IntervalNode* newLeft = remove(node->left, lo, hi);
+        if (newLeft == node->left) return node;
+        return balance(node->lo, node->hi, node->value, newLeft, node->right);
+    }
+    if (cmp > 0) {
+        IntervalNode* newRight = remove(node->right, lo, hi);
+        if (newRight == node->right) return node;
+        return balance(node->lo, node->hi, node->value, node->left, newRight);
+    }
+
+    // Found it
+    if (node->left == nullptr) return node->right;
+    if (node->right == nullptr) return node->left;
+
+    // Replace with the in-order successor
+    IntervalNode* succ = node->right;
+    while (succ->left) succ = succ->left;
+    return balance(succ->lo, succ->hi, succ->value, node->left, removeMin(node->right));
+}
+
+IntervalNode* PersistentIntervalMap::find(const py::object& lo, const py::object& hi) const {
+    IntervalNode* node = root_;
+    while (node) {
+        int cmp = compareIntervals(lo, hi, node->lo, node->hi);
+        if (cmp == 0) return node;
+        node = cmp < 0 ? node->left : node->right;
+    }
+    return nullptr;
+}
+
+PersistentIntervalMap PersistentIntervalMap::assoc(const py::object& lo, const py::object& hi,
+                                                   const py::object& val) const {
+    if (compare(lo, hi) > 0) {
+        throw py::value_error("Interval lower bound must not exceed upper bound");
+    }
+
+    bool inserted = false;
+    IntervalNode* newRoot = insert(root_, lo, hi, val, inserted);
+    return PersistentIntervalMap(newRoot, inserted ? count_ + 1 : count_);
+}
+
+PersistentIntervalMap PersistentIntervalMap::dissoc(const py::object& lo, const py::object& hi) const {
+    IntervalNode* newRoot = remove(root_, lo, hi);
+    if (newRoot == root_) {
+        return *this;  // Not found
+    }
+    return PersistentIntervalMap(newRoot, count_ - 1);
+}
+
+py::object PersistentIntervalMap::get(const py::object& lo, const py::object& hi,
+                                      const py::object& default_val) const {
+    IntervalNode* node = find(lo, hi);
+    return node ? node->value : default_val;
+}
+
+bool PersistentIntervalMap::contains(const py::object& lo, const py::object& hi) const {
+    return find(lo, hi) != nullptr;
+}
+
+// Queries
+
+void PersistentIntervalMap::collectStabbing(const IntervalNode* node, const py::object& point,
+                                            py::list& out, bool valuesOnly) {
+    // Nothing in this subtree ends at or after point
+    if (node == nullptr || compare(node->maxHi, point) < 0) {
+        return;
+    }
+
+    collectStabbing(node->left, point, out, valuesOnly);
+
+    if (compare(node->lo, point) > 0) {
+        return;  // This node and everything to its right starts after point
+    }
+    if (compare(node->hi, point) >= 0) {
+        if (valuesOnly) {
+            out.append(node->value);
+        } else {
+            out.append(py::make_tuple(node->lo, node->hi, node->value));
+        }
+    }
+
+    collectStabbing(node->right, point, out, valuesOnly);
+}
+
+void PersistentIntervalMap::collectOverlapping(const IntervalNode* node, const py::object& lo,
+                                               const py::object& hi, py::list& out) {
+    if (node == nullptr || compare(node->maxHi, lo) < 0) {
+        return;
+    }
+
+    collectOverlapping(node->left, lo, hi, out);
+
+    if (compare(node->lo, hi) > 0) {
+        return;
+    }
+    if (compare(node->hi, lo) >= 0) {
+        out.append(py::make_tuple(node->lo, node->hi, node->value));
+    }
+
+    collectOverlapping(node->right, lo, hi, out);
+}
+
+void PersistentIntervalMap::collectAll(const IntervalNode* node, py::list& out) {
+    if (node == nullptr) return;
+    collectAll(node->left, out);
+    out.append(py::make_tuple(node->lo, node->hi, node->value));
+    collectAll(node->right, out);
+}
+
+py::list PersistentIntervalMap::stabbing(const py::object& point) const {
+    py::list result;
+    collectStabbing(root_, point, result, false);
+    return result;
+}
+
+py::list PersistentIntervalMap::stabbingValues(const py::object& point) const {
+    py::list result;
+    collectStabbing(root_, point, result, true);
+    return result;
+}
+
+py::list PersistentIntervalMap::overlapping(const py::object& lo, const py::object& hi) const {
+    py::list result;
+    collectOverlapping(root_, lo, hi, result);
+    return result;
+}
+
+py::list PersistentIntervalMap::itemsList() const {
+    py::list result;
+    collectAll(root_, result);
+    return result;
+}
+
+// Equality
+bool PersistentIntervalMap::operator==(const PersistentIntervalMap& other) const {
+    if (count_ != other.count_) return false;
+    if (root_ == other.root_) return true;
+
+    py::list mine = itemsList();
+    py::list theirs = other.itemsList();
+    int result = PyObject_RichCompareBool(mine.ptr(), theirs.ptr(), Py_EQ);
+    if (result == -1) throw py::error_already_set();
+    return result == 1;
+}
+
+// String representation
+std::string PersistentIntervalMap::repr() const {
+    std::ostringstream oss;
+    oss << "PersistentIntervalMap({";
+
+    bool first = true;
+    for (auto item : itemsList()) {
+        if (!first) oss << ", ";
+        first = false;
+
+        py::tuple t = item.cast<py::tuple>();
+        oss << "[" << py::repr(t[0]).cast<std::string>() << ", "
+            << py::repr(t[1]).cast<std::string>() << "]: "
+            << py::repr(t[2]).cast<std::string>();
+    }
+
+    oss << "})";
+    return oss.str();
+}
+
+// Factory methods
+
+IntervalNode* PersistentIntervalMap::buildBalanced(const std::vector<py::tuple>& items,
+                                                   size_t start, size_t end) {
+    if (start >= end) return nullptr;
+    size_t mid = start + (end - start) / 2;
+    IntervalNode* left = buildBalanced(items, start, mid);
+    IntervalNode* right = buildBalanced(items, mid + 1, end);
+    const py::tuple& t = items[mid];
+    return new IntervalNode(t[0], t[1], t[2], left, right);
+}
+
+PersistentIntervalMap PersistentIntervalMap::fromItems(const py::object& items) {
+    std::vector<py::tuple> sorted;
+
+    py::iterator it = py::iter(items);
+    while (it != py::iterator::sentinel()) {
+        py::tuple t(py::reinterpret_borrow<py::object>(*it));
+        if (t.size() != 3) {
+            throw std::invalid_argument("from_items() requires (lo, hi, value) triples");
+        }
+        if (compare(t[0], t[1]) > 0) {
+            throw py::value_error("Interval lower bound must not exceed upper bound");
+        }
+        sorted.push_back(t);
+        ++it;
+    }
+
+    // Stable sort so that, among duplicates, the last one given stays last
+    std::stable_sort(sorted.begin(), sorted.end(), [](const py::tuple& a, const py::tuple& b) {
+        return compareIntervals(a[0], a[1], b[0], b[1]) < 0;
+    });
+
+    // Collapse duplicate intervals, last value wins
+    std::vector<py::tuple> unique;
+    unique.reserve(sorted.size());
+    for (const auto& t : sorted) {
+        if (!unique.empty() && compareIntervals(unique.back()[0], unique.back()[1], t[0], t[1]) == 0) {
+            unique.back() = t;
+        } else {
+            unique.push_back(t);
+        }
+    }
+
+    // Bottom-up build of a perfectly balanced tree: O(n) after the sort
+    IntervalNode* root = buildBalanced(unique, 0, unique.size());
+    return PersistentIntervalMap(root, unique.size());
+}
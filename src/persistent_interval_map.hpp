@@ -0,0 +1,110 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "tracked_alloc.hpp"
+
+namespace py = pybind11;
+
+// IntervalNode - AVL node augmented with the maximum upper bound of its subtree
+class IntervalNode : public pmalloc::Tracked<pmalloc::DOMAIN_INTERVAL_MAP> {
+public:
+    py::object lo;
+    py::object hi;
+    py::object value;
+    py::object maxHi;       // max(hi) over this subtree
+    IntervalNode* left;
+    IntervalNode* right;
+    int height;
+
+    // Takes a reference to left/right; computes height and maxHi
+    IntervalNode(const py::object& lo, const py::object& hi, const py::object& value,
+                 IntervalNode* left, IntervalNode* right);
+    ~IntervalNode();
+
+    void addRef();
+    void release();
+    int getRefCount() const { return refcount_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int> refcount_;
+};
+
+/**
+ * PersistentIntervalMap - Immutable map from closed intervals [lo, hi] to values
+ *
+ * A persistent AVL tree ordered by (lo, hi) where every node also stores the
+ * maximum hi of its subtree. That augmentation is recomputed on every path
+ * copy and rotation, which lets stabbing and overlap queries skip whole
+ * subtrees that end before the query starts:
+ * - stabbing(point) and overlapping(lo, hi) are O(log n + k)
+ * - assoc/dissoc/get are O(log n)
+ *
+ * Bounds may be any mutually comparable Python objects; exact ints that fit
+ * in 64 bits are compared without going through rich comparison.
+ */
+class PersistentIntervalMap {
+public:
+    // Constructors
+    PersistentIntervalMap();
+    PersistentIntervalMap(IntervalNode* root, size_t count);
+    PersistentIntervalMap(const PersistentIntervalMap& other);
+    PersistentIntervalMap(PersistentIntervalMap&& other) noexcept;
+    ~PersistentIntervalMap();
+
+    // Assignment
+    PersistentIntervalMap& operator=(const PersistentIntervalMap& other);
+    PersistentIntervalMap& operator=(PersistentIntervalMap&& other) noexcept;
+
+    // Core operations (functional API)
+    PersistentIntervalMap assoc(const py::object& lo, const py::object& hi, const py::object& val) const;
+    PersistentIntervalMap dissoc(const py::object& lo, const py::object& hi) const;
+    py::object get(const py::object& lo, const py::object& hi,
+                   const py::object& default_val = py::none()) const;
+    bool contains(const py::object& lo, const py::object& hi) const;
+
+    // Queries - results are (lo, hi, value) tuples in (lo, hi) order
+    py::list stabbing(const py::object& point) const;
+    py::list stabbingValues(const py::object& point) const;
+    py::list overlapping(const py::object& lo, const py::object& hi) const;
+
+    // Size and iteration
+    size_t size() const { return count_; }
+    py::list itemsList() const;
+
+    // Equality
+    bool operator==(const PersistentIntervalMap& other) const;
+    bool operator!=(const PersistentIntervalMap& other) const { return !(*this == other); }
+
+    // String representation
+    std::string repr() const;
+
+    // Factory methods
+    static PersistentIntervalMap fromItems(const py::object& items);  // (lo, hi, value) triples
+
+    // Comparison helper (-1, 0, 1)
+    static int compare(const py::object& a, const py::object& b);
+
+private:
+    IntervalNode* root_;
+    size_t count_;
+
+    // Tree helpers (nodes are returned with refcount 0, like TreeNode)
+    static IntervalNode* balance(const py::object& lo, const py::object& hi, const py::object& val,
+                                 IntervalNode* left, IntervalNode* right);
+    static IntervalNode* insert(IntervalNode* node, const py::object& lo, const py::object& hi,
+                                const py::object& val, bool& inserted);
+    static IntervalNode* remove(IntervalNode* node, const py::object& lo, const py::object& hi);
+    static IntervalNode* removeMin(IntervalNode* node);
+    static IntervalNode* buildBalanced(const std::vector<py::tuple>& items, size_t start, size_t end);
+
+    IntervalNode* find(const py::object& lo, const py::object& hi) const;
+
+    static void collectStabbing(const IntervalNode* node, const py::object& point,
+                                py::list& out, bool valuesOnly);
+    static void collectOverlapping(const IntervalNode* node, const py::object& lo,
+                                   const py::object& hi, py::list& out);
+    static void collectAll(const IntervalNode* node, py::list& out);
+};
@@ -0,0 +1,728 @@
+#include "persistent_json.hpp"
+#include "persistent_dict.hpp"
+#include "persistent_array_map.hpp"
+#include "persistent_list.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pjson {
+
+namespace {
+
+constexpr size_t ARRAY_MAP_MAX = 8;  // Matches PersistentArrayMap's small-map limit
+
+using pmutils::RecursionGuard;
+
+// ============================================================================
+// Parser
+// ============================================================================
+
+class Parser {
+public:
+    Parser(const char* data, size_t size, bool array_maps)
+        : begin_(data), p_(data), end_(data + size), array_maps_(array_maps) {}
+
+    py::object parseDocument() {
+        skipWhitespace();
+        py::object result = parseValue();
+        skipWhitespace();
+        if (p_ != end_) {
+            fail("Extra data", p_);
+        }
+        return result;
+    }
+
+private:
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    bool array_maps_;
+    std::unordered_map<std::string, py::object> keys_;  // Interned object keys
+    std::string scratch_;                                // Unescaped string buffer
+
+    [[noreturn]] void fail(const char* msg, const char* at) const {
+        size_t line = 1;
+        const char* line_start = begin_;
+        for (const char* q = begin_; q < at; ++q) {
+            if (*q == '\n') {
+                ++line;
+                line_start = q + 1;
+            }
+        }
+        throw std::invalid_argument(std::string(msg) + ": line " + std::to_string(line) +
+                                    " column " + std::to_string(at - line_start + 1) +
+                                    " (char " + std::to_string(at - begin_) + ")");
+    }
+
+    void skipWhitespace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    bool consumeLiteral(const char* lit) {
+        size_t n = std::strlen(lit);
+        if (static_cast<size_t>(end_ - p_) >= n && std::memcmp(p_, lit, n) == 0) {
+            p_ += n;
+            return true;
+        }
+        return false;
+    }
+
+    py::object parseValue() {
+        if (p_ == end_) {
+            fail("Expecting value", p_);
+        }
+        switch (*p_) {
+            case '{': return parseObject();
+            case '[': return parseArray();
+            case '"': return parseString(false);
+            case 'n':
+                if (consumeLiteral("null")) return py::none();
+                break;
+            case 't':
+                if (consumeLiteral("true")) return py::bool_(true);
+                break;
+            case 'f':
+                if (consumeLiteral("false")) return py::bool_(false);
+                break;
+            case 'N':
+                if (consumeLiteral("NaN")) return py::float_(Py_NAN);
+                break;
+            case 'I':
+                if (consumeLiteral("Infinity")) return py::float_(Py_HUGE_VAL);
+                break;
+            case '-':
+                if (consumeLiteral("-Infinity")) return py::float_(-Py_HUGE_VAL);
+                return parseNumber();
+            default:
+                if (*p_ >= '0' && *p_ <= '9') return parseNumber();
+                break;
+        }
+        fail("Expecting value", p_);
+    }
+
+    py::object parseNumber() {
+        const char* start = p_;
+        if (*p_ == '-') ++p_;
+
+        const char* int_start = p_;
+        if (p_ < end_ && *p_ == '0') {
+            ++p_;
+        } else if (p_ < end_ && *p_ >= '1' && *p_ <= '9') {
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        } else {
+            fail("Expecting value", start);
+        }
+        size_t int_digits = p_ - int_start;
+
+        bool is_float = false;
+        if (p_ < end_ && *p_ == '.' && p_ + 1 < end_ && p_[1] >= '0' && p_[1] <= '9') {
+            is_float = true;
+            p_ += 2;
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+        }
+        if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            const char* q = p_ + 1;
+            if (q < end_ && (*q == '+' || *q == '-')) ++q;
+            if (q < end_ && *q >= '0' && *q <= '9') {
+                is_float = true;
+                p_ = q;
+                while (p_ < end_ && *p_ >= '0' && *p_ <= '9') ++p_;
+            }
+        }
+
+        if (!is_float && int_digits <= 18) {
+            // Fits in int64 without overflow checks
+            long long value = 0;
+            for (const char* q = int_start; q < p_; ++q) {
+                value = value * 10 + (*q - '0');
+            }
+            return py::reinterpret_steal<py::object>(
+                PyLong_FromLongLong(*start == '-' ? -value : value));
+        }
+
+        std::string text(start, p_);
+        PyObject* result;
+        if (is_float) {
+            double d = PyOS_string_to_double(text.c_str(), nullptr, nullptr);
+            if (d == -1.0 && PyErr_Occurred()) {
+                throw py::error_already_set();
+            }
+            result = PyFloat_FromDouble(d);
+        } else {
+            result = PyLong_FromString(text.c_str(), nullptr, 10);
+        }
+        if (!result) {
+            throw py::error_already_set();
+        }
+        return py::reinterpret_steal<py::object>(result);
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    uint32_t parseHex4(const char* at) {
+        if (end_ - at < 4) {
+            fail("Invalid \\uXXXX escape", at - 1);
+        }
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            int v = hexValue(at[i]);
+            if (v < 0) {
+                fail("Invalid \\uXXXX escape", at - 1);
+            }
+            cp = (cp << 4) | static_cast<uint32_t>(v);
+        }
+        return cp;
+    }
+
+    void appendUtf8(uint32_t cp) {
+        // Lone surrogates are encoded as-is and decoded with "surrogatepass",
+        // matching json.loads
+        if (cp < 0x80) {
+            scratch_ += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            scratch_ += static_cast<char>(0xC0 | (cp >> 6));
+            scratch_ += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            scratch_ += static_cast<char>(0xE0 | (cp >> 12));
+            scratch_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            scratch_ += static_cast<char>(0xF0 | (cp >> 18));
+            scratch_ += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            scratch_ += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // Unescape from p_ (just past an escape-containing prefix) into scratch_
+    void unescapeRest(const char* quote) {
+        while (true) {
+            if (p_ == end_) {
+                fail("Unterminated string starting at", quote);
+            }
+            char c = *p_;
+            if (c == '"') {
+                ++p_;
+                return;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                fail("Invalid control character at", p_);
+            }
+            if (c != '\\') {
+                scratch_ += c;
+                ++p_;
+                continue;
+            }
+            if (p_ + 1 == end_) {
+                fail("Unterminated string starting at", quote);
+            }
+            char esc = p_[1];
+            p_ += 2;
+            switch (esc) {
+                case '"': scratch_ += '"'; break;
+                case '\\': scratch_ += '\\'; break;
+                case '/': scratch_ += '/'; break;
+                case 'b': scratch_ += '\b'; break;
+                case 'f': scratch_ += '\f'; break;
+                case 'n': scratch_ += '\n'; break;
+                case 'r': scratch_ += '\r'; break;
+                case 't': scratch_ += '\t'; break;
+                case 'u': {
+                    uint32_t cp = parseHex4(p_);
+                    p_ += 4;
+                    if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 6 &&
+                        p_[0] == '\\' && p_[1] == 'u') {
+                        uint32_t low = parseHex4(p_ + 2);
+                        if (low >= 0xDC00 && low <= 0xDFFF) {
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            p_ += 6;
+                        }
+                    }
+                    appendUtf8(cp);
+                    break;
+                }
+                default:
+                    fail("Invalid \\escape", p_ - 2);
+            }
+        }
+    }
+
+    static py::object decode(const char* data, size_t size, const char* errors) {
+        PyObject* s = PyUnicode_DecodeUTF8(data, static_cast<Py_ssize_t>(size), errors);
+        if (!s) {
+            throw py::error_already_set();
+        }
+        return py::reinterpret_steal<py::object>(s);
+    }
+
+    py::object parseString(bool is_key) {
+        const char* quote = p_++;
+        const char* start = p_;
+
+        // Fast path: scan for the closing quote with no escapes
+        while (p_ < end_ && *p_ != '"' && *p_ != '\\' &&
+               static_cast<unsigned char>(*p_) >= 0x20) {
+            ++p_;
+        }
+        if (p_ == end_) {
+            fail("Unterminated string starting at", quote);
+        }
+        if (static_cast<unsigned char>(*p_) < 0x20) {
+            fail("Invalid control character at", p_);
+        }
+
+        const char* data = start;
+        size_t size = p_ - start;
+        const char* errors = "strict";
+        if (*p_ == '"') {
+            ++p_;
+        } else {
+            scratch_.assign(start, p_);
+            unescapeRest(quote);
+            data = scratch_.data();
+            size = scratch_.size();
+            errors = "surrogatepass";
+        }
+
+        if (!is_key) {
+            return decode(data, size, errors);
+        }
+
+        std::string text(data, size);
+        auto it = keys_.find(text);
+        if (it != keys_.end()) {
+            return it->second;
+        }
+        py::object key = decode(data, size, errors);
+        PyObject* raw = key.release().ptr();
+        PyUnicode_InternInPlace(&raw);
+        key = py::reinterpret_steal<py::object>(raw);
+        keys_.emplace(std::move(text), key);
+        return key;
+    }
+
+    py::object parseArray() {
+        RecursionGuard guard(" while decoding a JSON array");
+        ++p_;  // '['
+        std::vector<py::object> items;
+
+        skipWhitespace();
+        if (p_ < end_ && *p_ == ']') {
+            ++p_;
+            return py::cast(PersistentList());
+        }
+        while (true) {
+            skipWhitespace();
+            items.push_back(parseValue());
+            skipWhitespace();
+            if (p_ < end_ && *p_ == ',') {
+                ++p_;
+            } else if (p_ < end_ && *p_ == ']') {
+                ++p_;
+                break;
+            } else {
+                fail("Expecting ',' delimiter", p_);
+            }
+        }
+        return py::cast(PersistentList::fromVector(std::move(items)));
+    }
+
+    py::object parseObject() {
+        RecursionGuard guard(" while decoding a JSON object");
+        ++p_;  // '{'
+        std::vector<std::pair<py::object, py::object>> entries;
+        // Keys are interned, so duplicates are the same object; the index is
+        // only built once an object outgrows a linear scan
+        std::unordered_map<PyObject*, size_t> index;
+
+        skipWhitespace();
+        if (p_ < end_ && *p_ == '}') {
+            ++p_;
+            return array_maps_ ? py::cast(PersistentArrayMap()) : py::cast(PersistentDict());
+        }
+        while (true) {
+            skipWhitespace();
+            if (p_ == end_ || *p_ != '"') {
+                fail("Expecting property name enclosed in double quotes", p_);
+            }
+            py::object key = parseString(true);
+            skipWhitespace();
+            if (p_ == end_ || *p_ != ':') {
+                fail("Expecting ':' delimiter", p_);
+            }
+            ++p_;
+            skipWhitespace();
+            py::object value = parseValue();
+
+            PyObject* k = key.ptr();
+            size_t existing = entries.size();
+            if (entries.size() <= ARRAY_MAP_MAX) {
+                for (size_t i = 0; i < entries.size(); ++i) {
+                    if (entries[i].first.ptr() == k) {
+                        existing = i;
+                        break;
+                    }
+                }
+            } else {
+                if (index.empty()) {
+                    for (size_t i = 0; i < entries.size(); ++i) {
+                        index.emplace(entries[i].first.ptr(), i);
+                    }
+                }
+                auto it = index.find(k);
+                if (it != index.end()) {
+                    existing = it->second;
+                } else {
+                    index.emplace(k, entries.size());
+                }
+            }
+            if (existing < entries.size()) {
+                entries[existing].second = std::move(value);
+            } else {
+                entries.emplace_back(std::move(key), std::move(value));
+            }
+
+            skipWhitespace();
+            if (p_ < end_ && *p_ == ',') {
+                ++p_;
+            } else if (p_ < end_ && *p_ == '}') {
+                ++p_;
+                break;
+            } else {
+                fail("Expecting ',' delimiter", p_);
+            }
+        }
+
+        if (array_maps_ && entries.size() <= ARRAY_MAP_MAX) {
+            auto small = std::make_shared<std::vector<Entry>>();
+            small->reserve(entries.size());
+            for (auto& [k, v] : entries) {
+                small->emplace_back(k, v);
+            }
+            return py::cast(PersistentArrayMap(std::move(small)));
+        }
+        return py::cast(PersistentDict::fromEntries(entries));
+    }
+};
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+class Encoder {
+public:
+    explicit Encoder(bool sort_keys) : sort_keys_(sort_keys) {}
+
+    void encode(py::handle obj) {
+        PyObject* o = obj.ptr();
+        if (o == Py_None) {
+            out_ += "null";
+        } else if (o == Py_True) {
+            out_ += "true";
+        } else if (o == Py_False) {
+            out_ += "false";
+        } else if (PyUnicode_Check(o)) {
+            writeString(o);
+        } else if (PyLong_Check(o)) {
+            writeInt(o);
+        } else if (PyFloat_Check(o)) {
+            writeFloat(PyFloat_AS_DOUBLE(o));
+        } else if (py::isinstance<PersistentDict>(obj)) {
+            RecursionGuard guard(" while encoding a JSON object");
+            const PersistentDict& d = obj.cast<const PersistentDict&>();
+            writeObject([&](auto&& emit) {
+                MapIterator it = d.entries();
+                while (it.hasNext()) {
+                    auto kv = it.next();
+                    emit(kv.first, kv.second);
+                }
+            });
+        } else if (py::isinstance<PersistentArrayMap>(obj)) {
+            RecursionGuard guard(" while encoding a JSON object");
+            const PersistentArrayMap& m = obj.cast<const PersistentArrayMap&>();
+            writeObject([&](auto&& emit) {
+                if (const auto* entries = m.getEntries()) {
+                    for (const Entry& e : *entries) {
+                        emit(e.key, e.value);
+                    }
+                }
+            });
+        } else if (py::isinstance<PersistentList>(obj)) {
+            RecursionGuard guard(" while encoding a JSON array");
+            const PersistentList& l = obj.cast<const PersistentList&>();
+            out_ += '[';
+            bool first = true;
+            l.forEach([&](const py::object& elem) {
+                if (!first) out_ += ',';
+                first = false;
+                encode(elem);
+            });
+            out_ += ']';
+        } else if (PyDict_Check(o)) {
+            RecursionGuard guard(" while encoding a JSON object");
+            writeObject([&](auto&& emit) {
+                Py_ssize_t pos = 0;
+                PyObject* k;
+                PyObject* v;
+                while (PyDict_Next(o, &pos, &k, &v)) {
+                    emit(py::handle(k), py::handle(v));
+                }
+            });
+        } else if (PyList_Check(o) || PyTuple_Check(o)) {
+            RecursionGuard guard(" while encoding a JSON array");
+            out_ += '[';
+            for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(o); ++i) {
+                if (i > 0) out_ += ',';
+                encode(py::handle(PySequence_Fast_GET_ITEM(o, i)));
+            }
+            out_ += ']';
+        } else {
+            throw py::type_error(std::string("Object of type ") + Py_TYPE(o)->tp_name +
+                                 " is not JSON serializable");
+        }
+    }
+
+    py::bytes result() const { return py::bytes(out_.data(), out_.size()); }
+
+private:
+    std::string out_;
+    bool sort_keys_;
+
+    void writeEscaped(const char* s, size_t n) {
+        static const char HEX[] = "0123456789abcdef";
+        out_ += '"';
+        size_t run = 0;  // Start of the pending unescaped run
+        for (size_t i = 0; i < n; ++i) {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out_.append(s + run, i - run);
+            run = i + 1;
+            switch (c) {
+                case '"': out_ += "\\\""; break;
+                case '\\': out_ += "\\\\"; break;
+                case '\n': out_ += "\\n"; break;
+                case '\r': out_ += "\\r"; break;
+                case '\t': out_ += "\\t"; break;
+                case '\b': out_ += "\\b"; break;
+                case '\f': out_ += "\\f"; break;
+                default:
+                    out_ += "\\u00";
+                    out_ += HEX[c >> 4];
+                    out_ += HEX[c & 0xF];
+            }
+        }
+        out_.append(s + run, n - run);
+        out_ += '"';
+    }
+
+    void writeString(PyObject* s) {
+        Py_ssize_t n;
+        const char* data = PyUnicode_AsUTF8AndSize(s, &n);
+        if (!data) {
+            throw py::error_already_set();
+        }
+        writeEscaped(data, static_cast<size_t>(n));
+    }
+
+    void writeInt(PyObject* o) {
+        int overflow = 0;
+        long long v = PyLong_AsLongLongAndOverflow(o, &overflow);
+        if (v == -1 && PyErr_Occurred()) {
+            throw py::error_already_set();
+        }
+        if (!overflow) {
+            char buf[24];
+            auto res = std::to_chars(buf, buf + sizeof(buf), v);
+            out_.append(buf, res.ptr);
+            return;
+        }
+        // int.__repr__ (not type(o).__repr__) so IntEnum and friends stay numeric
+        py::str text = py::reinterpret_steal<py::str>(PyLong_Type.tp_repr(o));
+        if (!text) {
+            throw py::error_already_set();
+        }
+        out_ += text.cast<std::string>();
+    }
+
+    void writeFloat(double d) {
+        char* text = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, nullptr);
+        if (!text) {
+            throw py::error_already_set();
+        }
+        // String form rather than isnan/isinf, which -ffast-math may fold away
+        if (std::strcmp(text, "nan") == 0) {
+            out_ += "NaN";
+        } else if (std::strcmp(text, "inf") == 0) {
+            out_ += "Infinity";
+        } else if (std::strcmp(text, "-inf") == 0) {
+            out_ += "-Infinity";
+        } else {
+            out_ += text;
+        }
+        PyMem_Free(text);
+    }
+
+    // Object keys follow json.dumps: str, or int/float/bool/None as text
+    std::string keyText(py::handle key) {
+        PyObject* k = key.ptr();
+        if (PyUnicode_Check(k)) {
+            Py_ssize_t n;
+            const char* data = PyUnicode_AsUTF8AndSize(k, &n);
+            if (!data) {
+                throw py::error_already_set();
+            }
+            return std::string(data, static_cast<size_t>(n));
+        }
+        if (k == Py_True) return "true";
+        if (k == Py_False) return "false";
+        if (k == Py_None) return "null";
+        if (PyLong_Check(k) || PyFloat_Check(k)) {
+            size_t mark = out_.size();
+            if (PyLong_Check(k)) {
+                writeInt(k);
+            } else {
+                writeFloat(PyFloat_AS_DOUBLE(k));
+            }
+            std::string text = out_.substr(mark);
+            out_.resize(mark);
+            return text;
+        }
+        throw py::type_error(std::string("keys must be str, int, float, bool or None, not ") +
+                             Py_TYPE(k)->tp_name);
+    }
+
+    // forEachItem(emit) must call emit(key, value) once per entry
+    template <typename ForEachItem>
+    void writeObject(ForEachItem&& forEachItem) {
+        out_ += '{';
+        if (!sort_keys_) {
+            bool first = true;
+            forEachItem([&](py::handle k, py::handle v) {
+                if (!first) out_ += ',';
+                first = false;
+                if (PyUnicode_Check(k.ptr())) {
+                    writeString(k.ptr());
+                } else {
+                    std::string text = keyText(k);
+                    writeEscaped(text.data(), text.size());
+                }
+                out_ += ':';
+                encode(v);
+            });
+        } else {
+            // Sort the key objects with <, as json.dumps(sort_keys=True) does:
+            // 10 sorts after 9, and incomparable mixes such as int and str
+            // raise TypeError
+            struct Item {
+                py::object key;
+                py::object value;
+            };
+            std::vector<Item> items;
+            forEachItem([&](py::handle k, py::handle v) {
+                items.push_back({py::reinterpret_borrow<py::object>(k),
+                                 py::reinterpret_borrow<py::object>(v)});
+            });
+            // Record a failed comparison instead of throwing out of std::sort
+            bool failed = false;
+            std::sort(items.begin(), items.end(), [&](const Item& a, const Item& b) {
+                if (failed) return false;
+                int lt = PyObject_RichCompareBool(a.key.ptr(), b.key.ptr(), Py_LT);
+                if (lt < 0) {
+                    failed = true;
+                    return false;
+                }
+                return lt == 1;
+            });
+            if (failed) {
+                throw py::error_already_set();
+            }
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (i > 0) out_ += ',';
+                std::string text = keyText(items[i].key);
+                writeEscaped(text.data(), text.size());
+                out_ += ':';
+                encode(items[i].value);
+            }
+        }
+        out_ += '}';
+    }
+};
+
+// Holds a contiguous byte view of str or bytes-like input
+class InputView {
+public:
+    explicit InputView(const py::object& data) {
+        PyObject* o = data.ptr();
+        if (PyUnicode_Check(o)) {
+            Py_ssize_t n;
+            data_ = PyUnicode_AsUTF8AndSize(o, &n);
+            if (!data_) {
+                throw py::error_already_set();
+            }
+            size_ = static_cast<size_t>(n);
+            return;
+        }
+        if (!PyObject_CheckBuffer(o) || PyObject_GetBuffer(o, &view_, PyBUF_SIMPLE) != 0) {
+            PyErr_Clear();
+            throw py::type_error(std::string("the JSON object must be str, bytes or bytearray, not ") +
+                                 Py_TYPE(o)->tp_name);
+        }
+        has_view_ = true;
+        data_ = static_cast<const char*>(view_.buf);
+        size_ = static_cast<size_t>(view_.len);
+        // Skip a UTF-8 byte order mark, as json.loads does for bytes
+        if (size_ >= 3 && std::memcmp(data_, "\xEF\xBB\xBF", 3) == 0) {
+            data_ += 3;
+            size_ -= 3;
+        }
+    }
+
+    ~InputView() {
+        if (has_view_) {
+            PyBuffer_Release(&view_);
+        }
+    }
+
+    InputView(const InputView&) = delete;
+    InputView& operator=(const InputView&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    Py_buffer view_{};
+    bool has_view_ = false;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace
+
+py::object loads(const py::object& data, bool array_maps) {
+    InputView input(data);
+    Parser parser(input.data(), input.size(), array_maps);
+    return parser.parseDocument();
+}
+
+py::bytes dumps(const py::object& obj, bool sort_keys) {
+    Encoder encoder(sort_keys);
+    encoder.encode(obj);
+    return encoder.result();
+}
+
+} // namespace pjson
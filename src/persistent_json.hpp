@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+/**
+ * JSON codec for persistent structures
+ *
+ * loads() parses UTF-8 JSON straight into persistent containers, skipping
+ * the intermediate dict/list tree that from_dict()/from_list() would need:
+ * - objects become PersistentArrayMap (≤8 members, if array_maps) or
+ *   PersistentDict, built in one pass with PersistentDict::fromEntries
+ * - arrays become PersistentList, built with PersistentList::fromVector
+ * - object keys are interned and shared across the whole document, so the
+ *   repeated field names of an event stream are stored once
+ * - duplicate keys keep the last value, like json.loads
+ *
+ * dumps() walks the tries directly (no to-dict/to-list materialization) and
+ * produces compact UTF-8 JSON equivalent to
+ * json.dumps(obj, separators=(',', ':'), ensure_ascii=False).
+ *
+ * Errors: malformed input raises ValueError with line/column, unsupported
+ * types raise TypeError, excessive nesting raises RecursionError.
+ */
+namespace pjson {
+
+// Parse str or any bytes-like object holding UTF-8 JSON
+py::object loads(const py::object& data, bool array_maps);
+
+// Serialize PersistentDict/PersistentArrayMap/PersistentList (and plain
+// dict/list/tuple/str/int/float/bool/None) to UTF-8 JSON bytes
+py::bytes dumps(const py::object& obj, bool sort_keys);
+
+} // namespace pjson
@@ -1,4 +1,8 @@
 #include "persistent_list.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
@@ -210,6 +214,19 @@ py::object PersistentList::getFromTree(size_t idx) const {
     return std::get<py::object>(node->get(idx & MASK));
 }
 
+py::object PersistentList::nthCached(size_t idx, LeafCache& cache) const {
+    size_t tailStart = tailOffset();
+    if (idx >= tailStart) {
+        return (*tail_)[idx - tailStart];
+    }
+    size_t base = idx & ~static_cast<size_t>(MASK);
+    if (base != cache.base) {
+        cache.leaf = nodeAt(idx, 0);
+        cache.base = base;
+    }
+    return std::get<py::object>(cache.leaf->get(idx & MASK));
+}
+
 py::object PersistentList::get(size_t idx, const py::object& default_val) const {
     if (idx >= count_) {
         return default_val;
@@ -286,15 +303,21 @@ PersistentList PersistentList::pop() const {
 
 // Iteration and conversion
 
+ReverseVectorIterator PersistentList::reversed() const {
+    return ReverseVectorIterator(*this);
+}
+
 VectorIterator PersistentList::iter() const {
     return VectorIterator(this);
 }
 
 py::list PersistentList::list() const {
-    py::list result;
-    for (size_t i = 0; i < count_; ++i) {
-        result.append(nth(i));
-    }
+    // Presized and filled leaf by leaf instead of one descent per index
+    py::list result(count_);
+    size_t idx = 0;
+    forEach([&](const py::object& item) {
+        PyList_SET_ITEM(result.ptr(), idx++, item.inc_ref().ptr());
+    });
     return result;
 }
 
@@ -310,12 +333,317 @@ PersistentList PersistentList::slice(Py_ssize_t start, Py_ssize_t stop) const {
     if (stop > static_cast<Py_ssize_t>(count_)) stop = count_;
     if (start >= stop) return PersistentList();
 
-    // Build new vector from slice
-    PersistentList result;
-    for (Py_ssize_t i = start; i < stop; ++i) {
-        result = result.conj(nth(i));
+    return strided(start, 1, static_cast<size_t>(stop - start));
+}
+
+PersistentList PersistentList::strided(Py_ssize_t start, Py_ssize_t step, size_t length) const {
+    if (step == 1 && start == 0 && length == count_) {
+        return *this;
     }
-    return result;
+
+    // Read through the leaf cache and bulk-build the result
+    std::vector<py::object> items;
+    items.reserve(length);
+    LeafCache cache;
+    Py_ssize_t idx = start;
+    for (size_t i = 0; i < length; ++i, idx += step) {
+        items.push_back(nthCached(static_cast<size_t>(idx), cache));
+    }
+    return fromVector(std::move(items));
+}
+
+PersistentList PersistentList::take(const py::iterable& indices) const {
+    std::vector<py::object> items;
+    Py_ssize_t hint = PyObject_LengthHint(indices.ptr(), 0);
+    if (hint < 0) {
+        throw py::error_already_set();
+    }
+    items.reserve(static_cast<size_t>(hint));
+    LeafCache cache;
+    Py_ssize_t size = static_cast<Py_ssize_t>(count_);
+    for (auto index : indices) {
+        if (!PyLong_Check(index.ptr())) {
+            throw py::type_error(std::string("PersistentList indices must be integers, not ") +
+                                 Py_TYPE(index.ptr())->tp_name);
+        }
+        Py_ssize_t idx = PyLong_AsSsize_t(index.ptr());
+        if (idx == -1 && PyErr_Occurred()) {
+            PyErr_Clear();
+            idx = size;  // Beyond Py_ssize_t: out of range either way
+        } else if (idx < 0) {
+            idx += size;
+        }
+        if (idx < 0 || idx >= size) {
+            throw py::index_error("PersistentList index out of range");
+        }
+        items.push_back(nthCached(static_cast<size_t>(idx), cache));
+    }
+    return fromVector(std::move(items));
+}
+
+// Partitioning
+
+VectorNode* PersistentList::nodeAt(size_t idx, uint32_t level) const {
+    VectorNode* node = root_;
+    for (uint32_t lv = shift_; lv > level; lv -= BITS) {
+        node = std::get<VectorNode*>(node->get((idx >> lv) & MASK));
+    }
+    return node;
+}
+
+std::vector<size_t> PersistentList::splitPoints(size_t k) const {
+    if (k == 0) {
+        throw std::invalid_argument("split count must be at least 1");
+    }
+    // Boundaries fall on multiples of a power-of-32 granularity g so that
+    // parts can reuse whole subtrees; g stays below 1/32 of a part, which
+    // bounds the imbalance between parts
+    size_t tree = tailOffset();
+    size_t perPart = tree / k;
+    size_t g = NODE_SIZE;
+    while (g * NODE_SIZE <= perPart / NODE_SIZE) {
+        g *= NODE_SIZE;
+    }
+
+    std::vector<size_t> points(k + 1);
+    for (size_t i = 1; i < k; ++i) {
+        size_t target = perPart * i + (tree % k) * i / k;
+        points[i] = target / g * g;
+    }
+    points[k] = count_;
+    return points;
+}
+
+VectorNode* PersistentList::assembleTree(size_t start, size_t end, uint32_t& shift) const {
+    shift = BITS;
+    if (start == end) {
+        return nullptr;
+    }
+
+    // pending[h] collects the children of the open node at height h (leaves
+    // are height 0). Blocks are shared full subtrees aligned both here and
+    // relative to start, taken largest first, so their heights never grow.
+    std::vector<std::vector<VectorNode*>> pending(shift_ / BITS + 2);
+    auto close = [](std::vector<VectorNode*>& children) {
+        VectorNode* node = new VectorNode(children.size());
+        for (VectorNode* child : children) {
+            node->push(child);  // Takes over the reference held by pending
+        }
+        children.clear();
+        return node;
+    };
+
+    size_t pos = start;
+    while (pos < end) {
+        uint32_t height = 0;
+        size_t size = NODE_SIZE;
+        while (height < shift_ / BITS) {
+            size_t next = size * NODE_SIZE;
+            if (start % next != 0 || pos % next != 0 || pos + next > end) {
+                break;
+            }
+            size = next;
+            ++height;
+        }
+        VectorNode* block = nodeAt(pos, height * BITS);
+        block->addRef();
+        pending[height + 1].push_back(block);
+        for (uint32_t h = height + 1; pending[h].size() == NODE_SIZE; ++h) {
+            VectorNode* full = close(pending[h]);
+            full->addRef();
+            pending[h + 1].push_back(full);
+        }
+        pos += size;
+    }
+
+    // Close the right edge bottom-up; empty heights between open nodes get
+    // single-child path nodes
+    VectorNode* root = nullptr;
+    uint32_t height = 0;
+    for (uint32_t h = 1; h < pending.size(); ++h) {
+        if (pending[h].empty() && !root) {
+            continue;
+        }
+        if (root) {
+            pending[h].push_back(root);
+        }
+        root = close(pending[h]);
+        root->addRef();
+        height = h;
+    }
+
+    // Drop single-child roots so the height matches what conj() would build
+    while (height > 1 && root->arraySize() == 1) {
+        VectorNode* child = std::get<VectorNode*>(root->get(0));
+        child->addRef();
+        root->release();
+        root = child;
+        --height;
+    }
+    shift = height * BITS;
+    return root;
+}
+
+std::vector<PersistentList> PersistentList::split(size_t k) const {
+    std::vector<size_t> points = splitPoints(k);
+    std::vector<PersistentList> parts;
+    parts.reserve(k);
+    for (size_t i = 0; i < k; ++i) {
+        size_t start = points[i];
+        size_t stop = points[i + 1];
+        if (start == stop) {
+            parts.emplace_back();
+            continue;
+        }
+        if (start == 0 && stop == count_) {
+            parts.push_back(*this);
+            continue;
+        }
+
+        // The last part keeps this list's tail; the others end on a full
+        // leaf, whose elements become their tail
+        size_t treeEnd = tailOffset();
+        std::shared_ptr<std::vector<py::object>> tail = tail_;
+        if (stop != count_) {
+            treeEnd = stop - NODE_SIZE;
+            VectorNode* leaf = nodeAt(treeEnd, 0);
+            tail = std::make_shared<std::vector<py::object>>();
+            tail->reserve(NODE_SIZE);
+            for (size_t j = 0; j < NODE_SIZE; ++j) {
+                tail->push_back(std::get<py::object>(leaf->get(j)));
+            }
+        }
+
+        uint32_t shift;
+        VectorNode* root = assembleTree(start, treeEnd, shift);
+        parts.push_back(PersistentList(root, tail, stop - start, shift));
+        if (root) root->release();
+    }
+    return parts;
+}
+
+std::vector<size_t> PersistentList::partitionSizes(size_t k) const {
+    std::vector<size_t> points = splitPoints(k);
+    std::vector<size_t> sizes(k);
+    for (size_t i = 0; i < k; ++i) {
+        sizes[i] = points[i + 1] - points[i];
+    }
+    return sizes;
+}
+
+// Sorting
+
+namespace {
+
+// NaN test on the bit pattern; -ffast-math lets the compiler fold isnan()
+bool isNaN(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x7ff0000000000000ULL) == 0x7ff0000000000000ULL &&
+           (bits & 0x000fffffffffffffULL) != 0;
+}
+
+// Stable merge sort of (key, original index) pairs; returns the indices in
+// sorted order. reverse flips each comparison, so equal keys keep their
+// original order as with sorted(reverse=True).
+template <typename T, typename Less>
+std::vector<size_t> sortDecorated(std::vector<std::pair<T, size_t>>& decorated, bool reverse,
+                                  Less less) {
+    std::stable_sort(decorated.begin(), decorated.end(),
+                     [&](const std::pair<T, size_t>& a, const std::pair<T, size_t>& b) {
+                         return reverse ? less(b.first, a.first) : less(a.first, b.first);
+                     });
+    std::vector<size_t> order;
+    order.reserve(decorated.size());
+    for (const auto& entry : decorated) {
+        order.push_back(entry.second);
+    }
+    return order;
+}
+
+// Keys of one exact type int (within int64), float (no NaN) or str are
+// compared natively; anything else goes through rich comparison (<)
+std::vector<size_t> sortOrder(const std::vector<py::object>& keys, bool reverse) {
+    size_t n = keys.size();
+    PyTypeObject* type = n ? Py_TYPE(keys[0].ptr()) : nullptr;
+    for (const py::object& key : keys) {
+        if (Py_TYPE(key.ptr()) != type) {
+            type = nullptr;
+            break;
+        }
+    }
+
+    if (type == &PyLong_Type) {
+        std::vector<std::pair<long long, size_t>> decorated;
+        decorated.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            int overflow = 0;
+            long long value = PyLong_AsLongLongAndOverflow(keys[i].ptr(), &overflow);
+            if (overflow) {
+                break;
+            }
+            decorated.emplace_back(value, i);
+        }
+        if (decorated.size() == n) {
+            return sortDecorated(decorated, reverse, std::less<long long>());
+        }
+    } else if (type == &PyFloat_Type) {
+        std::vector<std::pair<double, size_t>> decorated;
+        decorated.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            double value = PyFloat_AS_DOUBLE(keys[i].ptr());
+            if (isNaN(value)) {
+                break;
+            }
+            decorated.emplace_back(value, i);
+        }
+        if (decorated.size() == n) {
+            return sortDecorated(decorated, reverse, std::less<double>());
+        }
+    }
+
+    std::vector<std::pair<PyObject*, size_t>> decorated;
+    decorated.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        decorated.emplace_back(keys[i].ptr(), i);
+    }
+    if (type == &PyUnicode_Type) {
+        return sortDecorated(decorated, reverse, [](PyObject* a, PyObject* b) {
+            return PyUnicode_Compare(a, b) < 0;
+        });
+    }
+    return sortDecorated(decorated, reverse, [](PyObject* a, PyObject* b) {
+        int result = PyObject_RichCompareBool(a, b, Py_LT);
+        if (result < 0) {
+            throw py::error_already_set();
+        }
+        return result == 1;
+    });
+}
+
+} // namespace
+
+PersistentList PersistentList::sorted(const py::object& key, bool reverse) const {
+    std::vector<py::object> items;
+    items.reserve(count_);
+    forEach([&](const py::object& item) { items.push_back(item); });
+
+    // Decorate once: key is called exactly once per element
+    std::vector<py::object> keys;
+    if (!key.is_none()) {
+        keys.reserve(count_);
+        for (const py::object& item : items) {
+            keys.push_back(key(item));
+        }
+    }
+    std::vector<size_t> order = sortOrder(key.is_none() ? items : keys, reverse);
+
+    std::vector<py::object> result;
+    result.reserve(count_);
+    for (size_t i : order) {
+        result.push_back(std::move(items[i]));
+    }
+    return fromVector(std::move(result));
 }
 
 // Equality
@@ -361,31 +689,198 @@ std::string PersistentList::repr() const {
 // Factory methods
 
 PersistentList PersistentList::fromList(const py::list& l) {
-    PersistentList result;
+    std::vector<py::object> items;
+    items.reserve(l.size());
     for (auto elem : l) {
-        result = result.conj(py::reinterpret_borrow<py::object>(elem));
+        items.push_back(py::reinterpret_borrow<py::object>(elem));
     }
-    return result;
+    return fromVector(std::move(items));
 }
 
 PersistentList PersistentList::fromIterable(const py::object& iterable) {
-    PersistentList result;
+    std::vector<py::object> items;
     try {
         py::iterator it = py::iter(iterable);
         while (it != py::iterator::sentinel()) {
-            result = result.conj(py::reinterpret_borrow<py::object>(*it));
+            items.push_back(py::reinterpret_borrow<py::object>(*it));
             ++it;
         }
-        return result;
     } catch (const py::error_already_set&) {
         throw std::invalid_argument("fromIterable() requires an iterable object");
     }
+    return fromVector(std::move(items));
 }
 
 PersistentList PersistentList::create(const py::args& args) {
-    PersistentList result;
+    std::vector<py::object> items;
+    items.reserve(args.size());
     for (auto elem : args) {
-        result = result.conj(py::reinterpret_borrow<py::object>(elem));
+        items.push_back(py::reinterpret_borrow<py::object>(elem));
     }
-    return result;
+    return fromVector(std::move(items));
+}
+
+PersistentList PersistentList::fromVector(std::vector<py::object>&& items) {
+    size_t n = items.size();
+    if (n == 0) {
+        return PersistentList();
+    }
+
+    // Same split as repeated conj(): the last 1-32 elements form the tail
+    size_t treeCount = n <= NODE_SIZE ? 0 : ((n - 1) >> BITS) << BITS;
+    auto tail = std::make_shared<std::vector<py::object>>(
+        std::make_move_iterator(items.begin() + treeCount),
+        std::make_move_iterator(items.end()));
+    if (treeCount == 0) {
+        return PersistentList(nullptr, tail, n, BITS);
+    }
+
+    // Full leaves
+    std::vector<VectorNode*> level;
+    level.reserve(treeCount >> BITS);
+    for (size_t i = 0; i < treeCount; i += NODE_SIZE) {
+        VectorNode* leaf = new VectorNode(NODE_SIZE);
+        for (size_t j = i; j < i + NODE_SIZE; ++j) {
+            leaf->push(std::move(items[j]));
+        }
+        level.push_back(leaf);
+    }
+
+    // Parents until a single root remains; the root always sits at least
+    // one level above the leaves (shift >= BITS)
+    uint32_t shift = BITS;
+    while (true) {
+        std::vector<VectorNode*> parents;
+        parents.reserve((level.size() + MASK) >> BITS);
+        for (size_t i = 0; i < level.size(); i += NODE_SIZE) {
+            size_t end = std::min(level.size(), i + NODE_SIZE);
+            VectorNode* parent = new VectorNode(end - i);
+            for (size_t j = i; j < end; ++j) {
+                level[j]->addRef();
+                parent->push(level[j]);
+            }
+            parents.push_back(parent);
+        }
+        if (parents.size() == 1) {
+            return PersistentList(parents[0], tail, n, shift);
+        }
+        level = std::move(parents);
+        shift += BITS;
+    }
+}
+
+// ListCursor implementation
+
+ListCursor::ListCursor(const PersistentList& list)
+    : root_(list.root_), tail_(list.tail_), count_(list.count_), shift_(list.shift_),
+      tailOwned_(false), focusBase_(0) {
+    if (root_) root_->addRef();
+}
+
+ListCursor::~ListCursor() {
+    if (root_) root_->release();
+}
+
+size_t ListCursor::tailOffset() const {
+    if (count_ < PersistentList::NODE_SIZE) return 0;
+    return ((count_ - 1) >> PersistentList::BITS) << PersistentList::BITS;
+}
+
+size_t ListCursor::commonDepth(size_t idx, uint32_t& level) const {
+    // Climb from the focus leaf while the node does not cover idx
+    size_t diff = idx ^ focusBase_;
+    size_t depth = display_.size() - 1;
+    level = 0;
+    while ((diff >> (level + PersistentList::BITS)) != 0) {
+        level += PersistentList::BITS;
+        --depth;
+    }
+    return depth;
+}
+
+py::object ListCursor::get(size_t idx) const {
+    if (idx >= count_) {
+        throw std::out_of_range("Index out of range");
+    }
+    if (idx >= tailOffset()) {
+        return (*tail_)[idx - tailOffset()];
+    }
+    const VectorNode* node = root_;
+    uint32_t level = shift_;
+    if (!display_.empty()) {
+        node = display_[commonDepth(idx, level)];
+    }
+    for (; level > 0; level -= PersistentList::BITS) {
+        node = std::get<VectorNode*>(node->get((idx >> level) & PersistentList::MASK));
+    }
+    return std::get<py::object>(node->get(idx & PersistentList::MASK));
+}
+
+VectorNode* ListCursor::editableLeaf(size_t idx) {
+    uint32_t level = shift_;
+    if (display_.empty()) {
+        if (!owned_.count(root_)) {
+            VectorNode* copy = root_->clone();
+            copy->addRef();
+            root_->release();
+            root_ = copy;
+            owned_.insert(copy);
+        }
+        display_.push_back(root_);
+    } else {
+        if (idx - focusBase_ < PersistentList::NODE_SIZE) {
+            return display_.back();
+        }
+        display_.resize(commonDepth(idx, level) + 1);
+    }
+
+    // Below the common ancestor: clone every node not yet owned
+    for (; level > 0; level -= PersistentList::BITS) {
+        VectorNode* node = display_.back();
+        size_t sub = (idx >> level) & PersistentList::MASK;
+        VectorNode* child = std::get<VectorNode*>(node->get(sub));
+        if (!owned_.count(child)) {
+            VectorNode* copy = child->clone();
+            copy->addRef();
+            node->set(sub, copy);
+            child->release();
+            owned_.insert(copy);
+            child = copy;
+        }
+        display_.push_back(child);
+    }
+
+    focusBase_ = idx & ~static_cast<size_t>(PersistentList::MASK);
+    return display_.back();
+}
+
+void ListCursor::set(size_t idx, const py::object& val) {
+    if (idx >= count_) {
+        throw std::out_of_range("Index out of range");
+    }
+    size_t offset = tailOffset();
+    if (idx >= offset) {
+        if (!tailOwned_) {
+            tail_ = std::make_shared<std::vector<py::object>>(*tail_);
+            tailOwned_ = true;
+        }
+        (*tail_)[idx - offset] = val;
+        return;
+    }
+    editableLeaf(idx)->set(idx & PersistentList::MASK, val);
+}
+
+void ListCursor::setRange(size_t start, const py::iterable& values) {
+    size_t idx = start;
+    for (auto value : values) {
+        set(idx++, py::reinterpret_borrow<py::object>(value));
+    }
+}
+
+PersistentList ListCursor::commit() {
+    // The returned list shares every node; none may be written again
+    owned_.clear();
+    display_.clear();
+    tailOwned_ = false;
+    return PersistentList(root_, tail_, count_, shift_);
 }
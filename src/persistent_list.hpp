@@ -7,12 +7,23 @@
 #include <variant>
 #include <memory>
 #include <string>
+#include <unordered_set>
+#include "tracked_alloc.hpp"
 
 namespace py = pybind11;
 
 // Forward declarations
 class VectorNode;
 class VectorIterator;
+class ReverseVectorIterator;
+class ListCursor;
+
+// Bits of index consumed per tree level (see PersistentList)
+#ifndef PYPERSISTENT_VECTOR_BITS
+#define PYPERSISTENT_VECTOR_BITS 5
+#endif
+static_assert(PYPERSISTENT_VECTOR_BITS >= 4 && PYPERSISTENT_VECTOR_BITS <= 6,
+              "PYPERSISTENT_VECTOR_BITS must be 4, 5 or 6");
 
 /**
  * PersistentList - Indexed sequence with O(log₃₂ n) access
@@ -30,15 +41,20 @@ class VectorIterator;
  * - Each node has up to 32 children (5 bits per level)
  * - Last 0-32 elements stored in separate tail for fast append
  * - Path copying for updates (only O(log n) nodes copied)
+ *
+ * The width is fixed at compile time with -DPYPERSISTENT_VECTOR_BITS=4|5|6
+ * (16-, 32- or 64-way nodes; the figures above are for the default of 5).
  */
 class PersistentList {
+    friend class ListCursor;
+
 private:
     VectorNode* root_;                                          // Tree root
     std::shared_ptr<std::vector<py::object>> tail_;            // Last 0-32 elements
     size_t count_;                                             // Total elements
     uint32_t shift_;                                           // Tree depth (5 * levels)
 
-    static constexpr uint32_t BITS = 5;                        // 2^5 = 32-way branching
+    static constexpr uint32_t BITS = PYPERSISTENT_VECTOR_BITS; // 2^5 = 32-way branching by default
     static constexpr uint32_t NODE_SIZE = 1 << BITS;           // 32
     static constexpr uint32_t MASK = NODE_SIZE - 1;            // 0x1F
 
@@ -54,6 +70,17 @@ private:
     // Helper: create new path for expanding tree
     VectorNode* newPath(uint32_t level, VectorNode* node) const;
 
+    // Helper: node at the given level on the path to idx (level 0 = leaf)
+    VectorNode* nodeAt(size_t idx, uint32_t level) const;
+
+    // Helper: partition boundaries for split(); parts[i] = [points[i], points[i+1])
+    std::vector<size_t> splitPoints(size_t k) const;
+
+    // Helper: trie holding elements [start, end) of this tree, built from
+    // shared subtrees. Returns the root with one reference owned by the
+    // caller (nullptr if empty) and sets shift.
+    VectorNode* assembleTree(size_t start, size_t end, uint32_t& shift) const;
+
     // Helper: calculate tail offset (index where tail starts)
     size_t tailOffset() const {
         if (count_ < NODE_SIZE) return 0;
@@ -86,6 +113,14 @@ public:
     PersistentList assoc(size_t idx, const py::object& val) const;       // Update at index
     py::object nth(size_t idx) const;                                    // Get at index
     py::object get(size_t idx, const py::object& default_val) const;     // Get with default
+
+    // nth() for walks: reuses the leaf found by the previous call while idx
+    // stays inside it, so sequential and small-stride reads skip the descent
+    struct LeafCache {
+        const VectorNode* leaf = nullptr;
+        size_t base = static_cast<size_t>(-1);
+    };
+    py::object nthCached(size_t idx, LeafCache& cache) const;
     PersistentList pop() const;                                          // Remove last
 
     // Python-friendly aliases
@@ -97,13 +132,33 @@ public:
 
     // Iteration
     VectorIterator iter() const;
+    ReverseVectorIterator reversed() const;
 
     // Fast materialized list
     py::list list() const;
 
+    // Visit every element in order without per-index descent
+    template <typename F>
+    void forEach(F&& fn) const;
+
     // Slicing
     PersistentList slice(Py_ssize_t start, Py_ssize_t stop) const;
 
+    // length elements from start, step apart (step may be negative), as
+    // computed by PySlice_AdjustIndices
+    PersistentList strided(Py_ssize_t start, Py_ssize_t step, size_t length) const;
+
+    // Elements at the given indices (negative allowed), in the given order
+    PersistentList take(const py::iterable& indices) const;
+
+    // Stable sort by key(element) (or the element); reverse keeps the order
+    // of equal elements, like Python's sorted()
+    PersistentList sorted(const py::object& key, bool reverse) const;
+
+    // Partitioning: k contiguous parts sharing subtrees with this list
+    std::vector<PersistentList> split(size_t k) const;
+    std::vector<size_t> partitionSizes(size_t k) const;
+
     // Equality
     bool operator==(const PersistentList& other) const;
     bool operator!=(const PersistentList& other) const { return !(*this == other); }
@@ -115,6 +170,10 @@ public:
     static PersistentList fromList(const py::list& l);
     static PersistentList fromIterable(const py::object& iterable);
     static PersistentList create(const py::args& args);
+
+    // Bulk construction: builds full leaves and parents level by level
+    // instead of appending (and copying the tail) once per element
+    static PersistentList fromVector(std::vector<py::object>&& items);
 };
 
 /**
@@ -126,10 +185,11 @@ public:
  *
  * Uses intrusive reference counting for memory management.
  */
-class VectorNode {
+class VectorNode : public pmalloc::Tracked<pmalloc::DOMAIN_LIST> {
 private:
     mutable std::atomic<uint32_t> refcount_;
-    std::vector<std::variant<py::object, VectorNode*>> array_;
+    std::vector<std::variant<py::object, VectorNode*>,
+                pmalloc::TrackedAllocator<std::variant<py::object, VectorNode*>, pmalloc::DOMAIN_LIST>> array_;
 
 public:
     // Constructors
@@ -177,6 +237,10 @@ public:
         array_.push_back(val);
     }
 
+    void push(py::object&& val) {
+        array_.push_back(std::move(val));
+    }
+
     void push(VectorNode* node) {
         array_.push_back(node);
     }
@@ -185,6 +249,32 @@ public:
     VectorNode* clone() const;
 };
 
+template <typename F>
+void PersistentList::forEach(F&& fn) const {
+    // Tree elements are stored in index order across full leaves
+    std::vector<std::pair<const VectorNode*, size_t>> stack;
+    if (root_ && tailOffset() > 0) {
+        stack.emplace_back(root_, 0);
+    }
+    uint32_t depth = shift_ / BITS;
+    while (!stack.empty()) {
+        auto& [node, i] = stack.back();
+        if (i == node->arraySize()) {
+            stack.pop_back();
+            continue;
+        }
+        const auto& slot = node->get(i++);
+        if (stack.size() > depth) {
+            fn(std::get<py::object>(slot));
+        } else {
+            stack.emplace_back(std::get<VectorNode*>(slot), 0);
+        }
+    }
+    for (const auto& elem : *tail_) {
+        fn(elem);
+    }
+}
+
 /**
  * VectorIterator - Iterator for PersistentList
  */
@@ -205,3 +295,75 @@ public:
         return vec_->nth(index_++);
     }
 };
+
+// Iterates from the last element to the first, one leaf lookup per 32
+// elements. Holds its own reference to the list.
+class ReverseVectorIterator {
+private:
+    PersistentList vec_;
+    size_t remaining_;
+    PersistentList::LeafCache cache_;
+
+public:
+    ReverseVectorIterator(const PersistentList& vec) : vec_(vec), remaining_(vec.size()) {}
+
+    bool hasNext() const { return remaining_ > 0; }
+
+    py::object next() {
+        if (!hasNext()) {
+            throw py::stop_iteration();
+        }
+        return vec_.nthCached(--remaining_, cache_);
+    }
+};
+
+/**
+ * ListCursor - Batch of in-place edits to a PersistentList
+ *
+ * The first write to a node clones it and records the clone as owned by
+ * the cursor. Owned nodes are reachable only through the cursor's root, so
+ * later writes below them mutate in place. The path to the leaf last
+ * written (the focus) is kept as a display stack, as in Scala's Vector:
+ * writes to the focus leaf skip the descent, and moving the focus
+ * re-descends only from the lowest common ancestor of the old and new
+ * index. Moving to a neighbouring leaf usually replaces just the leaf, so
+ * patching a window costs O(1) amortized per element; a jump across the
+ * tree costs O(depth). The tail is copied once, on its first write.
+ *
+ * commit() returns a PersistentList sharing the edited nodes and gives up
+ * ownership, so the next write copies again and committed lists are never
+ * modified. The source list is never modified. Not thread-safe.
+ */
+class ListCursor {
+public:
+    explicit ListCursor(const PersistentList& list);
+    ~ListCursor();
+
+    ListCursor(const ListCursor&) = delete;
+    ListCursor& operator=(const ListCursor&) = delete;
+
+    size_t size() const { return count_; }
+    py::object get(size_t idx) const;
+    void set(size_t idx, const py::object& val);
+
+    // Writes values to consecutive indices from start
+    void setRange(size_t start, const py::iterable& values);
+
+    PersistentList commit();
+
+private:
+    VectorNode* root_;  // One reference held by the cursor
+    std::shared_ptr<std::vector<py::object>> tail_;
+    size_t count_;
+    uint32_t shift_;
+    bool tailOwned_;
+    std::unordered_set<const VectorNode*> owned_;  // Consulted below the common ancestor only
+    std::vector<VectorNode*> display_;  // Owned path from the root to the focus leaf, or empty
+    size_t focusBase_;                  // First index of the focus leaf
+
+    size_t tailOffset() const;
+
+    // Depth in display_ of the deepest node also covering idx, and its level
+    size_t commonDepth(size_t idx, uint32_t& level) const;
+    VectorNode* editableLeaf(size_t idx);
+};
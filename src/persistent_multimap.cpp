@@ -0,0 +1,241 @@
+#include "persistent_multimap.hpp"
+#include "type_slots.hpp"
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Grouping buffer for bulk construction: one py::set per distinct key, in
+// first-seen order. Sets dedup values at C speed before the trees are built.
+struct PairGroups {
+    py::dict index;                 // key -> position in keys/values
+    std::vector<py::object> keys;
+    std::vector<py::set> values;
+
+    void add(const py::object& key, const py::object& value) {
+        PyObject* slot = PyDict_GetItemWithError(index.ptr(), key.ptr());
+        size_t pos;
+        if (slot != nullptr) {
+            pos = PyLong_AsSize_t(slot);
+        } else {
+            if (PyErr_Occurred()) {
+                throw py::error_already_set();
+            }
+            pos = keys.size();
+            index[key] = py::int_(pos);
+            keys.push_back(key);
+            values.emplace_back();
+        }
+        if (PySet_Add(values[pos].ptr(), value.ptr()) < 0) {
+            throw py::error_already_set();
+        }
+    }
+
+    PersistentMultiMap build() const {
+        std::vector<std::pair<py::object, py::object>> outer;
+        outer.reserve(keys.size());
+        size_t total = 0;
+
+        for (size_t i = 0; i < keys.size(); ++i) {
+            std::vector<std::pair<py::object, py::object>> inner;
+            inner.reserve(values[i].size());
+            for (auto v : values[i]) {
+                inner.emplace_back(py::reinterpret_borrow<py::object>(v), py::none());
+            }
+            total += inner.size();
+            outer.emplace_back(keys[i], py::cast(PersistentSet(PersistentDict::fromEntries(inner))));
+        }
+
+        return PersistentMultiMap(PersistentDict::fromEntries(outer), total);
+    }
+};
+
+}  // namespace
+
+// Core operations
+PersistentMultiMap PersistentMultiMap::add(const py::object& key, const py::object& value) const {
+    bool added = false;
+    PersistentDict newMap = map_.alter(key, [&](const py::object& old) -> py::object {
+        if (!old) {
+            added = true;
+            return py::cast(PersistentSet().conj(value));
+        }
+        const PersistentSet& values = old.cast<const PersistentSet&>();
+        if (values.contains(value)) {
+            return old;  // Unchanged - alter keeps the existing node
+        }
+        added = true;
+        return py::cast(values.conj(value));
+    });
+
+    if (!added) {
+        return *this;
+    }
+    return PersistentMultiMap(newMap, count_ + 1);
+}
+
+PersistentMultiMap PersistentMultiMap::remove(const py::object& key, const py::object& value) const {
+    bool removed = false;
+    PersistentDict newMap = map_.alter(key, [&](const py::object& old) -> py::object {
+        if (!old) {
+            return py::object();
+        }
+        const PersistentSet& values = old.cast<const PersistentSet&>();
+        if (!values.contains(value)) {
+            return old;
+        }
+        removed = true;
+        if (values.size() == 1) {
+            return py::object();  // Last value - drop the key
+        }
+        return py::cast(values.disj(value));
+    });
+
+    if (!removed) {
+        return *this;
+    }
+    return PersistentMultiMap(newMap, count_ - 1);
+}
+
+PersistentMultiMap PersistentMultiMap::removeAll(const py::object& key) const {
+    size_t removed = 0;
+    PersistentDict newMap = map_.alter(key, [&](const py::object& old) -> py::object {
+        if (old) {
+            removed = old.cast<const PersistentSet&>().size();
+        }
+        return py::object();
+    });
+
+    if (removed == 0) {
+        return *this;
+    }
+    return PersistentMultiMap(newMap, count_ - removed);
+}
+
+PersistentSet PersistentMultiMap::get(const py::object& key) const {
+    py::object values = map_.get(key, PersistentDict::NOT_FOUND);
+    if (values.is(PersistentDict::NOT_FOUND)) {
+        return PersistentSet();
+    }
+    return values.cast<PersistentSet>();
+}
+
+py::object PersistentMultiMap::pyGetItem(const py::object& key) const {
+    py::object values = map_.get(key, PersistentDict::NOT_FOUND);
+    if (values.is(PersistentDict::NOT_FOUND)) {
+        pslots::throwKeyError(key);
+    }
+    return values;
+}
+
+bool PersistentMultiMap::contains(const py::object& key, const py::object& value) const {
+    py::object values = map_.get(key, PersistentDict::NOT_FOUND);
+    if (values.is(PersistentDict::NOT_FOUND)) {
+        return false;
+    }
+    return values.cast<const PersistentSet&>().contains(value);
+}
+
+size_t PersistentMultiMap::count(const py::object& key) const {
+    py::object values = map_.get(key, PersistentDict::NOT_FOUND);
+    if (values.is(PersistentDict::NOT_FOUND)) {
+        return 0;
+    }
+    return values.cast<const PersistentSet&>().size();
+}
+
+PersistentMultiMap PersistentMultiMap::merge(const PersistentMultiMap& other) const {
+    // Pairs present on both sides are counted once; the combine callback
+    // sees every shared key exactly once, so it can track the overlap
+    size_t overlap = 0;
+    PersistentDict merged = map_.mergeWith(other.map_,
+        [&](const py::object& left, const py::object& right) -> py::object {
+            const PersistentSet& l = left.cast<const PersistentSet&>();
+            const PersistentSet& r = right.cast<const PersistentSet&>();
+            PersistentSet u = l.size() >= r.size() ? l.union_(r) : r.union_(l);
+            overlap += l.size() + r.size() - u.size();
+            return py::cast(u);
+        });
+    return PersistentMultiMap(merged, count_ + other.count_ - overlap);
+}
+
+py::list PersistentMultiMap::pairsList() const {
+    py::list result(count_);
+    size_t idx = 0;
+    for (auto item : map_.itemsList()) {
+        py::tuple kv = item.cast<py::tuple>();
+        py::object key = kv[0];
+        for (auto value : kv[1].cast<const PersistentSet&>().list()) {
+            result[idx++] = py::make_tuple(key, value);
+        }
+    }
+    return result;
+}
+
+py::dict PersistentMultiMap::toDict() const {
+    py::dict result = pmutils::presizedDict(map_.size());
+    map_.forEachEntry([&](const Entry& entry) {
+        py::set values = entry.value.cast<const PersistentSet&>().toSet();
+        pmutils::dictSetItemKnownHash(result, entry.key, values, entry.hash);
+    });
+    return result;
+}
+
+// Equality
+bool PersistentMultiMap::operator==(const PersistentMultiMap& other) const {
+    if (count_ != other.count_) return false;
+    return map_ == other.map_;  // Inner sets compare with PersistentSet.__eq__
+}
+
+// String representation
+std::string PersistentMultiMap::repr() const {
+    std::ostringstream oss;
+    oss << "PersistentMultiMap({";
+
+    bool first = true;
+    for (auto item : map_.itemsList()) {
+        if (!first) oss << ", ";
+        first = false;
+
+        py::tuple kv = item.cast<py::tuple>();
+        oss << py::repr(kv[0]).cast<std::string>() << ": {";
+        bool firstValue = true;
+        for (auto value : kv[1].cast<const PersistentSet&>().list()) {
+            if (!firstValue) oss << ", ";
+            firstValue = false;
+            oss << py::repr(value).cast<std::string>();
+        }
+        oss << "}";
+    }
+
+    oss << "})";
+    return oss.str();
+}
+
+// Factory methods
+PersistentMultiMap PersistentMultiMap::fromPairs(const py::object& pairs) {
+    PairGroups groups;
+    py::iterator it = py::iter(pairs);
+    while (it != py::iterator::sentinel()) {
+        py::tuple kv(py::reinterpret_borrow<py::object>(*it));  // Accepts any 2-sequence
+        if (kv.size() != 2) {
+            throw std::invalid_argument("from_pairs() requires (key, value) pairs");
+        }
+        groups.add(kv[0], kv[1]);
+        ++it;
+    }
+    return groups.build();
+}
+
+PersistentMultiMap PersistentMultiMap::fromDict(const py::dict& d) {
+    PairGroups groups;
+    for (auto item : d) {
+        py::object key = py::reinterpret_borrow<py::object>(item.first);
+        py::iterator it = py::iter(item.second);
+        while (it != py::iterator::sentinel()) {
+            groups.add(key, py::reinterpret_borrow<py::object>(*it));
+            ++it;
+        }
+    }
+    return groups.build();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <string>
+#include "persistent_dict.hpp"
+#include "persistent_set.hpp"
+
+namespace py = pybind11;
+
+/**
+ * PersistentMultiMap - Immutable multimap (key -> set of values)
+ *
+ * Stored as a PersistentDict mapping each key to a non-empty PersistentSet.
+ * add/remove update the inner set and the outer map in a single descent of
+ * the outer HAMT (PersistentDict::alter), so there is no separate get/assoc
+ * round trip.
+ *
+ * len() is the total number of (key, value) pairs; key_count() is the number
+ * of distinct keys.
+ */
+class PersistentMultiMap {
+private:
+    PersistentDict map_;  // key -> PersistentSet (never empty)
+    size_t count_;        // Total number of (key, value) pairs
+
+public:
+    // Constructors
+    PersistentMultiMap() : map_(), count_(0) {}
+    PersistentMultiMap(const PersistentDict& map, size_t count) : map_(map), count_(count) {}
+
+    // Core operations (functional style)
+    PersistentMultiMap add(const py::object& key, const py::object& value) const;
+    PersistentMultiMap remove(const py::object& key, const py::object& value) const;
+    PersistentMultiMap removeAll(const py::object& key) const;
+
+    // Values for key (empty set if key is absent)
+    PersistentSet get(const py::object& key) const;
+    py::object pyGetItem(const py::object& key) const;  // Raises KeyError
+    bool containsKey(const py::object& key) const { return map_.contains(key); }
+    bool contains(const py::object& key, const py::object& value) const;
+    size_t count(const py::object& key) const;
+
+    // Union of values per key
+    PersistentMultiMap merge(const PersistentMultiMap& other) const;
+
+    // Size
+    size_t size() const { return count_; }
+    size_t keyCount() const { return map_.size(); }
+
+    // Iteration
+    KeyIterator keys() const { return map_.keys(); }
+    py::list keysList() const { return map_.keysList(); }
+    py::list itemsList() const { return map_.itemsList(); }  // (key, PersistentSet)
+    py::list pairsList() const;                              // Flattened (key, value)
+    py::dict toDict() const;                                 // key -> set of values
+
+    // Equality
+    bool operator==(const PersistentMultiMap& other) const;
+    bool operator!=(const PersistentMultiMap& other) const { return !(*this == other); }
+
+    // String representation
+    std::string repr() const;
+
+    // Factory methods
+    static PersistentMultiMap fromPairs(const py::object& pairs);
+    static PersistentMultiMap fromDict(const py::dict& d);  // key -> iterable of values
+
+    // Access to underlying map (for implementation)
+    const PersistentDict& getMap() const { return map_; }
+};
@@ -0,0 +1,300 @@
+#include "persistent_ordered_dict.hpp"
+#include "type_slots.hpp"
+#include <sstream>
+#include <vector>
+
+// Core operations
+PersistentOrderedDict PersistentOrderedDict::assoc(const py::object& key, const py::object& val) const {
+    // Single HAMT descent: reuse the slot of an existing key, or claim the
+    // next one
+    size_t pos = slots_.size();
+    bool existed = false;
+    PersistentDict newIndex = index_.alter(key, [&](const py::object& old) -> py::object {
+        if (old) {
+            pos = old.cast<size_t>();
+            existed = true;
+            return old;
+        }
+        return py::int_(pos);
+    });
+
+    if (existed) {
+        py::object slot = slots_.nth(pos);
+        if (slot.cast<py::tuple>()[1].is(val)) {
+            return *this;
+        }
+        py::tuple entry = py::make_tuple(slot.cast<py::tuple>()[0], val);
+        return PersistentOrderedDict(index_, slots_.assoc(pos, entry), count_);
+    }
+
+    return PersistentOrderedDict(newIndex, slots_.conj(py::make_tuple(key, val)), count_ + 1);
+}
+
+PersistentOrderedDict PersistentOrderedDict::dissoc(const py::object& key) const {
+    py::object pos;
+    PersistentDict newIndex = index_.alter(key, [&](const py::object& old) -> py::object {
+        pos = old;
+        return py::object();
+    });
+
+    if (!pos) {
+        return *this;  // Key not found
+    }
+
+    size_t idx = pos.cast<size_t>();
+    PersistentOrderedDict result(newIndex, slots_.assoc(idx, py::none()), count_ - 1);
+
+    if (result.count_ == 0) {
+        return PersistentOrderedDict();
+    }
+    if (result.slots_.size() >= MIN_COMPACT_SLOTS && result.count_ * 2 < result.slots_.size()) {
+        return result.compact();
+    }
+    return result;
+}
+
+py::object PersistentOrderedDict::get(const py::object& key, const py::object& default_val) const {
+    py::object pos = index_.get(key, PersistentDict::NOT_FOUND);
+    if (pos.is(PersistentDict::NOT_FOUND)) {
+        return default_val;
+    }
+    return slots_.nth(pos.cast<size_t>()).cast<py::tuple>()[1];
+}
+
+py::object PersistentOrderedDict::pyGetItem(const py::object& key) const {
+    py::object value = find(key);
+    if (!value) {
+        pslots::throwKeyError(key);
+    }
+    return value;
+}
+
+py::object PersistentOrderedDict::find(const py::object& key) const {
+    py::object pos = index_.get(key, py::object());
+    if (!pos) {
+        return pos;
+    }
+    return slots_.nth(pos.cast<size_t>()).cast<py::tuple>()[1];
+}
+
+PersistentOrderedDict PersistentOrderedDict::compact() const {
+    std::vector<std::pair<py::object, py::object>> entries;
+    entries.reserve(count_);
+    py::list slots;
+
+    for (auto slot : slots_.list()) {
+        if (slot.is_none()) {
+            continue;
+        }
+        py::tuple kv = slot.cast<py::tuple>();
+        entries.emplace_back(kv[0], py::int_(entries.size()));
+        slots.append(kv);
+    }
+
+    return PersistentOrderedDict(PersistentDict::fromEntries(entries),
+                                 PersistentList::fromList(slots), entries.size());
+}
+
+PersistentOrderedDict PersistentOrderedDict::update(const py::object& other) const {
+    PersistentOrderedDict result = *this;
+
+    if (py::isinstance<PersistentOrderedDict>(other)) {
+        for (auto item : other.cast<const PersistentOrderedDict&>().itemsList()) {
+            py::tuple kv = item.cast<py::tuple>();
+            result = result.assoc(kv[0], kv[1]);
+        }
+        return result;
+    }
+
+    if (py::isinstance<py::dict>(other)) {
+        for (auto item : other.cast<py::dict>()) {
+            result = result.assoc(py::reinterpret_borrow<py::object>(item.first),
+                                  py::reinterpret_borrow<py::object>(item.second));
+        }
+        return result;
+    }
+
+    try {
+        py::object items = other.attr("items")();
+        for (auto item : items) {
+            py::tuple kv = item.cast<py::tuple>();
+            result = result.assoc(kv[0], kv[1]);
+        }
+    } catch (...) {
+        throw py::type_error("update() requires a dict, PersistentOrderedDict, or mapping");
+    }
+    return result;
+}
+
+// Ordered access
+py::tuple PersistentOrderedDict::first() const {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        py::object slot = slots_.nth(i);
+        if (!slot.is_none()) {
+            return slot.cast<py::tuple>();
+        }
+    }
+    throw std::runtime_error("Cannot get first() of empty map");
+}
+
+py::tuple PersistentOrderedDict::last() const {
+    for (size_t i = slots_.size(); i > 0; --i) {
+        py::object slot = slots_.nth(i - 1);
+        if (!slot.is_none()) {
+            return slot.cast<py::tuple>();
+        }
+    }
+    throw std::runtime_error("Cannot get last() of empty map");
+}
+
+// Iteration
+OrderedDictIterator PersistentOrderedDict::keys() const {
+    return OrderedDictIterator(slots_, OrderedDictIterator::Mode::Keys);
+}
+
+OrderedDictIterator PersistentOrderedDict::values() const {
+    return OrderedDictIterator(slots_, OrderedDictIterator::Mode::Values);
+}
+
+OrderedDictIterator PersistentOrderedDict::items() const {
+    return OrderedDictIterator(slots_, OrderedDictIterator::Mode::Items);
+}
+
+bool OrderedDictIterator::hasNext() {
+    while (!pending_ && index_ < slots_.size()) {
+        py::object slot = slots_.nth(index_++);
+        if (!slot.is_none()) {  // Skip tombstones
+            pending_ = std::move(slot);
+        }
+    }
+    return static_cast<bool>(pending_);
+}
+
+py::object OrderedDictIterator::next() {
+    if (!hasNext()) {
+        throw py::stop_iteration();
+    }
+    py::object slot = std::move(pending_);
+    switch (mode_) {
+        case Mode::Keys: return slot.cast<py::tuple>()[0];
+        case Mode::Values: return slot.cast<py::tuple>()[1];
+        case Mode::Items: break;
+    }
+    return slot;
+}
+
+py::list PersistentOrderedDict::keysList() const {
+    py::list result(count_);
+    size_t idx = 0;
+    for (auto slot : slots_.list()) {
+        if (!slot.is_none()) {
+            result[idx++] = slot.cast<py::tuple>()[0];
+        }
+    }
+    return result;
+}
+
+py::list PersistentOrderedDict::valuesList() const {
+    py::list result(count_);
+    size_t idx = 0;
+    for (auto slot : slots_.list()) {
+        if (!slot.is_none()) {
+            result[idx++] = slot.cast<py::tuple>()[1];
+        }
+    }
+    return result;
+}
+
+py::list PersistentOrderedDict::itemsList() const {
+    py::list result(count_);
+    size_t idx = 0;
+    for (auto slot : slots_.list()) {
+        if (!slot.is_none()) {
+            result[idx++] = slot;
+        }
+    }
+    return result;
+}
+
+py::dict PersistentOrderedDict::toDict() const {
+    py::dict result = pmutils::presizedDict(count_);
+    slots_.forEach([&](const py::object& slot) {
+        if (!slot.is_none()) {
+            PyObject* kv = slot.ptr();
+            if (PyDict_SetItem(result.ptr(), PyTuple_GET_ITEM(kv, 0), PyTuple_GET_ITEM(kv, 1)) < 0) {
+                throw py::error_already_set();
+            }
+        }
+    });
+    return result;
+}
+
+// Equality
+bool PersistentOrderedDict::operator==(const PersistentOrderedDict& other) const {
+    if (count_ != other.count_) {
+        return false;
+    }
+    py::list mine = itemsList();
+    py::list theirs = other.itemsList();
+    int result = PyObject_RichCompareBool(mine.ptr(), theirs.ptr(), Py_EQ);
+    if (result == -1) {
+        throw py::error_already_set();
+    }
+    return result == 1;
+}
+
+// String representation
+std::string PersistentOrderedDict::repr() const {
+    std::ostringstream oss;
+    oss << "PersistentOrderedDict({";
+
+    bool first = true;
+    for (auto item : itemsList()) {
+        if (!first) oss << ", ";
+        first = false;
+
+        py::tuple kv = item.cast<py::tuple>();
+        oss << py::repr(kv[0]).cast<std::string>() << ": "
+            << py::repr(kv[1]).cast<std::string>();
+    }
+
+    oss << "})";
+    return oss.str();
+}
+
+// Factory methods
+PersistentOrderedDict PersistentOrderedDict::fromDict(const py::dict& d) {
+    // A dict already has unique keys in insertion order, so both structures
+    // can be built in one pass
+    std::vector<std::pair<py::object, py::object>> entries;
+    entries.reserve(d.size());
+    py::list slots(d.size());
+
+    for (auto item : d) {
+        py::object key = py::reinterpret_borrow<py::object>(item.first);
+        slots[entries.size()] = py::make_tuple(key, py::reinterpret_borrow<py::object>(item.second));
+        entries.emplace_back(key, py::int_(entries.size()));
+    }
+
+    return PersistentOrderedDict(PersistentDict::fromEntries(entries),
+                                 PersistentList::fromList(slots), entries.size());
+}
+
+PersistentOrderedDict PersistentOrderedDict::fromItems(const py::object& items) {
+    // Collapse duplicates with dict semantics: first position, last value
+    py::dict d;
+    py::iterator it = py::iter(items);
+    while (it != py::iterator::sentinel()) {
+        py::tuple kv(py::reinterpret_borrow<py::object>(*it));
+        if (kv.size() != 2) {
+            throw std::invalid_argument("from_items() requires (key, value) pairs");
+        }
+        d[kv[0]] = kv[1];
+        ++it;
+    }
+    return fromDict(d);
+}
+
+PersistentOrderedDict PersistentOrderedDict::create(const py::kwargs& kw) {
+    return fromDict(kw);
+}
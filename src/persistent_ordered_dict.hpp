@@ -0,0 +1,115 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <string>
+#include "persistent_dict.hpp"
+#include "persistent_list.hpp"
+
+namespace py = pybind11;
+
+// Forward declaration
+class OrderedDictIterator;
+
+/**
+ * PersistentOrderedDict - Insertion-ordered persistent map
+ *
+ * Combines two persistent structures:
+ * - index_: PersistentDict mapping key -> slot number
+ * - slots_: PersistentList of (key, value) tuples in insertion order, with
+ *   None tombstones left behind by dissoc
+ *
+ * assoc/dissoc/get are O(log32 n): one HAMT descent plus one vector
+ * path copy. Updating an existing key keeps its position (dict semantics).
+ * When tombstones outnumber live entries the slots are compacted, so the
+ * O(n) rebuild is amortised over at least n/2 deletions.
+ */
+class PersistentOrderedDict {
+private:
+    PersistentDict index_;   // key -> slot number (Python int)
+    PersistentList slots_;   // (key, value) tuple or None
+    size_t count_;           // Live entries
+
+    static constexpr size_t MIN_COMPACT_SLOTS = 32;  // Don't compact tiny dicts
+
+    PersistentOrderedDict(const PersistentDict& index, const PersistentList& slots, size_t count)
+        : index_(index), slots_(slots), count_(count) {}
+
+    // Rebuild index and slots without tombstones
+    PersistentOrderedDict compact() const;
+
+public:
+    // Constructors
+    PersistentOrderedDict() : index_(), slots_(), count_(0) {}
+
+    // Core operations (functional style)
+    PersistentOrderedDict assoc(const py::object& key, const py::object& val) const;
+    PersistentOrderedDict dissoc(const py::object& key) const;
+    py::object get(const py::object& key, const py::object& default_val = py::none()) const;
+    py::object pyGetItem(const py::object& key) const;  // Raises KeyError
+    py::object find(const py::object& key) const;       // Null object if absent
+    bool contains(const py::object& key) const { return index_.contains(key); }
+
+    // Python-friendly aliases
+    PersistentOrderedDict set(const py::object& key, const py::object& val) const { return assoc(key, val); }
+    PersistentOrderedDict delete_(const py::object& key) const { return dissoc(key); }
+    PersistentOrderedDict update(const py::object& other) const;
+
+    // Ordered access
+    py::tuple first() const;
+    py::tuple last() const;
+
+    // Size
+    size_t size() const { return count_; }
+    size_t slotCount() const { return slots_.size(); }  // Including tombstones
+
+    // Iteration in insertion order
+    OrderedDictIterator keys() const;
+    OrderedDictIterator values() const;
+    OrderedDictIterator items() const;
+
+    // Fast materialized iteration
+    py::list keysList() const;
+    py::list valuesList() const;
+    py::list itemsList() const;
+
+    // Plain dict in insertion order, presized
+    py::dict toDict() const;
+
+    // Equality is order-sensitive, like collections.OrderedDict
+    bool operator==(const PersistentOrderedDict& other) const;
+    bool operator!=(const PersistentOrderedDict& other) const { return !(*this == other); }
+
+    // String representation
+    std::string repr() const;
+
+    // Factory methods
+    static PersistentOrderedDict fromDict(const py::dict& d);
+    static PersistentOrderedDict fromItems(const py::object& items);
+    static PersistentOrderedDict create(const py::kwargs& kw);
+};
+
+/**
+ * OrderedDictIterator - Walks the slots in order, skipping tombstones
+ *
+ * Holds its own PersistentList reference, so it stays valid when the
+ * dict it came from is dropped.
+ */
+class OrderedDictIterator {
+public:
+    enum class Mode { Keys, Values, Items };
+
+private:
+    PersistentList slots_;
+    size_t index_;
+    Mode mode_;
+    py::object pending_;  // Next live slot, fetched ahead by hasNext()
+
+public:
+    OrderedDictIterator(const PersistentList& slots, Mode mode)
+        : slots_(slots), index_(0), mode_(mode) {}
+
+    // Skips tombstones and holds the next live slot for next()
+    bool hasNext();
+    py::object next();
+};
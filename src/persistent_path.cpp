@@ -0,0 +1,197 @@
+#include "persistent_path.hpp"
+#include "persistent_dict.hpp"
+#include "persistent_array_map.hpp"
+#include "persistent_list.hpp"
+#include "persistent_sorted_dict.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ppath {
+
+namespace {
+
+enum class Kind { DICT, ARRAY_MAP, SORTED_DICT, LIST, OTHER };
+
+Kind kindOf(py::handle node) {
+    if (py::isinstance<PersistentDict>(node)) return Kind::DICT;
+    if (py::isinstance<PersistentArrayMap>(node)) return Kind::ARRAY_MAP;
+    if (py::isinstance<PersistentSortedDict>(node)) return Kind::SORTED_DICT;
+    if (py::isinstance<PersistentList>(node)) return Kind::LIST;
+    return Kind::OTHER;
+}
+
+std::vector<py::object> toPath(const py::object& path) {
+    // A str is iterable, but as a path it is almost certainly a mistake
+    if (PyUnicode_Check(path.ptr()) || PyBytes_Check(path.ptr())) {
+        throw py::type_error("path must be a sequence of keys, not a string");
+    }
+    std::vector<py::object> keys;
+    for (auto key : py::reinterpret_borrow<py::iterable>(path)) {
+        keys.push_back(py::reinterpret_borrow<py::object>(key));
+    }
+    return keys;
+}
+
+// Normalized list index, or -1 if key is not an int or out of [0, size]
+Py_ssize_t listIndex(const PersistentList& list, const py::object& key) {
+    if (!PyLong_Check(key.ptr())) {
+        return -1;
+    }
+    Py_ssize_t size = static_cast<Py_ssize_t>(list.size());
+    Py_ssize_t idx = PyLong_AsSsize_t(key.ptr());
+    if (idx == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+        return -1;
+    }
+    if (idx < 0) {
+        idx += size;
+    }
+    return (idx < 0 || idx > size) ? -1 : idx;
+}
+
+// Child at key, or a null object if absent
+py::object lookup(py::handle node, const py::object& key) {
+    switch (kindOf(node)) {
+        case Kind::DICT:
+            return node.cast<const PersistentDict&>().get(key, py::object());
+        case Kind::ARRAY_MAP:
+            return node.cast<const PersistentArrayMap&>().get(key, py::object());
+        case Kind::SORTED_DICT:
+            return node.cast<const PersistentSortedDict&>().get(key, py::object());
+        case Kind::LIST: {
+            const auto& list = node.cast<const PersistentList&>();
+            Py_ssize_t idx = listIndex(list, key);
+            if (idx < 0 || static_cast<size_t>(idx) == list.size()) {
+                return py::object();
+            }
+            return list.nth(static_cast<size_t>(idx));
+        }
+        case Kind::OTHER:
+            break;
+    }
+    return py::object();
+}
+
+// Rebuilds node with leaf(current) stored at path[i:]. leaf returns a null
+// object to remove the key. Returns node itself when nothing changed.
+py::object alterIn(py::handle node, const std::vector<py::object>& path, size_t i,
+                   const AlterFn& leaf, bool create) {
+    pmutils::RecursionGuard guard(" while updating a nested path");
+    const py::object& key = path[i];
+    bool last = i + 1 == path.size();
+
+    auto step = [&](const py::object& current) -> py::object {
+        if (last) {
+            return leaf(current);
+        }
+        if (!current) {
+            if (!create) {
+                return current;  // Nothing to remove below a missing key
+            }
+            return alterIn(py::cast(PersistentDict()), path, i + 1, leaf, create);
+        }
+        return alterIn(current, path, i + 1, leaf, create);
+    };
+
+    switch (kindOf(node)) {
+        case Kind::DICT: {
+            // Single descent: the step runs inside the trie update
+            bool changed = false;
+            PersistentDict result = node.cast<const PersistentDict&>().alter(
+                key, [&](const py::object& current) -> py::object {
+                    py::object updated = step(current);
+                    changed = !updated.is(current);
+                    return updated;
+                });
+            return changed ? py::cast(std::move(result)) : py::reinterpret_borrow<py::object>(node);
+        }
+        case Kind::ARRAY_MAP: {
+            const auto& map = node.cast<const PersistentArrayMap&>();
+            py::object current = map.get(key, py::object());
+            py::object updated = step(current);
+            if (updated.is(current)) {
+                return py::reinterpret_borrow<py::object>(node);
+            }
+            return updated ? py::cast(map.assoc(key, updated)) : py::cast(map.dissoc(key));
+        }
+        case Kind::SORTED_DICT: {
+            const auto& map = node.cast<const PersistentSortedDict&>();
+            py::object current = map.get(key, py::object());
+            py::object updated = step(current);
+            if (updated.is(current)) {
+                return py::reinterpret_borrow<py::object>(node);
+            }
+            return updated ? py::cast(map.assoc(key, updated)) : py::cast(map.dissoc(key));
+        }
+        case Kind::LIST: {
+            const auto& list = node.cast<const PersistentList&>();
+            if (!PyLong_Check(key.ptr())) {
+                throw py::type_error(std::string("PersistentList indices must be integers, not ") +
+                                     Py_TYPE(key.ptr())->tp_name);
+            }
+            Py_ssize_t idx = listIndex(list, key);
+            if (idx < 0) {
+                if (!create) {
+                    return py::reinterpret_borrow<py::object>(node);
+                }
+                throw py::index_error("PersistentList index out of range in path");
+            }
+            bool append = static_cast<size_t>(idx) == list.size();
+            py::object current = append ? py::object() : list.nth(static_cast<size_t>(idx));
+            py::object updated = step(current);
+            if (updated.is(current)) {
+                return py::reinterpret_borrow<py::object>(node);
+            }
+            if (!updated) {
+                throw py::type_error("cannot dissoc an element from PersistentList");
+            }
+            return append ? py::cast(list.conj(updated))
+                          : py::cast(list.assoc(static_cast<size_t>(idx), updated));
+        }
+        case Kind::OTHER:
+            break;
+    }
+    throw py::type_error(std::string("cannot descend into ") + Py_TYPE(node.ptr())->tp_name +
+                         " at path[" + std::to_string(i) + "]");
+}
+
+std::vector<py::object> toUpdatePath(const py::object& path) {
+    std::vector<py::object> keys = toPath(path);
+    if (keys.empty()) {
+        throw std::invalid_argument("path must not be empty");
+    }
+    return keys;
+}
+
+} // namespace
+
+py::object getIn(const py::object& root, const py::object& path, const py::object& default_val) {
+    py::object node = root;
+    for (const py::object& key : toPath(path)) {
+        node = lookup(node, key);
+        if (!node) {
+            return default_val;
+        }
+    }
+    return node;
+}
+
+py::object assocIn(const py::object& root, const py::object& path, const py::object& value) {
+    return alterIn(root, toUpdatePath(path), 0,
+                   [&](const py::object&) -> py::object { return value; }, true);
+}
+
+py::object updateIn(const py::object& root, const py::object& path, const py::object& fn) {
+    return alterIn(root, toUpdatePath(path), 0,
+                   [&](const py::object& current) -> py::object {
+                       return fn(current ? current : py::none());
+                   }, true);
+}
+
+py::object dissocIn(const py::object& root, const py::object& path) {
+    return alterIn(root, toUpdatePath(path), 0,
+                   [](const py::object&) -> py::object { return py::object(); }, false);
+}
+
+} // namespace ppath
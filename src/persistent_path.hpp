@@ -0,0 +1,38 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+
+/**
+ * Nested-path operations over persistent containers
+ *
+ * A path is an iterable of keys (list indices for PersistentList levels)
+ * that descends through any mix of PersistentDict, PersistentArrayMap,
+ * PersistentSortedDict and PersistentList. Updates descend once and rebuild
+ * only the spine:
+ * - PersistentDict levels use alter(), so lookup and path copy share one
+ *   trie descent per level
+ * - if the leaf value is unchanged (same object) every level returns the
+ *   original container, preserving identity
+ *
+ * Semantics follow Clojure's get-in/assoc-in/update-in:
+ * - getIn returns default_val as soon as a key is missing or a level is not
+ *   a container
+ * - assocIn/updateIn create missing intermediate levels as empty
+ *   PersistentDicts; on a list, index == len appends
+ * - updateIn calls fn(current) with None for a missing leaf
+ * - dissocIn removes the leaf key and leaves missing paths untouched; list
+ *   elements cannot be removed (TypeError)
+ */
+namespace ppath {
+
+py::object getIn(const py::object& root, const py::object& path, const py::object& default_val);
+
+py::object assocIn(const py::object& root, const py::object& path, const py::object& value);
+
+py::object updateIn(const py::object& root, const py::object& path, const py::object& fn);
+
+py::object dissocIn(const py::object& root, const py::object& path);
+
+} // namespace ppath
@@ -149,6 +149,18 @@ py::list PersistentSet::list() const {
     return map_.keysList();
 }
 
+py::set PersistentSet::toSet() const {
+    // The C API has no known-hash set insert; PySet_Add reuses the hash
+    // cached on str keys and ints hash without a call
+    py::set result;
+    map_.forEachEntry([&](const Entry& entry) {
+        if (PySet_Add(result.ptr(), entry.key.ptr()) < 0) {
+            throw py::error_already_set();
+        }
+    });
+    return result;
+}
+
 // Equality
 bool PersistentSet::operator==(const PersistentSet& other) const {
     // Fast path: same object
@@ -81,6 +81,9 @@ public:
     // Fast materialized iteration
     py::list list() const;
 
+    // Plain set of the elements
+    py::set toSet() const;
+
     // Equality
     bool operator==(const PersistentSet& other) const;
     bool operator!=(const PersistentSet& other) const { return !(*this == other); }
@@ -106,6 +109,8 @@ private:
 public:
     SetIterator(const PersistentDict& map) : iter_(map.keys()) {}
 
+    bool hasNext() const { return iter_.hasNext(); }
+
     py::object next() {
         return iter_.next();
     }
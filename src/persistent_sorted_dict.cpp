@@ -1,4 +1,6 @@
 #include "persistent_sorted_dict.hpp"
+#include "persistent_dict.hpp"
+#include "type_slots.hpp"
 #include <sstream>
 #include <algorithm>
 #include <iostream>
@@ -6,7 +8,7 @@
 // TreeNode implementation
 
 TreeNode::TreeNode(const py::object& k, const py::object& v, Color c)
-    : key(k), value(v), left(nullptr), right(nullptr), color(c), refcount_(0) {
+    : key(k), value(v), left(nullptr), right(nullptr), color(c), size(1), refcount_(0) {
 }
 
 TreeNode::~TreeNode() {
@@ -29,6 +31,7 @@ TreeNode* TreeNode::clone() const {
     TreeNode* newNode = new TreeNode(key, value, color);
     newNode->left = left;
     newNode->right = right;
+    newNode->size = size;
     if (left) {
         left->addRef();
     }
@@ -145,6 +148,7 @@ TreeNode* PersistentSortedDict::insert(TreeNode* node, const py::object& key, co
         newNode->value = val;
         inserted = false;
     }
+    newNode->updateSize();
 
     // Balance the tree
     TreeNode* balanced = balance(newNode);
@@ -243,6 +247,7 @@ TreeNode* PersistentSortedDict::remove(TreeNode* node, const py::object& key, bo
         }
     }
 
+    newNode->updateSize();
     return newNode;
 }
 
@@ -258,6 +263,7 @@ TreeNode* PersistentSortedDict::removeMin(TreeNode* node) const {
     TreeNode* newLeft = removeMin(node->left);
     if (newNode->left) newNode->left->release();
     newNode->left = newLeft;
+    newNode->updateSize();
 
     return newNode;
 }
@@ -293,7 +299,7 @@ TreeNode* PersistentSortedDict::find(TreeNode* node, const py::object& key) cons
 py::object PersistentSortedDict::get(const py::object& key) const {
     TreeNode* node = find(root_, key);
     if (node) return node->value;
-    throw py::key_error(py::str(key).cast<std::string>());
+    pslots::throwKeyError(key);
 }
 
 py::object PersistentSortedDict::get(const py::object& key, const py::object& default_val) const {
@@ -330,6 +336,8 @@ TreeNode* PersistentSortedDict::rotateLeft(TreeNode* node) const {
 
     newX->color = newNode->color;
     newNode->color = Color::RED;
+    newNode->updateSize();
+    newX->updateSize();
 
     return newX;
 }
@@ -357,6 +365,8 @@ TreeNode* PersistentSortedDict::rotateRight(TreeNode* node) const {
 
     newX->color = newNode->color;
     newNode->color = Color::RED;
+    newNode->updateSize();
+    newX->updateSize();
 
     return newX;
 }
@@ -512,12 +522,7 @@ py::object PersistentSortedDict::last() const {
 PersistentSortedDict PersistentSortedDict::subseq(const py::object& start, const py::object& end) const {
     std::vector<std::pair<py::object, py::object>> entries;
     collectRange(root_, start, end, entries);
-
-    PersistentSortedDict result;
-    for (const auto& entry : entries) {
-        result = result.assoc(entry.first, entry.second);
-    }
-    return result;
+    return fromSortedEntries(entries);
 }
 
 PersistentSortedDict PersistentSortedDict::rsubseq(const py::object& start, const py::object& end) const {
@@ -571,6 +576,26 @@ void PersistentSortedDict::collectRangeReverse(TreeNode* node, const py::object&
     }
 }
 
+SortedDictRange PersistentSortedDict::range(const py::object& start, const py::object& stop,
+                                            bool startInclusive, bool stopInclusive) const {
+    return SortedDictRange(*this, RangeBound{start, startInclusive}, RangeBound{stop, stopInclusive});
+}
+
+size_t PersistentSortedDict::rank(const py::object& key, bool inclusive) const {
+    size_t result = 0;
+    const TreeNode* node = root_;
+    while (node) {
+        int cmp = compareKeys(node->key, key);
+        if (cmp < 0 || (cmp == 0 && inclusive)) {
+            result += (node->left ? node->left->size : 0) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return result;
+}
+
 // Iteration and conversion
 
 TreeMapIterator PersistentSortedDict::iter() const {
@@ -607,11 +632,19 @@ py::list PersistentSortedDict::items() const {
 }
 
 py::dict PersistentSortedDict::dict() const {
-    py::dict result;
-    TreeMapIterator it(this);
-    while (it.hasNext()) {
-        py::object kv = it.next();
-        result[kv[py::int_(0)]] = kv[py::int_(1)];
+    // In-order walk straight over the nodes: no [key, value] pair per entry
+    py::dict result = pmutils::presizedDict(count_);
+    std::vector<const TreeNode*> stack;
+    const TreeNode* node = root_;
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        pmutils::dictSetItem(result, node->key, node->value);
+        node = node->right;
     }
     return result;
 }
@@ -678,6 +711,35 @@ PersistentSortedDict PersistentSortedDict::fromDict(const py::dict& d) {
     return result;
 }
 
+// Middle entry at each level as the root: the tree is complete except for
+// its deepest level, which is colored red so every path has the same
+// number of black nodes
+TreeNode* PersistentSortedDict::buildBalanced(const std::vector<std::pair<py::object, py::object>>& entries,
+                                              size_t lo, size_t hi, size_t depth, size_t redDepth) {
+    if (lo >= hi) return nullptr;
+    size_t mid = lo + (hi - lo) / 2;
+    TreeNode* node = new TreeNode(entries[mid].first, entries[mid].second,
+                                  depth == redDepth ? Color::RED : Color::BLACK);
+    node->left = buildBalanced(entries, lo, mid, depth + 1, redDepth);
+    if (node->left) node->left->addRef();
+    node->right = buildBalanced(entries, mid + 1, hi, depth + 1, redDepth);
+    if (node->right) node->right->addRef();
+    node->size = hi - lo;
+    return node;
+}
+
+PersistentSortedDict PersistentSortedDict::fromSortedEntries(
+        const std::vector<std::pair<py::object, py::object>>& entries) {
+    size_t n = entries.size();
+    if (n == 0) return PersistentSortedDict();
+    // Depth of the first incomplete level: floor(log2(n + 1))
+    size_t redDepth = 0;
+    while ((size_t(2) << redDepth) <= n + 1) {
+        ++redDepth;
+    }
+    return PersistentSortedDict(buildBalanced(entries, 0, n, 0, redDepth), n);
+}
+
 PersistentSortedDict PersistentSortedDict::create(const py::kwargs& kwargs) {
     PersistentSortedDict result;
     for (auto item : kwargs) {
@@ -745,3 +807,150 @@ py::object TreeMapIterator::next() {
     result.append(node->value);
     return result;
 }
+
+// SortedDictRange implementation
+
+SortedDictRange::SortedDictRange(const PersistentSortedDict& map, RangeBound lo, RangeBound hi)
+    : map_(map), lo_(std::move(lo)), hi_(std::move(hi)) {
+    // None means an open end, as in a slice
+    if (lo_.key && lo_.key.is_none()) lo_.key = py::object();
+    if (hi_.key && hi_.key.is_none()) hi_.key = py::object();
+}
+
+bool SortedDictRange::aboveLo(const py::object& key) const {
+    if (lo_.open()) return true;
+    int cmp = PersistentSortedDict::compareKeys(key, lo_.key);
+    return cmp > 0 || (cmp == 0 && lo_.inclusive);
+}
+
+bool SortedDictRange::belowHi(const py::object& key) const {
+    if (hi_.open()) return true;
+    int cmp = PersistentSortedDict::compareKeys(key, hi_.key);
+    return cmp < 0 || (cmp == 0 && hi_.inclusive);
+}
+
+size_t SortedDictRange::size() const {
+    // Entries before the range and up to its end, from two rank descents
+    size_t before = lo_.open() ? 0 : map_.rank(lo_.key, !lo_.inclusive);
+    size_t through = hi_.open() ? map_.count_ : map_.rank(hi_.key, hi_.inclusive);
+    return through > before ? through - before : 0;
+}
+
+bool SortedDictRange::contains(const py::object& key) const {
+    return aboveLo(key) && belowHi(key) && map_.contains(key);
+}
+
+py::object SortedDictRange::first() const {
+    const TreeNode* best = nullptr;
+    const TreeNode* node = map_.root_;
+    while (node) {
+        if (aboveLo(node->key)) {
+            best = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    if (!best || !belowHi(best->key)) throw std::runtime_error("first() called on empty range");
+    py::list result;
+    result.append(best->key);
+    result.append(best->value);
+    return result;
+}
+
+py::object SortedDictRange::last() const {
+    const TreeNode* best = nullptr;
+    const TreeNode* node = map_.root_;
+    while (node) {
+        if (belowHi(node->key)) {
+            best = node;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    if (!best || !aboveLo(best->key)) throw std::runtime_error("last() called on empty range");
+    py::list result;
+    result.append(best->key);
+    result.append(best->value);
+    return result;
+}
+
+SortedRangeIterator SortedDictRange::iter(int kind) const {
+    return SortedRangeIterator(*this, kind);
+}
+
+PersistentSortedDict SortedDictRange::toSortedDict() const {
+    if (lo_.open() && hi_.open()) return map_;
+    std::vector<std::pair<py::object, py::object>> entries;
+    entries.reserve(size());
+    SortedRangeIterator it(*this, SortedRangeIterator::ITEMS);
+    while (const TreeNode* node = it.nextNode()) {
+        entries.emplace_back(node->key, node->value);
+    }
+    return PersistentSortedDict::fromSortedEntries(entries);
+}
+
+std::string SortedDictRange::repr() const {
+    std::ostringstream oss;
+    oss << "SortedDictRange(" << (lo_.inclusive ? "[" : "(");
+    oss << (lo_.open() ? "" : py::repr(lo_.key).cast<std::string>()) << ", ";
+    oss << (hi_.open() ? "" : py::repr(hi_.key).cast<std::string>());
+    oss << (hi_.inclusive ? "]" : ")") << ")";
+    return oss.str();
+}
+
+// SortedRangeIterator implementation
+
+SortedRangeIterator::SortedRangeIterator(const SortedDictRange& range, int kind)
+    : map_(range.map_), hi_(range.hi_), kind_(kind), next_(nullptr) {
+    // Seek: keep the nodes at or above the lower bound where the walk turns
+    // left; they are the in-order successors still to visit
+    const TreeNode* node = map_.root_;
+    while (node) {
+        if (range.aboveLo(node->key)) {
+            stack_.push_back(node);
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    advance();
+}
+
+void SortedRangeIterator::advance() {
+    next_ = nullptr;
+    if (stack_.empty()) return;
+    const TreeNode* node = stack_.back();
+    stack_.pop_back();
+    if (!hi_.open()) {
+        int cmp = PersistentSortedDict::compareKeys(node->key, hi_.key);
+        if (cmp > 0 || (cmp == 0 && !hi_.inclusive)) {
+            stack_.clear();
+            return;
+        }
+    }
+    for (const TreeNode* child = node->right; child; child = child->left) {
+        stack_.push_back(child);
+    }
+    next_ = node;
+}
+
+const TreeNode* SortedRangeIterator::nextNode() {
+    const TreeNode* node = next_;
+    if (node) advance();
+    return node;
+}
+
+py::object SortedRangeIterator::next() {
+    const TreeNode* node = nextNode();
+    if (!node) {
+        throw py::stop_iteration();
+    }
+    if (kind_ == KEYS) return node->key;
+    if (kind_ == VALUES) return node->value;
+    py::list result;
+    result.append(node->key);
+    result.append(node->value);
+    return result;
+}
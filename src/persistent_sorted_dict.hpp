@@ -6,6 +6,7 @@
 #include <vector>
 #include <atomic>
 #include <stdexcept>
+#include "tracked_alloc.hpp"
 
 namespace py = pybind11;
 
@@ -13,18 +14,21 @@ namespace py = pybind11;
 class TreeNode;
 class PersistentSortedDict;
 class TreeMapIterator;
+class SortedDictRange;
+class SortedRangeIterator;
 
 // Color for red-black tree nodes
 enum class Color { RED, BLACK };
 
 // TreeNode - Red-black tree node with intrusive reference counting
-class TreeNode {
+class TreeNode : public pmalloc::Tracked<pmalloc::DOMAIN_SORTED_DICT> {
 public:
     py::object key;
     py::object value;
     TreeNode* left;
     TreeNode* right;
     Color color;
+    size_t size;  // Entries in this subtree, for order statistics
 
     TreeNode(const py::object& k, const py::object& v, Color c = Color::RED);
     ~TreeNode();
@@ -37,6 +41,11 @@ public:
     bool isRed() const { return color == Color::RED; }
     bool isBlack() const { return color == Color::BLACK; }
 
+    // Recompute size after the children change
+    void updateSize() {
+        size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+    }
+
 private:
     std::atomic<int> refcount_;
 };
@@ -44,6 +53,8 @@ private:
 // PersistentSortedDict - Immutable sorted map using red-black tree
 class PersistentSortedDict {
     friend class TreeMapIterator;
+    friend class SortedDictRange;
+    friend class SortedRangeIterator;
 
 public:
     // Constructors
@@ -69,6 +80,8 @@ public:
     py::object last() const;   // Returns [key, value] of largest key
     PersistentSortedDict subseq(const py::object& start, const py::object& end) const;
     PersistentSortedDict rsubseq(const py::object& start, const py::object& end) const;
+    SortedDictRange range(const py::object& start, const py::object& stop,
+                          bool startInclusive = true, bool stopInclusive = false) const;
 
     // Size and iteration
     size_t size() const { return count_; }
@@ -90,6 +103,9 @@ public:
     // Factory methods
     static PersistentSortedDict fromDict(const py::dict& d);
     static PersistentSortedDict create(const py::kwargs& kwargs);
+    // Build directly from entries already in strictly ascending key order
+    static PersistentSortedDict fromSortedEntries(
+        const std::vector<std::pair<py::object, py::object>>& entries);
 
     // Python protocol support
     py::object pyGetItem(const py::object& key) const;
@@ -119,6 +135,13 @@ private:
     // Comparison helper
     static int compareKeys(const py::object& k1, const py::object& k2);
 
+    // Number of keys < key (or <= key when inclusive)
+    size_t rank(const py::object& key, bool inclusive) const;
+
+    // Balanced subtree over entries[lo, hi); nodes at redDepth are red
+    static TreeNode* buildBalanced(const std::vector<std::pair<py::object, py::object>>& entries,
+                                   size_t lo, size_t hi, size_t depth, size_t redDepth);
+
     // Range query helpers
     void collectRange(TreeNode* node, const py::object& start, const py::object& end,
                      std::vector<std::pair<py::object, py::object>>& result) const;
@@ -143,6 +166,63 @@ private:
     void pushLeft(TreeNode* node);
 };
 
+// Lower or upper end of a range view. A null key leaves that end open.
+struct RangeBound {
+    py::object key;
+    bool inclusive = true;
+
+    bool open() const { return !key; }
+};
+
+// SortedDictRange - Lazy view of the entries of a PersistentSortedDict
+// between two bounds. Holds the original tree and answers len, first/last
+// and membership with O(log n) descents, without copying any entries.
+class SortedDictRange {
+    friend class SortedRangeIterator;
+
+public:
+    SortedDictRange(const PersistentSortedDict& map, RangeBound lo, RangeBound hi);
+
+    size_t size() const;
+    bool contains(const py::object& key) const;
+    py::object first() const;  // [key, value] of the smallest key in range
+    py::object last() const;   // [key, value] of the largest key in range
+    SortedRangeIterator iter(int kind) const;
+    PersistentSortedDict toSortedDict() const;
+    std::string repr() const;
+
+private:
+    PersistentSortedDict map_;
+    RangeBound lo_;
+    RangeBound hi_;
+
+    bool aboveLo(const py::object& key) const;
+    bool belowHi(const py::object& key) const;
+};
+
+// SortedRangeIterator - In-order walk over a SortedDictRange. Seeks to the
+// lower bound in one descent and stops at the upper bound.
+class SortedRangeIterator {
+public:
+    enum Kind { KEYS = 0, VALUES = 1, ITEMS = 2 };
+
+    SortedRangeIterator(const SortedDictRange& range, int kind);
+
+    SortedRangeIterator& iter() { return *this; }
+    bool hasNext() const { return next_ != nullptr; }
+    py::object next();
+    const TreeNode* nextNode();  // Null when done
+
+private:
+    PersistentSortedDict map_;  // Keeps the nodes alive
+    RangeBound hi_;
+    int kind_;
+    std::vector<const TreeNode*> stack_;
+    const TreeNode* next_;  // Next node in range, null when done
+
+    void advance();
+};
+
 // Pybind11 iterator wrapper
 class TreeMapIteratorWrapper {
 public:
@@ -150,6 +230,8 @@ public:
 
     TreeMapIteratorWrapper& iter() { return *this; }
 
+    bool hasNext() const { return it_.hasNext(); }
+
     py::object next() {
         if (!it_.hasNext()) {
             throw py::stop_iteration();
@@ -0,0 +1,303 @@
+#include "persistent_store.hpp"
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+
+using Slot = NodeArray::value_type;
+
+void collectEntries(const NodeBase* node, std::vector<const Entry*>& out) {
+    if (auto* bitmapNode = dynamic_cast<const BitmapNode*>(node)) {
+        for (const auto& slot : bitmapNode->getArray()) {
+            if (auto* entry = std::get_if<std::shared_ptr<Entry>>(&slot)) {
+                out.push_back(entry->get());
+            } else {
+                collectEntries(std::get<NodeBase*>(slot), out);
+            }
+        }
+    } else {
+        for (const auto& entry : static_cast<const CollisionNode*>(node)->getEntries()) {
+            out.push_back(entry.get());
+        }
+    }
+}
+
+void collectSlot(const Slot& slot, std::vector<const Entry*>& out) {
+    if (auto* entry = std::get_if<std::shared_ptr<Entry>>(&slot)) {
+        out.push_back(entry->get());
+    } else {
+        collectEntries(std::get<NodeBase*>(slot), out);
+    }
+}
+
+class DiffWalk {
+public:
+    explicit DiffWalk(ChangeSet& out) : out_(out) {}
+
+    void nodes(const NodeBase* a, const NodeBase* b) {
+        if (a == b) return;
+        auto* bitmapA = dynamic_cast<const BitmapNode*>(a);
+        auto* bitmapB = dynamic_cast<const BitmapNode*>(b);
+        if (bitmapA && bitmapB) {
+            bitmaps(bitmapA, bitmapB);
+            return;
+        }
+        std::vector<const Entry*> left;
+        std::vector<const Entry*> right;
+        if (a) collectEntries(a, left);
+        if (b) collectEntries(b, right);
+        entries(left, right);
+    }
+
+private:
+    ChangeSet& out_;
+
+    // Slots are paired by bit: a key can only live under the same bit in
+    // both versions
+    void bitmaps(const BitmapNode* a, const BitmapNode* b) {
+        for (bitmap_t bits = a->getBitmap() | b->getBitmap(); bits; bits &= bits - 1) {
+            bitmap_t bit = bits & (~bits + 1);
+            const Slot* slotA = slotAt(a, bit);
+            const Slot* slotB = slotAt(b, bit);
+            if (slotA && slotB) {
+                slots(*slotA, *slotB);
+            } else {
+                std::vector<const Entry*> found;
+                collectSlot(slotA ? *slotA : *slotB, found);
+                for (const Entry* entry : found) {
+                    (slotA ? out_.removed : out_.added).append(py::make_tuple(entry->key, entry->value));
+                }
+            }
+        }
+    }
+
+    void slots(const Slot& a, const Slot& b) {
+        auto* nodeA = std::get_if<NodeBase*>(&a);
+        auto* nodeB = std::get_if<NodeBase*>(&b);
+        if (nodeA && nodeB) {
+            nodes(*nodeA, *nodeB);
+            return;
+        }
+        if (!nodeA && !nodeB &&
+            std::get<std::shared_ptr<Entry>>(a).get() == std::get<std::shared_ptr<Entry>>(b).get()) {
+            return;
+        }
+        // An entry against an entry or a subtree (the subtree appears when
+        // keys collide on this slot in one of the versions)
+        std::vector<const Entry*> left;
+        std::vector<const Entry*> right;
+        collectSlot(a, left);
+        collectSlot(b, right);
+        entries(left, right);
+    }
+
+    // Match two entry lists (one side is a single entry or a collision
+    // bucket). Entries present in both versions are the same Entry object,
+    // so they pair by pointer; only the rest are compared by key, by a
+    // merge walk when the keys can be ordered, so a hash-flooded bucket
+    // does not cost a quadratic number of __eq__ calls per diff.
+    void entries(const std::vector<const Entry*>& a, const std::vector<const Entry*>& b) {
+        if (a.size() + b.size() <= SMALL_MATCH) {
+            scan(a, b);
+            return;
+        }
+        std::unordered_set<const Entry*> inA(a.begin(), a.end());
+        std::unordered_set<const Entry*> inB(b.begin(), b.end());
+        std::vector<const Entry*> onlyA;
+        std::vector<const Entry*> onlyB;
+        for (const Entry* entry : a) {
+            if (!inB.count(entry)) onlyA.push_back(entry);
+        }
+        for (const Entry* entry : b) {
+            if (!inA.count(entry)) onlyB.push_back(entry);
+        }
+        if (onlyA.size() + onlyB.size() > SMALL_MATCH && orderable(onlyA, onlyB)) {
+            merge(onlyA, onlyB);
+        } else {
+            scan(onlyA, onlyB);
+        }
+    }
+
+    static constexpr size_t SMALL_MATCH = 8;
+
+    // Pairwise scan, for short lists
+    void scan(const std::vector<const Entry*>& a, const std::vector<const Entry*>& b) {
+        std::vector<bool> matched(b.size(), false);
+        for (const Entry* left : a) {
+            bool found = false;
+            for (size_t i = 0; i < b.size(); ++i) {
+                const Entry* right = b[i];
+                if (matched[i] || right->hash != left->hash) continue;
+                if (right != left && !pmutils::keysEqual(left->key, right->key)) continue;
+                matched[i] = true;
+                found = true;
+                if (right != left && !valuesEqual(left->value, right->value)) {
+                    out_.changed.append(py::make_tuple(left->key, left->value, right->value));
+                }
+                break;
+            }
+            if (!found) {
+                out_.removed.append(py::make_tuple(left->key, left->value));
+            }
+        }
+        for (size_t i = 0; i < b.size(); ++i) {
+            if (!matched[i]) {
+                out_.added.append(py::make_tuple(b[i]->key, b[i]->value));
+            }
+        }
+    }
+
+    // All keys of one exact type whose < is total and agrees with == (the
+    // same rule as sorted collision buckets)
+    static bool orderable(const std::vector<const Entry*>& a, const std::vector<const Entry*>& b) {
+        const Entry* first = a.empty() ? b.front() : a.front();
+        PyTypeObject* type = Py_TYPE(first->key.ptr());
+        if (type != &PyLong_Type && type != &PyUnicode_Type && type != &PyBytes_Type) {
+            return false;
+        }
+        for (const auto* side : {&a, &b}) {
+            for (const Entry* entry : *side) {
+                if (Py_TYPE(entry->key.ptr()) != type) return false;
+            }
+        }
+        return true;
+    }
+
+    // Sort both sides by key and walk them together
+    void merge(std::vector<const Entry*>& a, std::vector<const Entry*>& b) {
+        auto byKey = [](const Entry* x, const Entry* y) { return keyLess(x->key, y->key); };
+        std::sort(a.begin(), a.end(), byKey);
+        std::sort(b.begin(), b.end(), byKey);
+        size_t i = 0;
+        size_t j = 0;
+        while (i < a.size() || j < b.size()) {
+            if (j == b.size() || (i < a.size() && keyLess(a[i]->key, b[j]->key))) {
+                out_.removed.append(py::make_tuple(a[i]->key, a[i]->value));
+                ++i;
+            } else if (i == a.size() || keyLess(b[j]->key, a[i]->key)) {
+                out_.added.append(py::make_tuple(b[j]->key, b[j]->value));
+                ++j;
+            } else {
+                if (!valuesEqual(a[i]->value, b[j]->value)) {
+                    out_.changed.append(py::make_tuple(a[i]->key, a[i]->value, b[j]->value));
+                }
+                ++i;
+                ++j;
+            }
+        }
+    }
+
+    static bool keyLess(const py::object& a, const py::object& b) {
+        int result = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_LT);
+        if (result == -1) {
+            throw py::error_already_set();
+        }
+        return result == 1;
+    }
+
+    static bool valuesEqual(const py::object& a, const py::object& b) {
+        int result = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_EQ);
+        if (result == -1) {
+            throw py::error_already_set();
+        }
+        return result == 1;
+    }
+};
+
+} // anonymous namespace
+
+// ChangeSet implementation
+
+ChangeSet ChangeSet::between(const PersistentDict& before, const PersistentDict& after) {
+    ChangeSet result{before, after, py::list(), py::list(), py::list()};
+    DiffWalk(result).nodes(before.root(), after.root());
+    return result;
+}
+
+std::string ChangeSet::repr() const {
+    std::ostringstream oss;
+    oss << "ChangeSet(added=" << added.size() << ", removed=" << removed.size()
+        << ", changed=" << changed.size() << ")";
+    return oss.str();
+}
+
+// Store implementation
+
+const PersistentDict& Store::assoc(const py::object& key, const py::object& val) {
+    return commit(state_.assoc(key, val));
+}
+
+const PersistentDict& Store::dissoc(const py::object& key) {
+    return commit(state_.dissoc(key));
+}
+
+const PersistentDict& Store::update(const py::object& other) {
+    return commit(state_.update(other));
+}
+
+const PersistentDict& Store::reset(const PersistentDict& state) {
+    return commit(state);
+}
+
+size_t Store::subscribe(const py::object& fn) {
+    if (!PyCallable_Check(fn.ptr())) {
+        throw py::type_error("subscriber must be callable");
+    }
+    subscribers_.emplace_back(nextToken_, fn);
+    return nextToken_++;
+}
+
+bool Store::unsubscribe(size_t token) {
+    for (auto it = subscribers_.begin(); it != subscribers_.end(); ++it) {
+        if (it->first == token) {
+            subscribers_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Store::beginBatch() {
+    if (batchDepth_++ == 0) {
+        batchBase_ = state_;
+    }
+}
+
+void Store::endBatch() {
+    if (batchDepth_ == 0) {
+        throw std::runtime_error("endBatch() without a matching beginBatch()");
+    }
+    if (--batchDepth_ == 0) {
+        PersistentDict before = std::move(batchBase_);
+        batchBase_ = PersistentDict();
+        publish(before);
+    }
+}
+
+std::string Store::repr() const {
+    std::ostringstream oss;
+    oss << "Store(size=" << state_.size() << ", subscribers=" << subscribers_.size() << ")";
+    return oss.str();
+}
+
+const PersistentDict& Store::commit(PersistentDict next) {
+    PersistentDict before = std::move(state_);
+    state_ = std::move(next);
+    if (batchDepth_ == 0) {
+        publish(before);
+    }
+    return state_;
+}
+
+void Store::publish(const PersistentDict& before) {
+    if (subscribers_.empty() || before.root() == state_.root()) return;
+    ChangeSet changes = ChangeSet::between(before, state_);
+    if (changes.size() == 0) return;
+    py::object payload = py::cast(std::move(changes));
+    // Copy: subscribers may subscribe or unsubscribe while being notified
+    auto subscribers = subscribers_;
+    for (const auto& subscriber : subscribers) {
+        subscriber.second(payload);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include "persistent_dict.hpp"
+
+namespace py = pybind11;
+
+/**
+ * ChangeSet - Entries added, removed and changed between two PersistentDicts
+ *
+ * Computed by walking both tries in parallel: subtrees that are the same
+ * node in both versions are skipped without being visited, so the cost
+ * follows the size of the edit rather than the size of the map. Values
+ * count as changed when they are neither the same object nor equal.
+ *
+ * added and removed hold (key, value) tuples; changed holds
+ * (key, old_value, new_value) tuples. Order follows the trie, not insertion.
+ */
+struct ChangeSet {
+    PersistentDict before;
+    PersistentDict after;
+    py::list added;
+    py::list removed;
+    py::list changed;
+
+    static ChangeSet between(const PersistentDict& before, const PersistentDict& after);
+
+    size_t size() const { return added.size() + removed.size() + changed.size(); }
+    std::string repr() const;
+};
+
+/**
+ * Store - Mutable cell holding a PersistentDict, with a change feed
+ *
+ * Every update replaces the state and publishes one ChangeSet to each
+ * subscriber, in subscription order, so downstream indexes can be
+ * maintained incrementally. Inside a batch (beginBatch/endBatch, nestable)
+ * updates only replace the state; the outermost endBatch publishes a single
+ * ChangeSet from the state before the batch to the final one. Updates that
+ * leave the state unchanged publish nothing, and with no subscribers no
+ * diff is computed.
+ *
+ * A subscriber's exception propagates to the caller after the state has
+ * been updated; later subscribers are not called for that ChangeSet.
+ * Not synchronized: share between threads behind a lock.
+ */
+class Store {
+public:
+    explicit Store(const PersistentDict& initial) : state_(initial) {}
+
+    const PersistentDict& state() const { return state_; }
+
+    // Updates; each returns the new state
+    const PersistentDict& assoc(const py::object& key, const py::object& val);
+    const PersistentDict& dissoc(const py::object& key);
+    const PersistentDict& update(const py::object& other);
+    const PersistentDict& reset(const PersistentDict& state);
+
+    // fn(changes) is called with a ChangeSet; returns a token for unsubscribe
+    size_t subscribe(const py::object& fn);
+    bool unsubscribe(size_t token);
+    size_t subscriberCount() const { return subscribers_.size(); }
+
+    void beginBatch();
+    void endBatch();
+    bool inBatch() const { return batchDepth_ > 0; }
+
+    std::string repr() const;
+
+private:
+    PersistentDict state_;
+    PersistentDict batchBase_;  // State before the outermost open batch
+    int batchDepth_ = 0;
+    std::vector<std::pair<size_t, py::object>> subscribers_;
+    size_t nextToken_ = 1;
+
+    const PersistentDict& commit(PersistentDict next);
+    void publish(const PersistentDict& before);
+};
+
+// Context manager returned by Store.batch()
+class StoreBatch {
+public:
+    explicit StoreBatch(py::object store) : store_(std::move(store)) {}
+
+    void enter() { store_.cast<Store&>().beginBatch(); }
+    void exit() { store_.cast<Store&>().endBatch(); }
+
+private:
+    py::object store_;  // Keeps the Store alive
+};
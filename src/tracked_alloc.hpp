@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Python.h>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+/**
+ * Tracked allocation - makes native memory visible to tracemalloc
+ *
+ * Nodes, entries, slot arrays and arena chunks live outside Python's
+ * allocators, so tracemalloc snapshots used to miss almost all of the
+ * memory a large container holds. Every such allocation is now reported
+ * with PyTraceMalloc_Track under a per-container domain, together with the
+ * Python traceback that caused it:
+ *
+ *   snapshot = tracemalloc.take_snapshot().filter_traces(
+ *       [tracemalloc.DomainFilter(True, pypersistent.TRACEMALLOC_DOMAINS['PersistentDict'])])
+ *
+ * Types built on PersistentDict (PersistentSet, PersistentMultiMap,
+ * PersistentBag, PersistentOrderedDict's index) report under its domain.
+ *
+ * When tracemalloc is not tracing, PyTraceMalloc_Track returns after a
+ * single flag check, so the cost is one predictable branch per allocation.
+ * Memory comes from the global operator new, not PyMem_*, so it does not
+ * show up in sys.getallocatedblocks() (which only counts pymalloc blocks).
+ */
+namespace pmalloc {
+
+// tracemalloc domains (0 is Python's own heap)
+enum Domain : unsigned int {
+    DOMAIN_BASE = 0x50500000,
+    DOMAIN_DICT = DOMAIN_BASE + 1,         // PersistentDict HAMT nodes and entries
+    DOMAIN_SORTED_DICT = DOMAIN_BASE + 2,  // PersistentSortedDict tree nodes
+    DOMAIN_LIST = DOMAIN_BASE + 3,         // PersistentList trie nodes
+    DOMAIN_INTERVAL_MAP = DOMAIN_BASE + 4, // PersistentIntervalMap tree nodes
+    DOMAIN_ARENA = DOMAIN_BASE + 5,        // BulkOpArena chunks
+};
+
+inline void* allocate(size_t size, unsigned int domain) {
+    void* p = ::operator new(size);
+    PyTraceMalloc_Track(domain, reinterpret_cast<uintptr_t>(p), size);
+    return p;
+}
+
+inline void deallocate(void* p, unsigned int domain) noexcept {
+    if (p == nullptr) {
+        return;
+    }
+    PyTraceMalloc_Untrack(domain, reinterpret_cast<uintptr_t>(p));
+    ::operator delete(p);
+}
+
+/**
+ * Base class giving a node type tracked operator new/delete.
+ *
+ * Placement forms are re-declared because a class-scope operator new hides
+ * the global placement form that BulkOpArena uses.
+ */
+template <unsigned int D>
+struct Tracked {
+    static void* operator new(size_t size) { return allocate(size, D); }
+    static void operator delete(void* p) noexcept { deallocate(p, D); }
+
+    static void* operator new(size_t, void* where) noexcept { return where; }
+    static void operator delete(void*, void*) noexcept {}
+};
+
+/**
+ * Standard allocator reporting to a tracemalloc domain, for containers
+ * (std::vector) and std::allocate_shared.
+ */
+template <typename T, unsigned int D>
+struct TrackedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TrackedAllocator<U, D>;
+    };
+
+    TrackedAllocator() noexcept = default;
+    template <typename U>
+    TrackedAllocator(const TrackedAllocator<U, D>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(pmalloc::allocate(n * sizeof(T), D));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        pmalloc::deallocate(p, D);
+    }
+
+    template <typename U>
+    bool operator==(const TrackedAllocator<U, D>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const TrackedAllocator<U, D>&) const noexcept { return false; }
+};
+
+} // namespace pmalloc
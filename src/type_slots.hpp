@@ -0,0 +1,135 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <new>
+#include <stdexcept>
+
+namespace py = pybind11;
+
+/**
+ * Exception-free miss paths for subscripts and iteration
+ *
+ * pybind11 reports a KeyError/IndexError/StopIteration by throwing a C++
+ * exception, which unwinds the stack and is translated back into a Python
+ * error. On miss-heavy workloads (cache probes) and at the end of every
+ * loop, that unwinding dominates the cost of the lookup itself.
+ *
+ * After the bindings are defined, the hot slots of each type are replaced:
+ * - mp_subscript sets KeyError/IndexError directly and returns NULL
+ * - tp_iternext returns NULL without an error set on exhaustion, which the
+ *   interpreter treats as StopIteration without creating the exception
+ *
+ * The pybind11 __getitem__/__next__ methods stay in place for explicit
+ * calls, and keys the fast path does not handle (slices) are passed to the
+ * original slot. Exceptions from user code (__hash__, __eq__) are still
+ * propagated, converted to the Python error indicator at the slot boundary.
+ */
+namespace pslots {
+
+// Sets the Python error for the exception being handled. Call from catch (...).
+inline void setErrorFromException() {
+    try {
+        throw;
+    } catch (py::error_already_set& e) {
+        e.restore();
+    } catch (const py::builtin_exception& e) {
+        e.set_error();
+    } catch (const std::bad_alloc&) {
+        PyErr_NoMemory();
+    } catch (const std::out_of_range& e) {
+        PyErr_SetString(PyExc_IndexError, e.what());
+    } catch (const std::overflow_error& e) {
+        PyErr_SetString(PyExc_OverflowError, e.what());
+    } catch (const std::invalid_argument& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+    } catch (const std::length_error& e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+    } catch (...) {
+        PyErr_SetString(PyExc_RuntimeError, "unknown C++ exception");
+    }
+}
+
+// KeyError(key), wrapped in a tuple like dict so tuple keys are not unpacked
+inline void setKeyError(PyObject* key) {
+    PyObject* args = PyTuple_Pack(1, key);
+    if (args) {
+        PyErr_SetObject(PyExc_KeyError, args);
+        Py_DECREF(args);
+    }
+}
+
+// Same KeyError for the throwing __getitem__ paths, so d[k] and
+// d.__getitem__(k) raise identical exceptions
+[[noreturn]] inline void throwKeyError(const py::object& key) {
+    setKeyError(key.ptr());
+    throw py::error_already_set();
+}
+
+template <typename T>
+const T& instance(PyObject* self) {
+    return py::handle(self).cast<const T&>();
+}
+
+// Slot that was in place before installSubscript, for keys the fast path
+// passes on
+template <typename T>
+binaryfunc& originalSubscript() {
+    static binaryfunc slot = nullptr;
+    return slot;
+}
+
+// mp_subscript for maps: find returns a null object on a miss
+template <typename T, py::object (*find)(const T&, const py::object&)>
+PyObject* mapSubscript(PyObject* self, PyObject* key) {
+    try {
+        py::object value = find(instance<T>(self), py::reinterpret_borrow<py::object>(key));
+        if (!value) {
+            setKeyError(key);
+            return nullptr;
+        }
+        return value.release().ptr();
+    } catch (...) {
+        setErrorFromException();
+        return nullptr;
+    }
+}
+
+// tp_iternext over an iterator with hasNext()/next()
+template <typename It>
+PyObject* iterNext(PyObject* self) {
+    try {
+        It& it = py::handle(self).cast<It&>();
+        if (!it.hasNext()) {
+            return nullptr;  // Exhausted: no error set
+        }
+        return it.next().release().ptr();
+    } catch (...) {
+        setErrorFromException();
+        return nullptr;
+    }
+}
+
+inline PyTypeObject* typeOf(const py::handle& cls) {
+    return reinterpret_cast<PyTypeObject*>(cls.ptr());
+}
+
+// Must run after every def() on the class: setting a dunder attribute
+// later would reinstall the generic slot
+template <typename T>
+void installSubscript(const py::handle& cls, binaryfunc slot) {
+    PyTypeObject* type = typeOf(cls);
+    originalSubscript<T>() = type->tp_as_mapping->mp_subscript;
+    type->tp_as_mapping->mp_subscript = slot;
+    PyType_Modified(type);
+}
+
+template <typename It>
+void installIterNext(const py::handle& cls) {
+    PyTypeObject* type = typeOf(cls);
+    type->tp_iternext = &iterNext<It>;
+    PyType_Modified(type);
+}
+
+} // namespace pslots
@@ -0,0 +1,103 @@
+"""
+Tests for conversion to plain Python containers (to_dict, to_list, to_set).
+
+Verifies that:
+- Every container converts to the equivalent dict, list or set
+- Ordered containers keep their order
+- PersistentDict.to_dict reuses stored hashes instead of calling __hash__
+"""
+
+import sys
+
+import pytest
+from pypersistent import (PersistentArrayMap, PersistentBag, PersistentDict,
+                          PersistentList, PersistentMultiMap,
+                          PersistentOrderedDict, PersistentSet,
+                          PersistentSortedDict)
+
+
+class CountingKey:
+    """Key that counts its __hash__ calls."""
+
+    calls = 0
+
+    def __init__(self, value):
+        self.value = value
+
+    def __hash__(self):
+        CountingKey.calls += 1
+        return hash(self.value)
+
+    def __eq__(self, other):
+        return isinstance(other, CountingKey) and self.value == other.value
+
+
+class TestToDict:
+    """Test to_dict on the map types."""
+
+    @pytest.mark.parametrize('n', [0, 1, 100, 5000])
+    def test_persistent_dict(self, n):
+        """Test a PersistentDict converts to an equal dict."""
+        source = {f'k{i}': i for i in range(n)}
+        result = PersistentDict.from_dict(source).to_dict()
+        assert type(result) is dict
+        assert result == source
+
+    @pytest.mark.skipif(sys.version_info >= (3, 13),
+                        reason='known-hash insert is only used before 3.13')
+    def test_no_rehash(self):
+        """Test keys are inserted with their stored hashes."""
+        keys = [CountingKey(i) for i in range(2000)]
+        m = PersistentDict.from_dict({k: k.value for k in keys})
+        CountingKey.calls = 0
+        result = m.to_dict()
+        assert CountingKey.calls == 0
+        assert result[keys[1234]] == 1234
+
+    def test_seeded_and_negative_hashes(self):
+        """Test stored hashes map back to Python hashes for any key."""
+        keys = [-1, -2, 2**63, -2**63, 1.5, (1, 2), None, 'x']
+        result = PersistentDict.from_dict({k: str(k) for k in keys}).to_dict()
+        for k in keys:
+            assert result[k] == str(k)
+
+    def test_sorted_dict_in_key_order(self):
+        """Test PersistentSortedDict converts in key order."""
+        m = PersistentSortedDict.from_dict({3: 'c', 1: 'a', 2: 'b'})
+        assert list(m.to_dict().items()) == [(1, 'a'), (2, 'b'), (3, 'c')]
+        assert m.to_dict() == m.dict()
+
+    def test_ordered_dict_in_insertion_order(self):
+        """Test PersistentOrderedDict keeps insertion order and skips tombstones."""
+        m = PersistentOrderedDict().assoc('b', 1).assoc('a', 2).assoc('c', 3).dissoc('a')
+        assert list(m.to_dict().items()) == [('b', 1), ('c', 3)]
+
+    def test_array_map(self):
+        """Test PersistentArrayMap converts in insertion order."""
+        m = PersistentArrayMap.create(x=1, y=2)
+        assert list(m.to_dict().items()) == [('x', 1), ('y', 2)]
+
+    def test_bag_and_multimap(self):
+        """Test the counting and multi-valued maps."""
+        bag = PersistentBag.from_iterable('abracadabra')
+        assert bag.to_dict() == {'a': 5, 'b': 2, 'r': 2, 'c': 1, 'd': 1}
+        mm = PersistentMultiMap.from_pairs([('a', 1), ('a', 2), ('b', 3)])
+        assert mm.to_dict() == {'a': {1, 2}, 'b': {3}}
+
+
+class TestToListAndSet:
+    """Test to_list and to_set."""
+
+    @pytest.mark.parametrize('n', [0, 1, 32, 33, 1025, 40000])
+    def test_list(self, n):
+        """Test PersistentList converts in order across trie levels."""
+        v = PersistentList.from_list(list(range(n)))
+        assert v.to_list() == list(range(n))
+        assert v.list() == list(range(n))
+
+    def test_set(self):
+        """Test PersistentSet converts to set and list."""
+        s = PersistentSet.from_iterable(range(1000))
+        assert s.to_set() == set(range(1000))
+        assert sorted(s.to_list()) == list(range(1000))
+        assert PersistentSet().to_set() == set()
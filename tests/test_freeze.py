@@ -0,0 +1,116 @@
+"""
+Tests for deep freeze() / thaw() conversion.
+
+Verifies that:
+- Nested dict/list/set/tuple payloads convert to persistent containers
+- thaw() inverts freeze() and handles every persistent container type
+- Shared sub-objects stay shared and cycles are rejected
+- Small dicts use PersistentArrayMap unless disabled
+"""
+
+import pytest
+from pypersistent import (PersistentArrayMap, PersistentDict, PersistentList,
+                          PersistentOrderedDict, PersistentSet, PersistentSortedDict,
+                          freeze, thaw)
+
+
+def payload(n):
+    return {
+        'events': [{'id': i, 'tags': {'a', 'b'}, 'pos': (i, [i, i + 1]), 'meta': None}
+                   for i in range(n)],
+        'index': {f'k{i}': i for i in range(n)},
+        'name': 'payload',
+    }
+
+
+class TestFreeze:
+    """Test converting plain containers to persistent ones."""
+
+    def test_types(self):
+        """Test each container maps to its persistent counterpart."""
+        frozen = freeze(payload(20))
+        assert isinstance(frozen, PersistentArrayMap)
+        assert isinstance(frozen['events'], PersistentList)
+        assert isinstance(frozen['index'], PersistentDict)
+        event = frozen['events'][3]
+        assert isinstance(event, PersistentArrayMap)
+        assert isinstance(event['tags'], PersistentSet)
+        assert isinstance(event['pos'], tuple)
+        assert isinstance(event['pos'][1], PersistentList)
+
+    def test_array_maps_disabled(self):
+        """Test array_maps=False always builds PersistentDict."""
+        frozen = freeze({'a': {'b': 1}}, array_maps=False)
+        assert isinstance(frozen, PersistentDict)
+        assert isinstance(frozen['a'], PersistentDict)
+
+    def test_round_trip(self):
+        """Test thaw(freeze(x)) == x for a large nested payload."""
+        data = payload(3000)
+        assert thaw(freeze(data)) == data
+
+    def test_scalars_and_unchanged_tuples(self):
+        """Test non-containers and immutable tuples are returned as-is."""
+        t = (1, 'a', (2, 3))
+        assert freeze(t) is t
+        obj = object()
+        assert freeze(obj) is obj
+        assert freeze(5) == 5
+        assert freeze(()) == ()
+
+    def test_persistent_values_kept(self):
+        """Test already-persistent containers are not converted again."""
+        inner = PersistentDict.from_dict({'x': 1})
+        assert freeze({'inner': inner})['inner'] is inner
+
+    def test_shared_subobjects(self):
+        """Test a list referenced twice is frozen once and stays shared."""
+        shared = [1, 2, 3]
+        frozen = freeze({'a': shared, 'b': shared})
+        assert frozen['a'] is frozen['b']
+
+    def test_cycle_detected(self):
+        """Test self-referencing containers raise ValueError."""
+        data = {'a': []}
+        data['a'].append(data)
+        with pytest.raises(ValueError, match='circular'):
+            freeze(data)
+
+    def test_deep_nesting(self):
+        """Test excessive nesting raises RecursionError."""
+        data = []
+        for _ in range(100000):
+            data = [data]
+        with pytest.raises(RecursionError):
+            freeze(data)
+
+
+class TestThaw:
+    """Test converting persistent containers to plain ones."""
+
+    def test_all_container_types(self):
+        """Test every persistent container thaws to dict/list/set."""
+        value = PersistentList.from_list([
+            PersistentDict.from_dict({'a': PersistentList.from_list([1, 2])}),
+            PersistentArrayMap.from_dict({'b': PersistentSet.from_list([1, 2])}),
+            PersistentSortedDict.from_dict({2: 'two', 1: 'one'}),
+            PersistentOrderedDict.from_dict({'z': 1, 'a': 2}),
+        ])
+        thawed = thaw(value)
+        assert thawed == [{'a': [1, 2]}, {'b': {1, 2}}, {1: 'one', 2: 'two'}, {'z': 1, 'a': 2}]
+        assert list(thawed[2]) == [1, 2]    # Sorted order
+        assert list(thawed[3]) == ['z', 'a']  # Insertion order
+
+    def test_plain_containers_copied(self):
+        """Test plain containers holding persistent values are rebuilt."""
+        data = {'x': [PersistentList.from_list([1]), (PersistentDict(), 2)]}
+        thawed = thaw(data)
+        assert thawed == {'x': [[1], ({}, 2)]}
+        assert thawed is not data
+
+    def test_cycle_detected(self):
+        """Test cycles in plain containers raise ValueError."""
+        data = []
+        data.append(data)
+        with pytest.raises(ValueError, match='circular'):
+            thaw(data)
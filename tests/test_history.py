@@ -0,0 +1,174 @@
+"""
+Tests for History - bounded version history of a PersistentDict.
+
+Verifies that:
+- snapshot/rollback/compact keep the right versions in order
+- Retention by count and by native byte budget drops the oldest first
+- retained_bytes tracks node sharing incrementally and agrees with
+  unique_bytes for histories of successive edits
+"""
+
+import pytest
+from pypersistent import History, PersistentDict
+
+
+def edits(n, base=None):
+    """Versions produced by n successive single-key edits."""
+    state = base if base is not None else PersistentDict.from_dict({i: i for i in range(1000)})
+    versions = [state]
+    for i in range(n):
+        state = state.assoc(i % 50, -i)
+        versions.append(state)
+    return versions
+
+
+class TestHistoryVersions:
+    """Test recording and navigating versions."""
+
+    def test_empty_initial(self):
+        """Test the default first version is an empty PersistentDict."""
+        h = History()
+        assert len(h) == 1
+        assert h.current == PersistentDict()
+        assert h.retained_bytes() == 0
+
+    def test_snapshot_and_index(self):
+        """Test versions are kept oldest first."""
+        vs = edits(5)
+        h = History(vs[0])
+        for v in vs[1:]:
+            h.snapshot(v)
+        assert len(h) == 6
+        assert h.current == vs[-1]
+        assert h[0] == vs[0]
+        assert h[-2] == vs[-2]
+        assert h.versions() == vs
+        with pytest.raises(IndexError):
+            h[6]
+
+    def test_rollback(self):
+        """Test rollback drops the newest versions and returns the current one."""
+        vs = edits(5)
+        h = History(vs[0])
+        for v in vs[1:]:
+            h.snapshot(v)
+        assert h.rollback() == vs[4]
+        assert h.rollback(2) == vs[2]
+        assert h.current == vs[2]
+        assert len(h) == 3
+        with pytest.raises(IndexError):
+            h.rollback(3)
+        assert len(h) == 3
+
+    def test_compact(self):
+        """Test compaction drops only the versions between the endpoints."""
+        vs = edits(10)
+        h = History(vs[0])
+        for v in vs[1:]:
+            h.snapshot(v)
+        h.compact(2, 8)
+        assert h.versions() == vs[:3] + vs[8:]
+        h.compact()
+        assert h.versions() == [vs[0], vs[-1]]
+
+    def test_current_outlives_its_slot(self):
+        """Test h.current stays valid after its version leaves the history."""
+        vs = edits(3)
+        h = History(vs[0])
+        h.snapshot(vs[1])
+        current = h.current
+        h.rollback()
+        h.compact()
+        assert current == vs[1] and len(current) == 1000
+
+        bounded = History(vs[0], max_versions=1)
+        first = bounded.current
+        bounded.snapshot(vs[1])
+        bounded.snapshot(vs[2])
+        assert first == vs[0] and dict(first.items()) == dict(vs[0].items())
+        assert bounded.current == vs[2]
+
+
+class TestHistoryRetention:
+    """Test retention policies and byte accounting."""
+
+    def test_max_versions(self):
+        """Test only the newest max_versions versions are kept."""
+        vs = edits(20)
+        h = History(vs[0], max_versions=4)
+        for v in vs[1:]:
+            h.snapshot(v)
+        assert h.versions() == vs[-4:]
+        with pytest.raises(ValueError):
+            History(max_versions=0)
+
+    def test_retained_bytes_matches_analysis(self):
+        """Test incremental accounting equals the exact node ownership totals."""
+        vs = edits(30)
+        h = History(vs[0], max_versions=10)
+        for v in vs[1:]:
+            h.snapshot(v)
+        unique = h.unique_bytes()
+        assert len(unique) == 10
+        # Every version of a successive-edit history holds some nodes of its own
+        assert all(b > 0 for b in unique[1:])
+        # Total minus shared nodes is the sum of what each version alone holds
+        assert sum(unique) < h.retained_bytes()
+
+        # Retained bytes after drops equal those of a history built from scratch
+        fresh = History(vs[-10])
+        for v in vs[-9:]:
+            fresh.snapshot(v)
+        assert fresh.retained_bytes() == h.retained_bytes()
+
+    def test_snapshots_share_nodes(self):
+        """Test an edit retains far fewer bytes than a full copy."""
+        vs = edits(1)
+        h = History(vs[0])
+        full = h.retained_bytes()
+        h.snapshot(vs[1])
+        added = h.retained_bytes() - full
+        assert 0 < added < full // 10
+        # Snapshotting the same version again retains nothing new
+        h.snapshot(vs[1])
+        assert h.retained_bytes() == full + added
+        assert h.unique_bytes()[1:] == [0, 0]
+
+    def test_rollback_and_compact_restore_accounting(self):
+        """Test rollback and compact leave the accounting of a fresh history."""
+        vs = edits(12)
+        h = History(vs[0])
+        for v in vs[1:]:
+            h.snapshot(v)
+        h.rollback(4)
+        h.compact(1, 6)
+        fresh = History(vs[0])
+        for v in (vs[1], vs[6], vs[7], vs[8]):
+            fresh.snapshot(v)
+        assert h.versions() == fresh.versions()
+        assert h.retained_bytes() == fresh.retained_bytes()
+
+    def test_max_bytes(self):
+        """Test the byte budget drops the oldest versions first."""
+        vs = edits(40)
+        probe = History(vs[0])
+        budget = probe.retained_bytes() * 3 // 2
+        h = History(vs[0], max_bytes=budget)
+        for v in vs[1:]:
+            h.snapshot(v)
+            assert h.retained_bytes() <= budget
+        assert h.current == vs[-1]
+        assert 1 < len(h) < len(vs)
+        assert h.versions() == vs[-len(h):]
+
+    def test_set_retention(self):
+        """Test tightening the policy applies immediately."""
+        vs = edits(10)
+        h = History(vs[0])
+        for v in vs[1:]:
+            h.snapshot(v)
+        h.set_retention(max_versions=3)
+        assert h.max_versions == 3
+        assert h.versions() == vs[-3:]
+        h.set_retention(max_bytes=1)
+        assert h.versions() == [vs[-1]]
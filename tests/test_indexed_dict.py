@@ -0,0 +1,166 @@
+"""
+Tests for IndexedPersistentDict - records with maintained secondary indexes.
+
+Verifies that:
+- Hash and sorted indexes match a rebuild from the records after any mix
+  of assoc, dissoc and update
+- Earlier versions keep their own indexes
+- Range queries on sorted indexes and errors for unknown or hash indexes
+"""
+
+import random
+
+import pytest
+from pypersistent import (IndexedPersistentDict, PersistentDict,
+                          PersistentMultiMap, PersistentSet,
+                          PersistentSortedDict)
+
+
+def make(data=None):
+    """Users indexed by city (hash) and age (sorted); None city is unindexed."""
+    return IndexedPersistentDict(
+        indexes={'city': lambda r: r['city']},
+        sorted_indexes={'age': lambda r: r['age']},
+        data=data)
+
+
+def rebuilt(records, field):
+    """Reference index: field value -> set of ids."""
+    index = {}
+    for key, record in records.items():
+        if record[field] is not None:
+            index.setdefault(record[field], set()).add(key)
+    return index
+
+
+def check(d, records):
+    """Assert both indexes agree with the records."""
+    assert len(d) == len(records)
+    for field in ('city', 'age'):
+        want = rebuilt(records, field)
+        for value, ids in want.items():
+            assert set(d.lookup(field, value)) == ids
+    ages = rebuilt(records, 'age')
+    assert list(d.index('age').keys()) == sorted(ages)
+    assert set(d.index('city').keys_list()) == set(rebuilt(records, 'city'))
+
+
+class TestIndexedPersistentDictMaintenance:
+    """Test index maintenance across updates."""
+
+    def test_assoc_and_lookup(self):
+        """Test records are indexed on insert and moved on change."""
+        d = make()
+        d = d.assoc(1, {'city': 'Oslo', 'age': 30})
+        d = d.assoc(2, {'city': 'Oslo', 'age': 41})
+        assert d.lookup('city', 'Oslo') == PersistentSet.from_list([1, 2])
+        d = d.assoc(2, {'city': 'Rome', 'age': 41})
+        assert d.lookup('city', 'Oslo') == PersistentSet.from_list([1])
+        assert d.lookup('city', 'Rome') == PersistentSet.from_list([2])
+        assert d.lookup('city', 'Paris') == PersistentSet()
+        assert d[2]['city'] == 'Rome'
+        with pytest.raises(KeyError) as exc_info:
+            d[(3, 4)]
+        assert exc_info.value.args == ((3, 4),)
+
+    def test_dissoc_drops_empty_buckets(self):
+        """Test removing the last record of a value removes its bucket."""
+        d = make({1: {'city': 'Oslo', 'age': 30}, 2: {'city': 'Rome', 'age': 30}})
+        d = d.dissoc(1)
+        assert 'Oslo' not in d.index('city')
+        assert list(d.lookup('age', 30)) == [2]
+        d = d.dissoc(2).dissoc(99)
+        assert len(d.index('age')) == 0
+        assert len(d) == 0
+
+    def test_none_key_not_indexed(self):
+        """Test None from a key function leaves the record out of that index."""
+        d = make({1: {'city': None, 'age': 5}})
+        assert len(d.index('city')) == 0
+        assert list(d.lookup('age', 5)) == [1]
+        d = d.assoc(1, {'city': 'Oslo', 'age': 5})
+        assert list(d.lookup('city', 'Oslo')) == [1]
+
+    def test_random_operations(self):
+        """Test indexes match a rebuild after random assoc/dissoc/update."""
+        rng = random.Random(11)
+        cities = ['Oslo', 'Rome', 'Lima', None]
+        records = {}
+        d = make()
+        for step in range(600):
+            key = rng.randrange(150)
+            op = rng.random()
+            if op < 0.2:
+                records.pop(key, None)
+                d = d.dissoc(key)
+            elif op < 0.25:
+                batch = {rng.randrange(150): {'city': rng.choice(cities), 'age': rng.randrange(90)}
+                         for _ in range(rng.choice([3, 200]))}
+                records.update(batch)
+                d = d.update(batch if step % 2 else PersistentDict.from_dict(batch))
+            else:
+                record = {'city': rng.choice(cities), 'age': rng.randrange(90)}
+                records[key] = record
+                d = d.assoc(key, record)
+            if step % 50 == 0:
+                check(d, records)
+        check(d, records)
+
+    def test_bulk_construction(self):
+        """Test initial data is indexed like successive assocs."""
+        records = {i: {'city': ['a', 'b', 'c'][i % 3], 'age': i % 17} for i in range(1000)}
+        bulk = make(records)
+        check(bulk, records)
+        built = make()
+        for key, record in records.items():
+            built = built.assoc(key, record)
+        assert bulk.index('age') == built.index('age')
+        assert bulk.data == built.data
+
+    def test_versions_keep_their_indexes(self):
+        """Test older versions are unaffected by later updates."""
+        v1 = make({1: {'city': 'Oslo', 'age': 30}})
+        v2 = v1.assoc(1, {'city': 'Rome', 'age': 31})
+        assert list(v1.lookup('city', 'Oslo')) == [1]
+        assert list(v2.lookup('city', 'Oslo')) == []
+        assert list(v1.lookup('age', 30)) == [1]
+
+    def test_failed_update_leaves_original(self):
+        """Test an exception from a key function leaves the dict unchanged."""
+        d = make({1: {'city': 'Oslo', 'age': 30}})
+        with pytest.raises(KeyError):
+            d.assoc(2, {'city': 'Rome'})
+        assert len(d) == 1
+        assert list(d.lookup('city', 'Oslo')) == [1]
+
+
+class TestIndexedPersistentDictQueries:
+    """Test range queries and index access."""
+
+    def test_range(self):
+        """Test range queries over a sorted index."""
+        d = make({i: {'city': 'x', 'age': i % 10} for i in range(100)})
+        r = d.range('age', 3, 6)
+        assert list(r.keys()) == [3, 4, 5]
+        assert len(r) == 3
+        assert set(r.first()[1]) == {i for i in range(100) if i % 10 == 3}
+        assert list(d.range('age', 8).keys()) == [8, 9]
+        assert list(d.range('age', stop=2, inclusive=(True, True)).keys()) == [0, 1, 2]
+
+    def test_index_access(self):
+        """Test index kinds, names and errors for bad index names."""
+        d = make()
+        assert d.index_names() == ['city', 'age']
+        assert isinstance(d.index('city'), PersistentMultiMap)
+        assert isinstance(d.index('age'), PersistentSortedDict)
+        with pytest.raises(KeyError):
+            d.lookup('nope', 1)
+        with pytest.raises(ValueError):
+            d.range('city', 'a', 'b')
+
+    def test_declaration_errors(self):
+        """Test duplicate names and non-callable key functions are rejected."""
+        with pytest.raises(ValueError):
+            IndexedPersistentDict(indexes={'a': len}, sorted_indexes={'a': len})
+        with pytest.raises(TypeError):
+            IndexedPersistentDict(indexes={'a': 1})
@@ -0,0 +1,197 @@
+"""
+Tests for the direct JSON codec (loads_json / dumps_json).
+
+Verifies that:
+- Documents parse straight into PersistentDict/PersistentArrayMap/PersistentList
+- Parsed values match json.loads, including escapes, numbers and duplicates
+- Object keys are interned and shared across the document
+- dumps_json matches compact json.dumps and round-trips
+- Malformed input and unsupported types raise the usual errors
+"""
+
+import json
+
+import pytest
+from pypersistent import (PersistentArrayMap, PersistentDict, PersistentList,
+                          dumps_json, loads_json)
+
+
+def thaw(value):
+    """Convert parsed persistent structures back to plain dicts and lists."""
+    if isinstance(value, (PersistentDict, PersistentArrayMap)):
+        return {k: thaw(v) for k, v in value.items()}
+    if isinstance(value, PersistentList):
+        return [thaw(v) for v in value]
+    return value
+
+
+class TestLoadsJson:
+    """Test parsing JSON into persistent structures."""
+
+    def test_scalars(self):
+        """Test top-level scalars."""
+        assert loads_json(b'null') is None
+        assert loads_json(b'true') is True
+        assert loads_json(b'false') is False
+        assert loads_json(b' 42 ') == 42
+        assert loads_json(b'-1.5e3') == -1500.0
+        assert loads_json(b'"hi"') == 'hi'
+
+    def test_container_types(self):
+        """Test small objects use ArrayMap, large ones PersistentDict."""
+        small = loads_json(b'{"a": 1, "b": [1, 2, 3]}')
+        assert isinstance(small, PersistentArrayMap)
+        assert isinstance(small['b'], PersistentList)
+
+        large = loads_json(json.dumps({str(i): i for i in range(20)}).encode())
+        assert isinstance(large, PersistentDict)
+        assert large['19'] == 19
+
+        plain = loads_json(b'{"a": 1}', array_maps=False)
+        assert isinstance(plain, PersistentDict)
+        assert isinstance(loads_json(b'{}', array_maps=False), PersistentDict)
+
+    def test_matches_json_loads(self):
+        """Test a nested document against the stdlib parser."""
+        doc = {
+            'users': [{'id': i, 'name': f'user{i}', 'tags': ['a', 'b'][:i % 3],
+                       'score': i * 0.25, 'active': i % 2 == 0, 'meta': None}
+                      for i in range(200)],
+            'count': 200,
+            'nested': {'deep': {'deeper': [[], {}, [[1]]]}},
+        }
+        text = json.dumps(doc)
+        assert thaw(loads_json(text.encode())) == json.loads(text)
+        assert thaw(loads_json(text)) == json.loads(text)  # str input
+
+    def test_large_array_and_object(self):
+        """Test bulk-built containers past the tail and the trie root."""
+        for n in (31, 32, 33, 1024, 1056, 1057, 40000):
+            values = list(range(n))
+            parsed = loads_json(json.dumps(values).encode())
+            assert len(parsed) == n
+            assert parsed[0] == 0 and parsed[n - 1] == n - 1
+            assert list(parsed) == values
+            assert parsed.append('x')[n] == 'x'
+
+        obj = {f'k{i}': i for i in range(5000)}
+        parsed = loads_json(json.dumps(obj).encode())
+        assert len(parsed) == 5000
+        assert thaw(parsed) == obj
+
+    def test_strings_and_escapes(self):
+        """Test escape sequences, surrogate pairs and non-ASCII text."""
+        cases = [r'"a\"b\\c\/d"', r'"\b\f\n\r\t"', r'"é中"',
+                 r'"😀"', r'"\ud800"', '"café \U0001f600"']
+        for text in cases:
+            assert loads_json(text.encode('utf-8', 'surrogatepass')) == json.loads(text)
+
+    def test_numbers(self):
+        """Test integer precision, big ints and float forms."""
+        text = '[0, -0, 123456789012345678, 1234567890123456789012, -9223372036854775809, 1.0, 1e400, 0.1]'
+        assert list(loads_json(text.encode())) == json.loads(text)
+        assert list(loads_json(b'[NaN, Infinity, -Infinity]'))[1:] == [float('inf'), float('-inf')]
+
+    def test_duplicate_keys_last_wins(self):
+        """Test duplicate keys keep the last value, small and large objects."""
+        assert loads_json(b'{"a": 1, "a": 2}')['a'] == 2
+        pairs = ', '.join(f'"k{i}": {i}' for i in range(20))
+        parsed = loads_json(f'{{{pairs}, "k3": "last", "k15": "again"}}'.encode())
+        assert len(parsed) == 20
+        assert parsed['k3'] == 'last'
+        assert parsed['k15'] == 'again'
+
+    def test_keys_are_interned(self):
+        """Test repeated field names share one string object."""
+        events = loads_json(json.dumps([{'event_type': i} for i in range(10)]).encode())
+        keys = [next(iter(e.keys())) for e in events]
+        assert all(k is keys[0] for k in keys)
+
+    def test_buffer_inputs(self):
+        """Test bytearray, memoryview and a UTF-8 BOM."""
+        assert loads_json(bytearray(b'[1, 2]'))[1] == 2
+        assert loads_json(memoryview(b'{"a": 1}'))['a'] == 1
+        assert loads_json(b'\xef\xbb\xbf[1]')[0] == 1
+
+    @pytest.mark.parametrize('text', [
+        b'', b'[1, 2', b'{"a" 1}', b'{"a": 1,}', b'[1,]', b'{a: 1}',
+        b'"unterminated', b'"bad \\x escape"', b'"tab\there"', b'01x', b'[1] 2', b'tru',
+    ])
+    def test_malformed(self, text):
+        """Test malformed documents raise ValueError."""
+        with pytest.raises(ValueError):
+            loads_json(text)
+
+    def test_error_position(self):
+        """Test the error message carries line and column."""
+        with pytest.raises(ValueError, match='line 2 column 3'):
+            loads_json(b'[1,\n  x]')
+
+    def test_deep_nesting(self):
+        """Test hostile nesting raises RecursionError instead of crashing."""
+        with pytest.raises(RecursionError):
+            loads_json(b'[' * 100000 + b']' * 100000)
+
+    def test_invalid_input_type(self):
+        """Test non-text input raises TypeError."""
+        with pytest.raises(TypeError):
+            loads_json(42)
+
+
+class TestDumpsJson:
+    """Test serializing persistent structures."""
+
+    def test_matches_json_dumps(self):
+        """Test output equals compact json.dumps of the thawed value."""
+        doc = {'a': [1, 2.5, None, True, False, 'x"y\né'], 'b': {'c': []}, 'd': {}}
+        parsed = loads_json(json.dumps(doc).encode())
+        expected = json.dumps(thaw(parsed), separators=(',', ':'), ensure_ascii=False)
+        assert dumps_json(parsed) == expected.encode()
+
+    def test_round_trip_large(self):
+        """Test dumps/loads round trip on large tries."""
+        m = PersistentDict.from_dict({f'k{i}': [i, str(i)] for i in range(3000)})
+        restored = loads_json(dumps_json(m))
+        assert thaw(restored) == thaw(m)
+
+        v = PersistentList.from_list(list(range(5000)))
+        assert dumps_json(v) == json.dumps(list(range(5000)), separators=(',', ':')).encode()
+
+    def test_sort_keys(self):
+        """Test sort_keys gives json.dumps(sort_keys=True) output."""
+        data = {f'key{i}': i for i in range(100)}
+        m = PersistentDict.from_dict(data)
+        expected = json.dumps(data, sort_keys=True, separators=(',', ':'))
+        assert dumps_json(m, sort_keys=True) == expected.encode()
+
+        # Keys sort by value, not by their JSON text
+        numeric = PersistentDict.from_dict({10: 1, 9: 2, 2.5: 3})
+        assert dumps_json(numeric, sort_keys=True) == b'{"2.5":3,"9":2,"10":1}'
+        assert dumps_json({10: 1, 9: 2}, sort_keys=True) == b'{"9":2,"10":1}'
+
+    def test_sort_keys_incomparable(self):
+        """Test sort_keys raises TypeError on keys that cannot be ordered."""
+        with pytest.raises(TypeError):
+            json.dumps({1: 'a', 'b': 2}, sort_keys=True)
+        with pytest.raises(TypeError):
+            dumps_json(PersistentDict.from_dict({1: 'a', 'b': 2}), sort_keys=True)
+        # Unsorted output accepts the same mix
+        assert json.loads(dumps_json({1: 'a', 'b': 2})) == {'1': 'a', 'b': 2}
+
+    def test_plain_containers_and_keys(self):
+        """Test dict/list/tuple values and non-str keys, like json.dumps."""
+        data = {'t': (1, 2), 1: 'one', 2.5: 'x', True: 'yes', None: 'nil'}
+        assert json.loads(dumps_json(data)) == json.loads(json.dumps(data))
+
+    def test_special_floats_and_big_ints(self):
+        """Test NaN/Infinity and integers beyond 64 bits."""
+        out = dumps_json([float('nan'), float('inf'), -float('inf'), 2 ** 100, -2 ** 70, 1e16])
+        assert out == json.dumps([float('nan'), float('inf'), -float('inf'),
+                                  2 ** 100, -2 ** 70, 1e16], separators=(',', ':')).encode()
+
+    def test_unsupported_types(self):
+        """Test non-serializable values and keys raise TypeError."""
+        with pytest.raises(TypeError):
+            dumps_json({'a': object()})
+        with pytest.raises(TypeError):
+            dumps_json({(1, 2): 'tuple key'})
@@ -0,0 +1,168 @@
+"""
+Tests for the native subscript and iteration slots.
+
+Verifies that:
+- Misses raise the same exception types as before (KeyError, IndexError)
+- Slices and explicit __getitem__/__next__ calls keep working
+- Errors raised by user __hash__/__eq__ propagate through the fast paths
+- Iteration over every container ends cleanly
+"""
+
+import pytest
+from pypersistent import (IndexedPersistentDict, PersistentArrayMap,
+                          PersistentDict, PersistentList, PersistentMultiMap,
+                          PersistentOrderedDict, PersistentSet,
+                          PersistentSortedDict)
+
+
+class BadHash:
+    """Key whose __hash__ raises."""
+
+    def __hash__(self):
+        raise RuntimeError('no hash')
+
+
+# Maps with keys()/values()/items() views
+VIEW_MAPS = [
+    lambda: PersistentDict.from_dict({'a': 1, (1, 2): 2}),
+    lambda: PersistentArrayMap.from_dict({'a': 1, (1, 2): 2}),
+    lambda: PersistentSortedDict.from_dict({'a': 1, 'b': 2}),
+    lambda: PersistentOrderedDict.from_dict({'a': 1, (1, 2): 2}),
+]
+
+MAPS = VIEW_MAPS + [
+    lambda: IndexedPersistentDict(indexes={'parity': lambda r: r % 2},
+                                  data={'a': 1, (1, 2): 2}),
+]
+
+
+class TestMapSubscript:
+    """Test map lookups through the native slot."""
+
+    @pytest.mark.parametrize('make', MAPS)
+    def test_hit_and_miss(self, make):
+        """Test hits return the value and misses raise KeyError(key)."""
+        m = make()
+        assert m['a'] == 1
+        with pytest.raises(KeyError) as exc_info:
+            m['missing']
+        assert exc_info.value.args == ('missing',)
+
+    def test_tuple_key_not_unpacked(self):
+        """Test a missing tuple key is reported whole, like dict."""
+        with pytest.raises(KeyError) as exc_info:
+            PersistentDict()[(3, 4)]
+        assert exc_info.value.args == ((3, 4),)
+
+    def test_many_misses(self):
+        """Test a miss-heavy loop leaves no error state behind."""
+        m = PersistentDict.from_dict({i: i for i in range(100)})
+        misses = 0
+        for i in range(200):
+            try:
+                m[i]
+            except KeyError:
+                misses += 1
+        assert misses == 100
+
+    def test_hash_error_propagates(self):
+        """Test errors from __hash__ are raised, not turned into KeyError."""
+        with pytest.raises(RuntimeError, match='no hash'):
+            PersistentDict.from_dict({'a': 1})[BadHash()]
+
+    def test_multimap(self):
+        """Test PersistentMultiMap lookups and misses."""
+        mm = PersistentMultiMap.from_pairs([('a', 1), ('a', 2)])
+        assert set(mm['a']) == {1, 2}
+        with pytest.raises(KeyError):
+            mm['b']
+
+    def test_sorted_dict_slice(self):
+        """Test range slices still reach the slicing __getitem__."""
+        m = PersistentSortedDict.from_dict({i: i for i in range(10)})
+        assert list(m[2:5].keys()) == [2, 3, 4]
+
+    def test_explicit_dunder(self):
+        """Test calling __getitem__ directly still works."""
+        m = PersistentDict.from_dict({'a': 1})
+        assert m.__getitem__('a') == 1
+        with pytest.raises(KeyError) as exc_info:
+            m.__getitem__('b')
+        assert exc_info.value.args == ('b',)
+
+    @pytest.mark.parametrize('make', MAPS + [lambda: PersistentMultiMap.from_pairs([('a', 1)])])
+    def test_explicit_dunder_same_error(self, make):
+        """Test __getitem__ and super().__getitem__ raise the slot's KeyError."""
+        m = make()
+
+        class Sub(type(m)):
+            def __getitem__(self, key):
+                return super().__getitem__(key)
+
+        sub = Sub()
+        for call in (lambda k: m[k], m.__getitem__, lambda k: sub[k]):
+            with pytest.raises(KeyError) as exc_info:
+                call('missing')
+            assert exc_info.value.args == ('missing',)
+
+    def test_subclass_override(self):
+        """Test a Python subclass can still override __getitem__."""
+        class Defaulting(PersistentDict):
+            def __getitem__(self, key):
+                return self.get(key, 'default')
+
+        assert Defaulting()['x'] == 'default'
+
+
+class TestListSubscript:
+    """Test list indexing through the native slot."""
+
+    def test_index(self):
+        """Test positive, negative and out-of-range indices."""
+        v = PersistentList.from_list(list(range(100)))
+        assert v[5] == 5 and v[-1] == 99 and v[True] == 1
+        for bad in (100, -101, 2**80, -2**80):
+            with pytest.raises(IndexError):
+                v[bad]
+
+    def test_slices_and_bad_types(self):
+        """Test slices fall through and bad index types raise TypeError."""
+        v = PersistentList.from_list(list(range(10)))
+        assert list(v[2:4]) == [2, 3]
+        with pytest.raises(TypeError):
+            v['a']
+
+
+class TestIteratorExhaustion:
+    """Test iterators end without raising from the native slot."""
+
+    @pytest.mark.parametrize('make', VIEW_MAPS)
+    def test_map_views(self, make):
+        """Test keys, values and items iterate fully and then stop."""
+        m = make()
+        assert len(list(m.keys())) == len(m)
+        assert len(list(m.values())) == len(m)
+        assert len(list(m.items())) == len(m)
+
+    def test_list_and_set(self):
+        """Test list and set iteration ends cleanly."""
+        assert list(iter(PersistentList.from_list([1, 2, 3]))) == [1, 2, 3]
+        assert sorted(PersistentSet.from_iterable([3, 1, 2])) == [1, 2, 3]
+        assert list(PersistentList()) == []
+
+    def test_next_after_exhaustion(self):
+        """Test next() keeps raising StopIteration after the end."""
+        it = iter(PersistentDict.from_dict({'a': 1}))
+        assert next(it) == 'a'
+        with pytest.raises(StopIteration):
+            next(it)
+        with pytest.raises(StopIteration):
+            next(it)
+        assert next(it, 'done') == 'done'
+
+    def test_ordered_dict_tombstones(self):
+        """Test ordered iteration skips removed entries up to the end."""
+        m = PersistentOrderedDict().assoc('a', 1).assoc('b', 2).assoc('c', 3)
+        m = m.dissoc('c').dissoc('a')
+        assert list(m.keys()) == ['b']
+        assert list(m.items()) == [('b', 2)]
@@ -0,0 +1,80 @@
+"""
+Tests for tracemalloc visibility of native allocations.
+
+Verifies that:
+- Each container reports its nodes under its own tracemalloc domain
+- Memory is untracked again when the container is freed
+- Tracebacks point at the Python line that built the container
+"""
+
+import gc
+import tracemalloc
+
+import pytest
+from pypersistent import (PersistentDict, PersistentIntervalMap, PersistentList,
+                          PersistentSortedDict, TRACEMALLOC_DOMAINS)
+
+
+def domain_bytes(snapshot, name):
+    """Total traced bytes in the domain of the named container."""
+    domain = TRACEMALLOC_DOMAINS[name]
+    filtered = snapshot.filter_traces([tracemalloc.DomainFilter(True, domain)])
+    return sum(stat.size for stat in filtered.statistics('filename'))
+
+
+@pytest.fixture
+def tracing():
+    tracemalloc.start()
+    try:
+        yield
+    finally:
+        tracemalloc.stop()
+
+
+class TestTracemallocDomains:
+    """Test per-container tracemalloc domains."""
+
+    def test_domains_are_distinct(self):
+        """Test that every container has its own non-default domain."""
+        values = list(TRACEMALLOC_DOMAINS.values())
+        assert len(set(values)) == len(values)
+        assert 0 not in values
+        assert 'PersistentDict' in TRACEMALLOC_DOMAINS
+
+    @pytest.mark.parametrize('name, build', [
+        ('PersistentDict', lambda: PersistentDict.from_dict({i: i for i in range(5000)})),
+        ('PersistentSortedDict', lambda: PersistentSortedDict.from_dict({i: i for i in range(5000)})),
+        ('PersistentList', lambda: PersistentList.from_list(list(range(5000)))),
+        ('PersistentIntervalMap',
+         lambda: PersistentIntervalMap.from_items([(i, i + 1, i) for i in range(5000)])),
+    ])
+    def test_build_is_traced_and_released(self, tracing, name, build):
+        """Test that building traces memory in the domain and freeing releases it."""
+        gc.collect()
+        before = domain_bytes(tracemalloc.take_snapshot(), name)
+
+        container = build()
+        during = domain_bytes(tracemalloc.take_snapshot(), name)
+        assert during - before > 5000 * 16  # At least a few bytes per element
+
+        del container
+        gc.collect()
+        after = domain_bytes(tracemalloc.take_snapshot(), name)
+        assert after <= before
+
+    def test_traceback_points_at_caller(self, tracing):
+        """Test that traced node memory is attributed to this file."""
+        m = PersistentDict()
+        for i in range(2000):
+            m = m.assoc(i, i)
+        snapshot = tracemalloc.take_snapshot().filter_traces(
+            [tracemalloc.DomainFilter(True, TRACEMALLOC_DOMAINS['PersistentDict'])])
+        files = {stat.traceback[0].filename for stat in snapshot.statistics('filename')}
+        assert any(f.endswith('test_memory_tracking.py') for f in files)
+        assert len(m) == 2000
+
+    def test_untraced_when_tracemalloc_off(self):
+        """Test that containers work normally without tracing."""
+        assert not tracemalloc.is_tracing()
+        m = PersistentDict.from_dict({i: i for i in range(1000)})
+        assert len(m.dissoc(5)) == 999
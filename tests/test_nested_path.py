@@ -0,0 +1,143 @@
+"""
+Tests for nested-path operations (get_in, assoc_in, update_in, dissoc_in).
+
+Verifies that:
+- Paths descend through any mix of dict, array map, sorted dict and list levels
+- Updates rebuild only the spine and leave the original untouched
+- Unchanged updates return the original object
+- Missing levels are created (assoc/update) or ignored (get/dissoc)
+"""
+
+import pytest
+from pypersistent import (PersistentArrayMap, PersistentDict, PersistentList,
+                          PersistentSortedDict)
+
+
+@pytest.fixture
+def state():
+    return PersistentDict.from_dict({
+        'users': PersistentList.from_list([
+            PersistentArrayMap.from_dict({'name': 'alice', 'score': 1}),
+            PersistentArrayMap.from_dict({'name': 'bob', 'score': 2}),
+        ]),
+        'config': PersistentSortedDict.from_dict({'depth': PersistentDict.from_dict({'max': 3})}),
+        'sibling': PersistentDict.from_dict({'x': 1}),
+    })
+
+
+class TestGetIn:
+    """Test nested lookups."""
+
+    def test_mixed_levels(self, state):
+        """Test lookups through every container type."""
+        assert state.get_in(['users', 1, 'name']) == 'bob'
+        assert state.get_in(('config', 'depth', 'max')) == 3
+        assert state.get_in(['users', -1, 'score']) == 2
+
+    def test_missing(self, state):
+        """Test missing keys, bad indices and scalars return the default."""
+        assert state.get_in(['nope', 'x']) is None
+        assert state.get_in(['users', 5, 'name'], 'dflt') == 'dflt'
+        assert state.get_in(['users', 'x'], 'dflt') == 'dflt'
+        assert state.get_in(['users', 0, 'name', 'deeper'], 'dflt') == 'dflt'
+
+    def test_empty_path(self, state):
+        """Test an empty path returns the container itself."""
+        assert state.get_in([]) is state
+
+    def test_string_path_rejected(self, state):
+        """Test a bare string is not treated as a path of characters."""
+        with pytest.raises(TypeError):
+            state.get_in('users')
+
+
+class TestAssocIn:
+    """Test nested sets."""
+
+    def test_spine_rebuilt(self, state):
+        """Test only the path is copied and the original is unchanged."""
+        updated = state.assoc_in(['users', 0, 'score'], 10)
+        assert updated.get_in(['users', 0, 'score']) == 10
+        assert state.get_in(['users', 0, 'score']) == 1
+        assert updated['sibling'] is state['sibling']
+        assert updated['users'][1] is state['users'][1]
+        assert isinstance(updated['users'][0], PersistentArrayMap)
+
+    def test_sorted_dict_level(self, state):
+        """Test updates through a PersistentSortedDict level."""
+        updated = state.assoc_in(['config', 'depth', 'max'], 5)
+        assert isinstance(updated['config'], PersistentSortedDict)
+        assert updated.get_in(['config', 'depth', 'max']) == 5
+
+    def test_creates_missing_levels(self):
+        """Test missing intermediate levels become PersistentDicts."""
+        m = PersistentDict().assoc_in(['a', 'b', 'c'], 1)
+        assert isinstance(m['a'], PersistentDict)
+        assert m.get_in(['a', 'b', 'c']) == 1
+
+    def test_list_append_and_range(self):
+        """Test index == len appends and larger indices raise."""
+        v = PersistentList.from_list([1, 2])
+        assert list(v.assoc_in([2], 3)) == [1, 2, 3]
+        with pytest.raises(IndexError):
+            v.assoc_in([5], 3)
+        with pytest.raises(TypeError):
+            v.assoc_in(['a'], 3)
+
+    def test_same_value_keeps_identity(self, state):
+        """Test storing the existing object returns the original container."""
+        name = state.get_in(['users', 0, 'name'])
+        assert state.assoc_in(['users', 0, 'name'], name) is state
+
+    def test_scalar_level_raises(self, state):
+        """Test descending into a non-container raises TypeError."""
+        with pytest.raises(TypeError):
+            state.assoc_in(['users', 0, 'name', 'x'], 1)
+
+    def test_empty_path_raises(self, state):
+        """Test an empty path raises ValueError."""
+        with pytest.raises(ValueError):
+            state.assoc_in([], 1)
+
+
+class TestUpdateIn:
+    """Test nested read-modify-write."""
+
+    def test_update(self, state):
+        """Test fn receives the current value."""
+        updated = state.update_in(['users', 1, 'score'], lambda s: s + 40)
+        assert updated.get_in(['users', 1, 'score']) == 42
+
+    def test_missing_leaf_gets_none(self):
+        """Test fn receives None for a missing leaf."""
+        m = PersistentDict().update_in(['counts', 'a'], lambda c: (c or 0) + 1)
+        m = m.update_in(['counts', 'a'], lambda c: (c or 0) + 1)
+        assert m.get_in(['counts', 'a']) == 2
+
+    def test_deep_chain(self):
+        """Test repeated updates on a deep path."""
+        path = [f'k{i}' for i in range(20)]
+        m = PersistentDict()
+        for _ in range(100):
+            m = m.update_in(path, lambda c: (c or 0) + 1)
+        assert m.get_in(path) == 100
+
+
+class TestDissocIn:
+    """Test nested removals."""
+
+    def test_remove(self, state):
+        """Test the leaf key is removed from each map type."""
+        assert 'score' not in state.dissoc_in(['users', 0, 'score'])['users'][0]
+        assert 'max' not in state.dissoc_in(['config', 'depth', 'max']).get_in(['config', 'depth'])
+        assert 'sibling' not in state.dissoc_in(['sibling'])
+
+    def test_missing_path_unchanged(self, state):
+        """Test missing paths return the original container."""
+        assert state.dissoc_in(['nope', 'x']) is state
+        assert state.dissoc_in(['users', 9, 'name']) is state
+
+    def test_list_element_raises(self, state):
+        """Test removing a list element raises TypeError."""
+        with pytest.raises(TypeError):
+            state.dissoc_in(['users', 0])
@@ -0,0 +1,146 @@
+"""
+Tests for PersistentBag - Immutable multiset / counter
+
+Tests verify:
+- Basic operations (add, increment, remove, remove_all, count)
+- Size accounting (total multiplicity vs. distinct elements)
+- Immutability guarantees
+- Bulk construction (from_iterable, from_counts)
+- Merge summing counts, including large structural merges
+- most_common, equality, repr and pickling
+"""
+
+import pickle
+from collections import Counter
+
+import pytest
+from pypersistent import PersistentBag
+
+
+class TestPersistentBagBasics:
+    """Test basic operations on PersistentBag"""
+
+    def test_empty(self):
+        """Test empty bag creation"""
+        b = PersistentBag()
+        assert len(b) == 0
+        assert b.distinct_count() == 0
+        assert b['x'] == 0
+        assert 'x' not in b
+
+    def test_add(self):
+        """Test adding occurrences"""
+        b = PersistentBag().add('a').add('a').add('b')
+        assert len(b) == 3
+        assert b.distinct_count() == 2
+        assert b.count('a') == 2
+        assert b['b'] == 1
+
+    def test_increment(self):
+        """Test adding several occurrences at once"""
+        b = PersistentBag().increment('a', 5).increment('a')
+        assert b['a'] == 6
+        assert len(b) == 6
+        assert b.increment('a', 0) == b
+
+    def test_remove(self):
+        """Test removing occurrences"""
+        b = PersistentBag.from_counts({'a': 3})
+        assert b.remove('a')['a'] == 2
+        assert b.remove('a', 2)['a'] == 1
+        b2 = b.remove('a', 10)
+        assert 'a' not in b2
+        assert len(b2) == 0
+
+    def test_remove_missing(self):
+        """Test removing an absent element is a no-op"""
+        b = PersistentBag().add('a')
+        assert b.remove('z') == b
+
+    def test_remove_all(self):
+        """Test removing every occurrence"""
+        b = PersistentBag.from_counts({'a': 3, 'b': 1})
+        b2 = b.remove_all('a')
+        assert 'a' not in b2
+        assert len(b2) == 1
+
+    def test_immutability(self):
+        """Test that operations don't modify the original"""
+        b = PersistentBag().add('a')
+        b.add('a')
+        b.remove('a')
+        assert b['a'] == 1
+
+    def test_negative_increment_rejected(self):
+        """Test that negative counts are rejected"""
+        with pytest.raises(TypeError):
+            PersistentBag().increment('a', -1)
+
+
+class TestPersistentBagBulk:
+    """Test bulk construction and merge"""
+
+    def test_from_iterable_matches_counter(self):
+        """Test counting an iterable agrees with collections.Counter"""
+        data = [i % 17 for i in range(5000)] + list("abracadabra")
+        b = PersistentBag.from_iterable(data)
+        assert b.dict() == dict(Counter(data))
+        assert len(b) == len(data)
+
+    def test_from_counts_drops_zero(self):
+        """Test that zero counts are not stored"""
+        b = PersistentBag.from_counts({'a': 2, 'b': 0})
+        assert 'b' not in b
+        assert len(b) == 2
+
+    def test_merge_sums_counts(self):
+        """Test merge adds counts together"""
+        a = PersistentBag.from_iterable("aab")
+        b = PersistentBag.from_iterable("abc")
+        m = a.merge(b)
+        assert m.dict() == {'a': 3, 'b': 2, 'c': 1}
+        assert len(m) == 6
+        assert m == a + b
+
+    def test_merge_large(self):
+        """Test structural merge sums every shared count"""
+        words_a = [f"w{i % 3000}" for i in range(9000)]
+        words_b = [f"w{i % 4500}" for i in range(4500)]
+        m = PersistentBag.from_iterable(words_a) + PersistentBag.from_iterable(words_b)
+        assert m.dict() == dict(Counter(words_a) + Counter(words_b))
+        assert len(m) == 13500
+
+    def test_most_common(self):
+        """Test most_common orders by count"""
+        b = PersistentBag.from_iterable("abracadabra")
+        assert b.most_common(1) == [('a', 5)]
+        assert len(b.most_common()) == 5
+        assert [c for _, c in b.most_common()] == [5, 2, 2, 1, 1]
+
+    def test_elements(self):
+        """Test elements repeats each element by its count"""
+        b = PersistentBag.from_counts({'x': 2, 'y': 1})
+        assert sorted(b.elements()) == ['x', 'x', 'y']
+
+
+class TestPersistentBagProtocols:
+    """Test iteration, equality, repr and pickling"""
+
+    def test_iteration(self):
+        """Test iteration yields distinct elements"""
+        b = PersistentBag.from_iterable("aab")
+        assert sorted(b) == ['a', 'b']
+
+    def test_equality(self):
+        """Test equality compares counts"""
+        assert PersistentBag.from_iterable("ab") == PersistentBag.from_iterable("ba")
+        assert PersistentBag.from_iterable("ab") != PersistentBag.from_iterable("abb")
+
+    def test_repr(self):
+        """Test repr shows counts"""
+        assert repr(PersistentBag().increment('a', 2)) == "PersistentBag({'a': 2})"
+
+    def test_pickle(self):
+        """Test pickle round trip"""
+        b = PersistentBag.from_iterable("mississippi")
+        assert pickle.loads(pickle.dumps(b)) == b
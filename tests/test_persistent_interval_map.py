@@ -0,0 +1,151 @@
+"""
+Tests for PersistentIntervalMap - closed intervals [lo, hi] -> value
+
+Tests verify:
+- Basic operations (assoc, dissoc, get, contains)
+- Stabbing and overlap queries, including boundary points
+- Agreement with a brute-force reference under random operations
+- Immutability guarantees
+- Bulk construction (from_items), equality, repr and pickling
+"""
+
+import pickle
+import random
+import pytest
+from pypersistent import PersistentIntervalMap
+
+
+def brute_stabbing(intervals, p):
+    return sorted((lo, hi, v) for (lo, hi), v in intervals.items() if lo <= p <= hi)
+
+
+def brute_overlapping(intervals, qlo, qhi):
+    return sorted((lo, hi, v) for (lo, hi), v in intervals.items() if lo <= qhi and hi >= qlo)
+
+
+class TestPersistentIntervalMapBasics:
+    """Test basic operations on PersistentIntervalMap"""
+
+    def test_empty(self):
+        """Test empty map creation"""
+        m = PersistentIntervalMap()
+        assert len(m) == 0
+        assert m.stabbing(5) == []
+        assert m.overlapping(0, 10) == []
+
+    def test_assoc_get(self):
+        """Test assoc and exact lookup"""
+        m = PersistentIntervalMap().assoc(1, 5, 'a').assoc(3, 8, 'b')
+        assert len(m) == 2
+        assert m.get(1, 5) == 'a'
+        assert m.contains(3, 8)
+        assert m.get(1, 6) is None
+        assert m.get(1, 6, 'x') == 'x'
+
+    def test_assoc_replaces_same_interval(self):
+        """Test that re-associating an interval replaces its value"""
+        m = PersistentIntervalMap().assoc(1, 5, 'a').assoc(1, 5, 'b')
+        assert len(m) == 1
+        assert m.get(1, 5) == 'b'
+
+    def test_invalid_interval(self):
+        """Test that lo > hi is rejected"""
+        with pytest.raises(ValueError):
+            PersistentIntervalMap().assoc(5, 1, 'x')
+
+    def test_dissoc(self):
+        """Test removing an interval"""
+        m = PersistentIntervalMap().assoc(1, 5, 'a').assoc(3, 8, 'b')
+        m2 = m.dissoc(1, 5)
+        assert len(m2) == 1
+        assert not m2.contains(1, 5)
+        assert m2.dissoc(100, 200) == m2
+
+    def test_immutability(self):
+        """Test that operations don't modify the original"""
+        m = PersistentIntervalMap().assoc(1, 5, 'a')
+        m.assoc(2, 3, 'b')
+        m.dissoc(1, 5)
+        assert m.items_list() == [(1, 5, 'a')]
+
+
+class TestPersistentIntervalMapQueries:
+    """Test stabbing and overlap queries"""
+
+    def test_stabbing_closed_bounds(self):
+        """Test that both bounds are inclusive"""
+        m = PersistentIntervalMap().assoc(10, 20, 'x')
+        assert m.stabbing(10) == [(10, 20, 'x')]
+        assert m.stabbing(20) == [(10, 20, 'x')]
+        assert m.stabbing(9) == []
+        assert m.stabbing(21) == []
+
+    def test_stabbing_nested(self):
+        """Test nested and overlapping intervals"""
+        m = PersistentIntervalMap.from_items([
+            (0, 100, 'outer'), (10, 20, 'inner'), (15, 50, 'mid'), (60, 70, 'other'),
+        ])
+        assert m.stabbing(17) == [(0, 100, 'outer'), (10, 20, 'inner'), (15, 50, 'mid')]
+        assert m.stabbing_values(65) == ['outer', 'other']
+
+    def test_overlapping(self):
+        """Test overlap query"""
+        m = PersistentIntervalMap.from_items([(0, 5, 'a'), (10, 15, 'b'), (20, 25, 'c')])
+        assert m.overlapping(5, 10) == [(0, 5, 'a'), (10, 15, 'b')]
+        assert m.overlapping(16, 19) == []
+
+    def test_float_and_large_int_bounds(self):
+        """Test non-int and >64-bit bounds (e.g. IPv6)"""
+        big = 2 ** 100
+        m = PersistentIntervalMap().assoc(0.5, 1.5, 'f').assoc(big, big + 10, 'v6')
+        assert m.stabbing_values(1.0) == ['f']
+        assert m.stabbing_values(big + 3) == ['v6']
+
+    def test_random_against_brute_force(self):
+        """Test queries against a brute-force reference"""
+        rng = random.Random(7)
+        ref = {}
+        m = PersistentIntervalMap()
+        for _ in range(3000):
+            lo = rng.randrange(1000)
+            hi = lo + rng.randrange(50)
+            if rng.random() < 0.3 and ref:
+                key = rng.choice(list(ref))
+                del ref[key]
+                m = m.dissoc(*key)
+            else:
+                ref[(lo, hi)] = rng.random()
+                m = m.assoc(lo, hi, ref[(lo, hi)])
+        assert len(m) == len(ref)
+        for _ in range(200):
+            p = rng.randrange(1100)
+            assert m.stabbing(p) == brute_stabbing(ref, p)
+            q = p + rng.randrange(30)
+            assert m.overlapping(p, q) == brute_overlapping(ref, p, q)
+
+
+class TestPersistentIntervalMapFactories:
+    """Test bulk construction, equality and pickling"""
+
+    def test_from_items_matches_incremental(self):
+        """Test bulk and incremental construction agree"""
+        items = [(i, i + (i % 7), str(i)) for i in range(2000)]
+        m = PersistentIntervalMap()
+        for lo, hi, v in reversed(items):
+            m = m.assoc(lo, hi, v)
+        assert PersistentIntervalMap.from_items(items) == m
+
+    def test_from_items_duplicates_last_wins(self):
+        """Test duplicate intervals keep the last value"""
+        m = PersistentIntervalMap.from_items([(1, 2, 'a'), (1, 2, 'b')])
+        assert len(m) == 1
+        assert m.get(1, 2) == 'b'
+
+    def test_repr(self):
+        """Test repr"""
+        assert repr(PersistentIntervalMap().assoc(1, 2, 'a')) == "PersistentIntervalMap({[1, 2]: 'a'})"
+
+    def test_pickle(self):
+        """Test pickle round trip"""
+        m = PersistentIntervalMap.from_items([(1, 5, 'a'), (2, 9, 'b')])
+        assert pickle.loads(pickle.dumps(m)) == m
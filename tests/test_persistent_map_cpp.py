@@ -1,7 +1,9 @@
 """Unit tests for PersistentDict C++ implementation."""
 
 import pytest
-from pypersistent import PersistentDict
+from pypersistent import BUILD_CONFIG, PersistentDict
+
+NODE_WIDTH = 2 ** BUILD_CONFIG['hamt_bits']
 
 
 class TestPersistentDictBasics:
@@ -363,6 +365,356 @@ class TestPersistentDictEdgeCases:
         assert sorted_items[0] == (0, 0)
         assert sorted_items[-1] == (14999, 14999)
 
+    def test_large_merge_keeps_clashing_slots(self):
+        """
+        Regression test for data loss in structural merge.
+
+        The bug: when both trees held different keys in the same slot (two
+        entries, or an entry on one side and a subtree on the other), the
+        right side silently replaced the left.
+        """
+        d1 = {f"left-{i}": i for i in range(3000)}
+        d2 = {f"right-{i}": -i for i in range(3000)}
+        merged = PersistentDict.from_dict(d1) | PersistentDict.from_dict(d2)
+
+        expected = d1 | d2
+        assert len(merged) == len(expected)
+        assert dict(merged.items_list()) == expected
+
+
+class CollidingKey:
+    """Key whose instances all share one hash but compare by value."""
+
+    def __init__(self, value):
+        self.value = value
+
+    def __hash__(self):
+        return 42
+
+    def __eq__(self, other):
+        return isinstance(other, CollidingKey) and self.value == other.value
+
+    def __repr__(self):
+        return f"CollidingKey({self.value!r})"
+
+
+class TestPersistentDictHashCollisions:
+    """Test keys with identical hashes (collision nodes)."""
+
+    # Python ints hash modulo this prime, so i and i + k * MODULUS collide
+    MODULUS = 2**61 - 1
+
+    def test_colliding_keys_round_trip(self):
+        """Test assoc/get/dissoc for keys sharing one hash."""
+        keys = [CollidingKey(i) for i in range(20)]
+        m = PersistentDict()
+        for i, k in enumerate(keys):
+            m = m.assoc(k, i)
+
+        assert len(m) == 20
+        for i, k in enumerate(keys):
+            assert m[CollidingKey(i)] == i
+        assert CollidingKey(99) not in m
+
+        m2 = m.assoc(CollidingKey(3), 'three')
+        assert m2[keys[3]] == 'three'
+        assert m[keys[3]] == 3  # Original unchanged
+
+    def test_dissoc_down_to_one_entry(self):
+        """
+        Regression test: removing from a two-entry collision bucket dropped
+        the remaining key as well.
+        """
+        m = PersistentDict().assoc(-1, 'a').assoc(-2, 'b')  # hash(-1) == hash(-2)
+        m2 = m.dissoc(-1)
+        assert len(m2) == 1
+        assert m2[-2] == 'b'
+        assert -1 not in m2
+        assert m2.dissoc(-2) == PersistentDict()
+
+    def test_large_int_collision_bucket(self):
+        """Test a bucket large enough to be kept sorted."""
+        keys = [7 + k * self.MODULUS for k in range(200)]
+        assert len({hash(k) for k in keys}) == 1
+
+        m = PersistentDict()
+        for k in reversed(keys):
+            m = m.assoc(k, str(k))
+        assert len(m) == 200
+        for k in keys:
+            assert m[k] == str(k)
+        assert 7 + 500 * self.MODULUS not in m
+
+        for k in keys[::2]:
+            m = m.dissoc(k)
+        assert len(m) == 100
+        assert sorted(m.keys()) == keys[1::2]
+
+    def test_equal_keys_of_other_type_found_in_sorted_bucket(self):
+        """Test that 1.0 still finds the int key 1 in a sorted bucket."""
+        keys = [1 + k * self.MODULUS for k in range(16)]
+        m = PersistentDict.from_dict({k: k for k in keys})
+        assert m[1.0] == 1
+        assert m[True] == 1
+        m2 = m.assoc(1.0, 'float')
+        assert len(m2) == 16
+        assert m2[1] == 'float'
+
+    def test_mixed_type_bucket(self):
+        """Test a bucket mixing float and int keys with the same hash."""
+        # hash(0.5) == 2**60, but 0.5 equals none of the ints
+        keys = [2**60 + k * self.MODULUS for k in range(12)]
+        m = PersistentDict.from_dict({k: k for k in keys}).assoc(0.5, 'half')
+        assert len(m) == 13
+        assert m[0.5] == 'half'
+        for k in keys:
+            assert m[k] == k
+        m2 = m.dissoc(keys[0])
+        assert len(m2) == 12
+        assert m2[0.5] == 'half'
+
+    def test_from_dict_and_merge_with_collisions(self):
+        """Test bulk construction and merge of colliding keys."""
+        left = {CollidingKey(i): i for i in range(10)}
+        right = {CollidingKey(i): -i for i in range(5, 15)}
+        merged = PersistentDict.from_dict(left) | PersistentDict.from_dict(right)
+        assert dict(merged.items_list()) == left | right
+
+
+class TestPersistentDictTrieStats:
+    """Test trie_stats() introspection."""
+
+    def test_empty_map(self):
+        """Test stats of an empty map."""
+        stats = PersistentDict().trie_stats()
+        assert stats['entries'] == 0
+        assert stats['depth'] == 0
+        assert stats['bitmap_nodes'] == 0
+        assert stats['level_nodes'] == []
+
+    def test_counts_are_consistent(self):
+        """Test that per-level counts add up for a mixed workload."""
+        m = PersistentDict.from_dict({i: i for i in range(5000)})
+        m = m.assoc(-1, 'a').assoc(-2, 'b')  # hash(-1) == hash(-2)
+        stats = m.trie_stats()
+
+        assert stats['entries'] == 5002
+        assert sum(stats['level_entries']) == 5002
+        assert sum(stats['level_nodes']) == stats['bitmap_nodes'] + stats['collision_nodes']
+        assert stats['depth'] == len(stats['level_nodes'])
+        assert stats['collision_nodes'] == 1
+        assert stats['max_collision_bucket'] == 2
+        assert 1.0 <= stats['avg_fanout'] <= NODE_WIDTH
+
+    def test_sequential_ints_stay_shallow(self):
+        """Test that mixed hashes keep sequential int keys well spread."""
+        stats = PersistentDict.from_dict({i: i for i in range(100000)}).trie_stats()
+        # 32-way trie over 100K random-looking hashes: ~log32(100K) + slack
+        assert stats['depth'] <= 8
+        assert stats['collision_nodes'] == 0
+
+    def test_node_width(self):
+        """Test levels never hold more nodes than the compiled width allows."""
+        assert BUILD_CONFIG['hamt_bits'] in (4, 5, 6)
+        stats = PersistentDict.from_dict({i: i for i in range(20000)}).trie_stats()
+        for level, nodes in enumerate(stats['level_nodes']):
+            assert nodes <= NODE_WIDTH ** level
+        # 20K well-mixed hashes occupy every root slot
+        assert stats['level_nodes'][1] + stats['level_entries'][0] == NODE_WIDTH
+
+
+class TestPersistentDictBulkTransforms:
+    """Test shape-preserving map_values() and filter()."""
+
+    def test_map_values(self):
+        """Test every value is transformed and keys are kept."""
+        m = PersistentDict.from_dict({i: i for i in range(5000)})
+        doubled = m.map_values(lambda v: v * 2)
+        assert len(doubled) == 5000
+        assert all(doubled[i] == 2 * i for i in range(5000))
+        assert m[10] == 10  # Original unchanged
+        assert doubled.trie_stats()['level_nodes'] == m.trie_stats()['level_nodes']
+
+    def test_map_values_identity_reuses_map(self):
+        """Test returning the same objects gives back the same map."""
+        m = PersistentDict.from_dict({str(i): [i] for i in range(1000)})
+        assert m.map_values(lambda v: v) is m
+
+    def test_map_values_collision_bucket(self):
+        """Test values inside a sorted collision bucket."""
+        modulus = 2**61 - 1
+        m = PersistentDict.from_dict({7 + k * modulus: k for k in range(20)})
+        m2 = m.map_values(lambda v: -v)
+        assert m2[7 + 5 * modulus] == -5
+        assert m2.trie_stats()['collision_nodes'] == 1
+
+    def test_filter(self):
+        """Test filtering by value and by item."""
+        m = PersistentDict.from_dict({i: i for i in range(5000)})
+        even = m.filter(lambda v: v % 2 == 0)
+        assert len(even) == 2500
+        assert 4 in even and 5 not in even
+        assert dict(even.items()) == {i: i for i in range(0, 5000, 2)}
+
+        small_keys = m.filter_items(lambda k, v: k < 10)
+        assert sorted(small_keys.keys()) == list(range(10))
+        assert len(m) == 5000
+
+    def test_filter_keep_all_and_none(self):
+        """Test the all-kept and all-removed edge cases."""
+        m = PersistentDict.from_dict({i: i for i in range(100)})
+        assert m.filter(lambda v: True) is m
+        empty = m.filter(lambda v: False)
+        assert len(empty) == 0
+        assert empty.assoc(1, 1)[1] == 1
+
+    def test_filter_compacts(self):
+        """Test subtrees reduced to one entry are lifted into their parent."""
+        m = PersistentDict.from_dict({i: i for i in range(100000)})
+        one = m.filter(lambda v: v == 777)
+        assert len(one) == 1
+        assert one[777] == 777
+        assert one.trie_stats()['depth'] == 1
+        # The compacted map keeps working for updates at any depth
+        grown = one.update({i: i for i in range(1000)})
+        assert len(grown) == 1000 and grown[777] == 777
+
+    def test_filter_collision_bucket(self):
+        """Test filtering a collision bucket down to one entry."""
+        m = PersistentDict().assoc(-1, 'a').assoc(-2, 'b').assoc(3, 'c')
+        f = m.filter_items(lambda k, v: k != -1)
+        assert len(f) == 2
+        assert f[-2] == 'b' and -1 not in f
+        assert f.trie_stats()['collision_nodes'] == 0
+        assert f.assoc(-1, 'again')[-1] == 'again'
+
+    def test_exception_propagates(self):
+        """Test an exception in the callback leaves the map intact."""
+        m = PersistentDict.from_dict({i: i for i in range(2000)})
+
+        def boom(v):
+            if v == 1500:
+                raise RuntimeError('boom')
+            return v + 1
+
+        with pytest.raises(RuntimeError):
+            m.map_values(boom)
+        with pytest.raises(RuntimeError):
+            m.filter(boom)
+        assert len(m) == 2000 and m[1500] == 1500
+
+
+class TestPersistentDictAggregation:
+    """Test the group_by() and frequencies() builders."""
+
+    def test_group_by(self):
+        """Test items are grouped in iteration order."""
+        words = ['the', 'quick', 'brown', 'fox', 'jumps', 'over', 'a', 'dog']
+        groups = PersistentDict.group_by(words, len)
+        assert set(groups.keys()) == {1, 3, 4, 5}
+        assert list(groups[3]) == ['the', 'fox', 'dog']
+        assert list(groups[5]) == ['quick', 'brown', 'jumps']
+        assert type(groups[1]).__name__ == 'PersistentList'
+
+    def test_group_by_large(self):
+        """Test many groups and large groups match a dict-of-lists."""
+        items = list(range(100000))
+        groups = PersistentDict.group_by(items, lambda x: x % 3000)
+        assert len(groups) == 3000
+        assert list(groups[7]) == list(range(7, 100000, 3000))
+        assert sum(len(v) for v in groups.values()) == 100000
+
+    def test_equal_keys_merge(self):
+        """Test keys equal under == share a group (1, 1.0 and True)."""
+        groups = PersistentDict.group_by(['a', 'b', 'c'], lambda s: {'a': 1, 'b': 1.0, 'c': True}[s])
+        assert len(groups) == 1
+        assert list(groups[1]) == ['a', 'b', 'c']
+
+    def test_frequencies(self):
+        """Test counts match collections.Counter."""
+        from collections import Counter
+        items = [i % 97 for i in range(20000)] + ['x', 'y', 'x']
+        assert dict(PersistentDict.frequencies(items).items()) == dict(Counter(items))
+        assert len(PersistentDict.frequencies(iter([]))) == 0
+
+    def test_colliding_keys(self):
+        """Test distinct keys with equal hashes stay separate."""
+        keys = [CollidingKey(i) for i in range(5)]
+        freq = PersistentDict.frequencies(keys + keys[:2])
+        assert len(freq) == 5
+        assert freq[keys[0]] == 2 and freq[keys[4]] == 1
+
+    def test_errors_propagate(self):
+        """Test unhashable keys and keyfn errors propagate."""
+        with pytest.raises(TypeError):
+            PersistentDict.frequencies([[1]])
+        with pytest.raises(ZeroDivisionError):
+            PersistentDict.group_by([0], lambda x: 1 / x)
+
+
+class TestPersistentDictSplit:
+    """Test split() and partition_sizes() on PersistentDict."""
+
+    def test_parts_cover_map(self):
+        """Test the parts are disjoint and their union is the map."""
+        m = PersistentDict.from_dict({i: str(i) for i in range(50000)})
+        for k in (1, 2, 3, 7, 64, 200):
+            parts = m.split(k)
+            assert len(parts) == k
+            merged = {}
+            for part in parts:
+                assert not merged.keys() & set(part.keys())
+                merged.update(part.items())
+            assert merged == {i: str(i) for i in range(50000)}
+
+    def test_balanced(self):
+        """Test parts are within a modest factor of an even share."""
+        m = PersistentDict.from_dict({i: i for i in range(100000)})
+        sizes = [len(p) for p in m.split(8)]
+        assert min(sizes) > 0.75 * 100000 / 8
+        assert max(sizes) < 1.25 * 100000 / 8
+
+    def test_partition_sizes_match(self):
+        """Test partition_sizes() previews split() exactly."""
+        m = PersistentDict.from_dict({i: i for i in range(10000)})
+        for k in (1, 5, 40):
+            assert m.partition_sizes(k) == [len(p) for p in m.split(k)]
+
+    def test_parts_are_usable(self):
+        """Test parts support lookups and updates at any depth."""
+        m = PersistentDict.from_dict({f'k{i}': i for i in range(20000)})
+        part = m.split(16)[3]
+        key = next(iter(part.keys()))
+        assert part[key] == m[key]
+        grown = part.assoc('new', 1).dissoc(key)
+        assert grown['new'] == 1 and key not in grown
+        assert key in part
+
+    def test_parts_pickle_independently(self):
+        """Test each part round-trips through pickle on its own."""
+        import pickle
+        m = PersistentDict.from_dict({i: i * 2 for i in range(5000)})
+        for part in m.split(4):
+            restored = pickle.loads(pickle.dumps(part))
+            assert restored == part
+
+    def test_small_and_empty(self):
+        """Test small maps yield empty parts and k=0 is rejected."""
+        assert [len(p) for p in PersistentDict().split(3)] == [0, 0, 0]
+        m = PersistentDict.from_dict({'a': 1, 'b': 2})
+        parts = m.split(5)
+        assert sum(len(p) for p in parts) == 2
+        assert m.split(1) == [m]
+        with pytest.raises(ValueError):
+            m.split(0)
+
+    def test_collision_bucket_kept_whole(self):
+        """Test a collision bucket lands in a single part."""
+        m = PersistentDict().assoc(-1, 'a').assoc(-2, 'b')
+        m = m.update({i: i for i in range(100)})
+        parts = [p for p in m.split(8) if -1 in p or -2 in p]
+        assert len(parts) == 1
+
 
 class TestPersistentDictPickle:
     """Test pickle serialization for PersistentDict."""
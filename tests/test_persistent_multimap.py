@@ -0,0 +1,162 @@
+"""
+Tests for PersistentMultiMap - key to set of values
+
+Tests verify:
+- Basic operations (add, remove, remove_all, get, contains, count)
+- Size accounting (pairs vs. distinct keys)
+- Immutability guarantees
+- Bulk construction (from_pairs, from_dict)
+- Merge (union of values per key), including large structural merges
+- Equality, repr and pickling
+"""
+
+import pickle
+import pytest
+from pypersistent import PersistentMultiMap, PersistentSet
+
+
+class TestPersistentMultiMapBasics:
+    """Test basic operations on PersistentMultiMap"""
+
+    def test_empty(self):
+        """Test empty multimap creation"""
+        mm = PersistentMultiMap()
+        assert len(mm) == 0
+        assert mm.key_count() == 0
+        assert 'k' not in mm
+        assert mm.get('k') == PersistentSet()
+
+    def test_add(self):
+        """Test adding values under one key"""
+        mm = PersistentMultiMap().add('a', 1).add('a', 2).add('b', 1)
+        assert len(mm) == 3
+        assert mm.key_count() == 2
+        assert mm['a'] == PersistentSet.create(1, 2)
+        assert mm.count('a') == 2
+        assert mm.contains('b', 1)
+        assert not mm.contains('b', 2)
+
+    def test_add_duplicate_returns_same_size(self):
+        """Test that adding an existing pair is a no-op"""
+        mm = PersistentMultiMap().add('a', 1)
+        mm2 = mm.add('a', 1)
+        assert len(mm2) == 1
+        assert mm2 == mm
+
+    def test_remove(self):
+        """Test removing a single value"""
+        mm = PersistentMultiMap().add('a', 1).add('a', 2)
+        mm2 = mm.remove('a', 1)
+        assert len(mm2) == 1
+        assert mm2['a'] == PersistentSet.create(2)
+
+    def test_remove_last_value_drops_key(self):
+        """Test that removing the last value removes the key"""
+        mm = PersistentMultiMap().add('a', 1)
+        mm2 = mm.remove('a', 1)
+        assert len(mm2) == 0
+        assert 'a' not in mm2
+        with pytest.raises(KeyError):
+            mm2['a']
+
+    def test_remove_missing(self):
+        """Test removing absent pairs leaves the multimap unchanged"""
+        mm = PersistentMultiMap().add('a', 1)
+        assert mm.remove('a', 2) == mm
+        assert mm.remove('b', 1) == mm
+
+    def test_remove_all(self):
+        """Test removing a key with all its values"""
+        mm = PersistentMultiMap().add('a', 1).add('a', 2).add('b', 3)
+        mm2 = mm.remove_all('a')
+        assert len(mm2) == 1
+        assert 'a' not in mm2
+        assert mm2.remove_all('missing') == mm2
+
+    def test_immutability(self):
+        """Test that operations don't modify the original"""
+        mm = PersistentMultiMap().add('a', 1)
+        mm.add('a', 2)
+        mm.remove('a', 1)
+        assert len(mm) == 1
+        assert mm['a'] == PersistentSet.create(1)
+
+
+class TestPersistentMultiMapBulk:
+    """Test bulk construction and merge"""
+
+    def test_from_pairs(self):
+        """Test building from (key, value) pairs with duplicates"""
+        mm = PersistentMultiMap.from_pairs([('a', 1), ('b', 2), ('a', 1), ('a', 3)])
+        assert len(mm) == 3
+        assert mm['a'] == PersistentSet.create(1, 3)
+        assert mm['b'] == PersistentSet.create(2)
+
+    def test_from_pairs_accepts_lists(self):
+        """Test that pairs may be any 2-sequence"""
+        mm = PersistentMultiMap.from_pairs([['a', 1], ['a', 2]])
+        assert mm.count('a') == 2
+
+    def test_from_pairs_large(self):
+        """Test bulk path (>= 1000 keys and values per key)"""
+        pairs = [(i % 1500, i) for i in range(3000)]
+        pairs += [('hot', i) for i in range(2000)]
+        mm = PersistentMultiMap.from_pairs(pairs)
+        assert len(mm) == 5000
+        assert mm.key_count() == 1501
+        assert mm[7] == PersistentSet.create(7, 1507)
+        assert mm.count('hot') == 2000
+
+    def test_from_dict(self):
+        """Test building from a dict of iterables"""
+        mm = PersistentMultiMap.from_dict({'a': [1, 2, 2], 'b': (3,), 'c': []})
+        assert len(mm) == 3
+        assert 'c' not in mm
+
+    def test_matches_incremental(self):
+        """Test that bulk and incremental construction agree"""
+        pairs = [(i % 37, i % 11) for i in range(2000)]
+        mm = PersistentMultiMap()
+        for k, v in pairs:
+            mm = mm.add(k, v)
+        assert PersistentMultiMap.from_pairs(pairs) == mm
+
+    def test_merge(self):
+        """Test merge takes the union of values per key"""
+        a = PersistentMultiMap.from_pairs([('x', 1), ('x', 2), ('y', 1)])
+        b = PersistentMultiMap.from_pairs([('x', 2), ('x', 3), ('z', 1)])
+        m = a.merge(b)
+        assert len(m) == 5
+        assert m['x'] == PersistentSet.create(1, 2, 3)
+        assert m == (a | b)
+
+    def test_merge_large(self):
+        """Test structural merge keeps every pair"""
+        a = PersistentMultiMap.from_pairs((i, i) for i in range(5000))
+        b = PersistentMultiMap.from_pairs((i, -i) for i in range(2500, 7500))
+        m = a.merge(b)
+        assert m.key_count() == 7500
+        assert len(m) == 10000
+        assert m[3000] == PersistentSet.create(3000, -3000)
+        assert m[10] == PersistentSet.create(10)
+        assert m[7000] == PersistentSet.create(-7000)
+
+
+class TestPersistentMultiMapProtocols:
+    """Test iteration, equality, repr and pickling"""
+
+    def test_iteration(self):
+        """Test iteration yields distinct keys"""
+        mm = PersistentMultiMap.from_pairs([('a', 1), ('a', 2), ('b', 1)])
+        assert sorted(mm) == ['a', 'b']
+        assert sorted(mm.pairs_list()) == [('a', 1), ('a', 2), ('b', 1)]
+
+    def test_repr(self):
+        """Test repr shows keys and value sets"""
+        mm = PersistentMultiMap().add('a', 1)
+        assert repr(mm) == "PersistentMultiMap({'a': {1}})"
+
+    def test_pickle(self):
+        """Test pickle round trip"""
+        mm = PersistentMultiMap.from_pairs([('a', 1), ('a', 2), ('b', 3)])
+        assert pickle.loads(pickle.dumps(mm)) == mm
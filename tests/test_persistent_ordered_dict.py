@@ -0,0 +1,169 @@
+"""
+Tests for PersistentOrderedDict - Insertion-ordered persistent map
+
+Tests verify:
+- Basic operations (assoc, dissoc, get, contains)
+- Insertion order through updates, deletes and re-inserts
+- Tombstone compaction after many deletes
+- Immutability guarantees
+- Factory methods (from_dict, from_items, create)
+- Order-sensitive equality, repr and pickling
+"""
+
+import pickle
+import pytest
+from pypersistent import PersistentOrderedDict
+
+
+class TestPersistentOrderedDictBasics:
+    """Test basic operations on PersistentOrderedDict"""
+
+    def test_empty(self):
+        """Test empty map creation"""
+        m = PersistentOrderedDict()
+        assert len(m) == 0
+        assert 'a' not in m
+        assert m.get('a') is None
+
+    def test_assoc_and_get(self):
+        """Test assoc and lookup"""
+        m = PersistentOrderedDict().assoc('a', 1).assoc('b', 2)
+        assert len(m) == 2
+        assert m['a'] == 1
+        assert m.get('b') == 2
+        assert m.get('c', 'default') == 'default'
+        with pytest.raises(KeyError):
+            m['c']
+
+    def test_dissoc(self):
+        """Test removing a key"""
+        m = PersistentOrderedDict.create(a=1, b=2, c=3)
+        m2 = m.dissoc('b')
+        assert len(m2) == 2
+        assert 'b' not in m2
+        assert m2.keys_list() == ['a', 'c']
+        assert m.dissoc('missing') == m
+
+    def test_immutability(self):
+        """Test that operations don't modify the original"""
+        m = PersistentOrderedDict.create(a=1)
+        m.assoc('b', 2)
+        m.dissoc('a')
+        assert m.items_list() == [('a', 1)]
+
+
+class TestPersistentOrderedDictOrder:
+    """Test that insertion order is preserved"""
+
+    def test_insertion_order(self):
+        """Test iteration follows insertion, not hash, order"""
+        keys = [f"key{i}" for i in range(200)][::-1]
+        m = PersistentOrderedDict()
+        for i, k in enumerate(keys):
+            m = m.assoc(k, i)
+        assert list(m) == keys
+        assert m.values_list() == list(range(200))
+
+    def test_update_keeps_position(self):
+        """Test that updating an existing key keeps its position"""
+        m = PersistentOrderedDict.create(a=1, b=2, c=3).assoc('a', 10)
+        assert m.items_list() == [('a', 10), ('b', 2), ('c', 3)]
+
+    def test_reinsert_moves_to_end(self):
+        """Test that delete + assoc moves the key to the end"""
+        m = PersistentOrderedDict.create(a=1, b=2, c=3).dissoc('a').assoc('a', 1)
+        assert m.keys_list() == ['b', 'c', 'a']
+
+    def test_first_last(self):
+        """Test first/last skip deleted entries"""
+        m = PersistentOrderedDict.create(a=1, b=2, c=3).dissoc('a').dissoc('c')
+        assert m.first() == ('b', 2)
+        assert m.last() == ('b', 2)
+        with pytest.raises(RuntimeError):
+            PersistentOrderedDict().first()
+
+    def test_iterators(self):
+        """Test keys/values/items iterators"""
+        m = PersistentOrderedDict.from_items([('x', 1), ('y', 2)]).dissoc('x').assoc('z', 3)
+        assert list(m.keys()) == ['y', 'z']
+        assert list(m.values()) == [2, 3]
+        assert list(m.items()) == [('y', 2), ('z', 3)]
+
+    def test_matches_dict_under_random_ops(self):
+        """Test against dict as a reference under mixed operations"""
+        import random
+        rng = random.Random(42)
+        ref = {}
+        m = PersistentOrderedDict()
+        for _ in range(5000):
+            k = rng.randrange(300)
+            if rng.random() < 0.4:
+                ref.pop(k, None)
+                m = m.dissoc(k)
+            else:
+                v = rng.random()
+                ref[k] = v
+                m = m.assoc(k, v)
+            assert len(m) == len(ref)
+        assert m.items_list() == list(ref.items())
+
+
+class TestPersistentOrderedDictCompaction:
+    """Test tombstone compaction"""
+
+    def test_compaction_preserves_order(self):
+        """Test that deleting most entries keeps the survivors in order"""
+        m = PersistentOrderedDict.from_dict({i: str(i) for i in range(1000)})
+        for i in range(0, 1000):
+            if i % 10:
+                m = m.dissoc(i)
+        assert m.keys_list() == list(range(0, 1000, 10))
+        assert m[500] == '500'
+        assert m.assoc(5, 'x').keys_list()[-1] == 5
+
+
+class TestPersistentOrderedDictFactories:
+    """Test factory methods, equality and pickling"""
+
+    def test_from_dict(self):
+        """Test from_dict keeps dict order"""
+        d = {'z': 1, 'a': 2, 'm': 3}
+        assert PersistentOrderedDict.from_dict(d).items_list() == list(d.items())
+
+    def test_from_dict_large(self):
+        """Test from_dict on the bulk path"""
+        d = {f"k{i}": i for i in range(5000)}
+        m = PersistentOrderedDict.from_dict(d)
+        assert len(m) == 5000
+        assert m.keys_list() == list(d)
+        assert m['k4321'] == 4321
+
+    def test_from_items_duplicates(self):
+        """Test duplicates keep first position and last value"""
+        m = PersistentOrderedDict.from_items([('a', 1), ('b', 2), ('a', 3)])
+        assert m.items_list() == [('a', 3), ('b', 2)]
+
+    def test_equality_is_order_sensitive(self):
+        """Test that equality compares order"""
+        a = PersistentOrderedDict.from_items([('a', 1), ('b', 2)])
+        b = PersistentOrderedDict.from_items([('b', 2), ('a', 1)])
+        assert a != b
+        assert a == PersistentOrderedDict.create(a=1, b=2)
+
+    def test_update(self):
+        """Test update appends new keys in order"""
+        m = PersistentOrderedDict.create(a=1).update({'b': 2, 'a': 5})
+        assert m.items_list() == [('a', 5), ('b', 2)]
+        assert (PersistentOrderedDict.create(a=1) | {'c': 3}).keys_list() == ['a', 'c']
+
+    def test_repr(self):
+        """Test repr shows entries in order"""
+        m = PersistentOrderedDict.from_items([('b', 1), ('a', 2)])
+        assert repr(m) == "PersistentOrderedDict({'b': 1, 'a': 2})"
+
+    def test_pickle(self):
+        """Test pickle round trip keeps order"""
+        m = PersistentOrderedDict.from_items([(3, 'c'), (1, 'a'), (2, 'b')]).dissoc(1)
+        m2 = pickle.loads(pickle.dumps(m))
+        assert m2 == m
+        assert m2.keys_list() == [3, 2]
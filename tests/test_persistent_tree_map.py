@@ -4,7 +4,7 @@ Tests for PersistentSortedDict - Immutable sorted map using red-black tree
 Tests verify:
 - Basic operations (assoc, dissoc, get, contains)
 - Ordering (iteration, first, last)
-- Range queries (subseq, rsubseq)
+- Range queries (subseq, rsubseq, range views)
 - Immutability guarantees
 - Factory methods
 - Equality comparison
@@ -193,6 +193,97 @@ class TestPersistentSortedDictRangeQueries:
         assert keys == ["banana", "cherry"]
 
 
+class TestPersistentSortedDictRangeView:
+    """Test lazy range views from slices and range()"""
+
+    @staticmethod
+    def build(n, step=2):
+        """Map with keys 0, step, 2*step, ... built by repeated assoc and dissoc"""
+        m = PersistentSortedDict()
+        for i in range(n):
+            m = m.assoc(i * step, str(i * step))
+        # Deletions must keep subtree sizes right too
+        for k in range(0, n * step, 7 * step):
+            m = m.dissoc(k)
+        return m
+
+    @staticmethod
+    def expected(keys, lo, hi, lo_inc=True, hi_inc=False):
+        """Keys within the bounds, None meaning open"""
+        return [k for k in keys
+                if (lo is None or k > lo or (lo_inc and k == lo))
+                and (hi is None or k < hi or (hi_inc and k == hi))]
+
+    def test_open_ended_slices(self):
+        """Test m[a:], m[:b] and m[:] against plain filtering"""
+        m = self.build(200)
+        keys = list(m.keys())
+        assert list(m[100:]) == self.expected(keys, 100, None)
+        assert list(m[:101]) == self.expected(keys, None, 101)
+        assert list(m[:]) == keys
+        assert list(m[13:57]) == self.expected(keys, 13, 57)
+
+    @pytest.mark.parametrize('lo_inc', [True, False])
+    @pytest.mark.parametrize('hi_inc', [True, False])
+    def test_bounds_and_len(self, lo_inc, hi_inc):
+        """Test len, iteration, first and last for every bound combination"""
+        m = self.build(300)
+        keys = list(m.keys())
+        for lo, hi in [(None, None), (0, 598), (2, 2), (-5, 1000), (101, 301),
+                       (300, 100), (None, 50), (250, None), (4, 6)]:
+            r = m.range(lo, hi, inclusive=(lo_inc, hi_inc))
+            want = self.expected(keys, lo, hi, lo_inc, hi_inc)
+            assert len(r) == len(want)
+            assert list(r) == want
+            if want:
+                assert r.first() == [want[0], str(want[0])]
+                assert r.last() == [want[-1], str(want[-1])]
+            else:
+                with pytest.raises(RuntimeError):
+                    r.first()
+                with pytest.raises(RuntimeError):
+                    r.last()
+
+    def test_keys_values_items_contains(self):
+        """Test the view's iteration methods and membership"""
+        m = PersistentSortedDict.from_dict({i: i * 10 for i in range(10)})
+        r = m.range(2, 5, inclusive=(False, True))
+        assert list(r.keys()) == [3, 4, 5]
+        assert list(r.values()) == [30, 40, 50]
+        assert list(r.items()) == [[3, 30], [4, 40], [5, 50]]
+        assert 3 in r
+        assert 2 not in r
+        assert 9 not in r
+
+    def test_to_sorted_dict(self):
+        """Test materializing a range builds an ordinary sorted dict"""
+        m = self.build(500)
+        for lo, hi in [(10, 800), (None, 3), (991, None), (5, 5)]:
+            sub = m[lo:hi].to_sorted_dict()
+            want = self.expected(list(m.keys()), lo, hi)
+            assert list(sub.keys()) == want
+            assert len(sub) == len(want)
+            # The built tree supports further updates and range queries
+            sub2 = sub.assoc(-1, 'x').dissoc(want[0]) if want else sub
+            assert list(sub2.keys()) == sorted(sub2.keys())
+            assert len(sub2[:]) == len(sub2)
+        assert m[:].to_sorted_dict() == m
+
+    def test_view_outlives_map(self):
+        """Test the view and its iterator keep the tree alive"""
+        r = PersistentSortedDict.from_dict({i: i for i in range(100)})[10:20]
+        it = iter(r)
+        assert next(it) == 10
+        assert list(it) == list(range(11, 20))
+        assert len(r) == 10
+
+    def test_step_rejected(self):
+        """Test slices with a step are rejected"""
+        m = PersistentSortedDict.from_dict({1: 1})
+        with pytest.raises(ValueError):
+            m[0:5:2]
+
+
 class TestPersistentSortedDictImmutability:
     """Test that PersistentSortedDict is truly immutable"""
 
@@ -430,6 +430,247 @@ class TestPersistentListSpecialCases:
         assert v2.list() == [1, 2, 3, 4, 5]
 
 
+class TestPersistentListStridedAccess:
+    """Test strided/reversed slicing, take() and reversed()."""
+
+    @pytest.mark.parametrize('n', [0, 1, 31, 33, 1025, 40000])
+    @pytest.mark.parametrize('sl', [
+        slice(None, None, 2), slice(None, None, -1), slice(5, None, 7),
+        slice(None, 3, -3), slice(-10, -1, 4), slice(100, 10, -33), slice(2, 2, 5),
+    ])
+    def test_matches_list(self, n, sl):
+        """Test every slice form matches the equivalent list slice."""
+        data = list(range(n))
+        v = PersistentList.from_list(data)
+        assert list(v[sl]) == data[sl]
+
+    def test_zero_step_rejected(self):
+        """Test a zero step raises ValueError like list."""
+        with pytest.raises(ValueError):
+            PersistentList.from_list([1, 2])[::0]
+
+    def test_full_slice_shares(self):
+        """Test a full forward slice returns an equal list."""
+        v = PersistentList.from_list(list(range(100)))
+        assert v[:] == v
+
+    def test_take(self):
+        """Test gathering arbitrary, repeated and negative indices."""
+        data = list(range(5000))
+        v = PersistentList.from_list(data)
+        idx = [4999, 0, -1, 17, 17, 2048, 31, 32]
+        assert list(v.take(idx)) == [data[i] for i in idx]
+        assert list(v.take(range(0, 5000, 3))) == data[::3]
+        assert list(v.take(i for i in (1, 2))) == [1, 2]
+        assert len(v.take([])) == 0
+
+    def test_take_errors(self):
+        """Test out-of-range and non-int indices raise."""
+        v = PersistentList.from_list([1, 2, 3])
+        with pytest.raises(IndexError):
+            v.take([0, 3])
+        with pytest.raises(IndexError):
+            v.take([2**80])
+        with pytest.raises(TypeError):
+            v.take([0, 'a'])
+
+    @pytest.mark.parametrize('n', [0, 1, 32, 33, 1057])
+    def test_reversed(self, n):
+        """Test reversed() walks back through tail and tree."""
+        v = PersistentList.from_list(list(range(n)))
+        assert list(reversed(v)) == list(range(n - 1, -1, -1))
+
+    def test_reversed_outlives_list(self):
+        """Test the reverse iterator keeps the list alive."""
+        it = reversed(PersistentList.from_list(list(range(100))))
+        assert next(it) == 99
+        assert sum(it) == sum(range(99))
+
+
+class TestPersistentListCursor:
+    """Test batched in-place edits through ListCursor."""
+
+    @pytest.mark.parametrize('n', [0, 5, 32, 33, 1100, 40000])
+    def test_random_edits(self, n):
+        """Test random edits match a plain list and leave the source intact."""
+        import random
+        rng = random.Random(n)
+        data = list(range(n))
+        v = PersistentList.from_list(data)
+        c = v.cursor()
+        expected = list(data)
+        for _ in range(min(n, 500) * 3):
+            i = rng.randrange(n)
+            expected[i] = -i
+            c[i] = -i
+            assert c[i] == -i
+        assert len(c) == n
+        assert list(c.commit()) == expected
+        assert list(v) == data
+
+    def test_window_patch(self):
+        """Test patching a window across leaf boundaries and the tail."""
+        data = list(range(2000))
+        v = PersistentList.from_list(data)
+        c = v.cursor()
+        c.set_range(1900, (x * 10 for x in range(100)))
+        for i in range(10, 90):
+            c.set(i, c[i] + 0.5)
+        expected = [x + 0.5 if 10 <= x < 90 else x for x in data[:1900]]
+        expected += [x * 10 for x in range(100)]
+        assert list(c.commit()) == expected
+
+    def test_sweeps(self):
+        """Test forward and backward sweeps that cross every tree level."""
+        n = 40000
+        v = PersistentList.from_list(list(range(n)))
+        c = v.cursor()
+        for i in range(0, n, 7):
+            c[i] = -i
+        for i in range(n - 1, -1, -13):
+            c[i] = c[i] * 2 if i % 7 == 0 else 'x'
+        expected = list(range(n))
+        for i in range(0, n, 7):
+            expected[i] = -i
+        for i in range(n - 1, -1, -13):
+            expected[i] = expected[i] * 2 if i % 7 == 0 else 'x'
+        assert [c[i] for i in range(0, n, 101)] == expected[::101]
+        assert list(c.commit()) == expected
+        assert list(v) == list(range(n))
+
+    def test_commit_is_persistent(self):
+        """Test edits after commit do not change the committed list."""
+        v = PersistentList.from_list(list(range(100)))
+        c = v.cursor()
+        c[3] = 'a'
+        c[99] = 'z'
+        first = c.commit()
+        c[3] = 'b'
+        c[4] = 'c'
+        c[99] = 'y'
+        second = c.commit()
+        assert first[3] == 'a' and first[4] == 4 and first[99] == 'z'
+        assert second[3] == 'b' and second[4] == 'c' and second[99] == 'y'
+        assert v[3] == 3 and v[99] == 99
+
+    def test_negative_and_out_of_range(self):
+        """Test negative indices and IndexError on bad ones."""
+        c = PersistentList.from_list(list(range(50))).cursor()
+        c[-1] = 'last'
+        assert c[49] == 'last'
+        with pytest.raises(IndexError):
+            c[50] = 0
+        with pytest.raises(IndexError):
+            c[-51]
+        with pytest.raises(IndexError):
+            c.set_range(48, [1, 2, 3])
+        assert c[48] == 1 and c[49] == 2
+
+
+class TestPersistentListSorted:
+    """Test PersistentList.sorted()."""
+
+    @pytest.mark.parametrize('values', [
+        [],
+        [5, -3, 2**40, 0, -2**70, 7],
+        [2.5, -1.0, float('inf'), 0.0, -0.0],
+        ['pear', 'apple', 'Zed', '', 'äpfel'],
+        [3, 1.5, True, -2],
+        [(1, 'b'), (0, 'z'), (1, 'a')],
+    ])
+    def test_matches_builtin(self, values):
+        """Test results match sorted() for each key type and mix."""
+        v = PersistentList.from_list(values)
+        assert list(v.sorted()) == sorted(values)
+        assert list(v.sorted(reverse=True)) == sorted(values, reverse=True)
+
+    def test_large(self):
+        """Test a list spanning several trie levels."""
+        import random
+        values = [random.randrange(10**6) for _ in range(40000)]
+        v = PersistentList.from_list(values)
+        result = v.sorted()
+        assert list(result) == sorted(values)
+        assert list(v) == values
+
+    def test_stable_with_key(self):
+        """Test equal keys keep their original order in both directions."""
+        words = ['bb', 'a', 'cc', 'd', 'ee', 'f']
+        v = PersistentList.from_list(words)
+        assert list(v.sorted(key=len)) == sorted(words, key=len)
+        assert list(v.sorted(key=len, reverse=True)) == sorted(words, key=len, reverse=True)
+
+    def test_key_called_once(self):
+        """Test key is called exactly once per element."""
+        calls = []
+
+        def key(x):
+            calls.append(x)
+            return -x
+
+        v = PersistentList.from_list(list(range(100)))
+        assert list(v.sorted(key=key)) == list(range(99, -1, -1))
+        assert len(calls) == 100
+
+    def test_nan_falls_back(self):
+        """Test floats containing NaN still sort every element (order around NaN is unspecified)."""
+        nan = float('nan')
+        result = PersistentList.from_list([3.0, nan, 1.0, 2.0]).sorted()
+        assert len(result) == 4
+        assert sorted(x for x in result if x == x) == [1.0, 2.0, 3.0]
+
+    def test_incomparable_raises(self):
+        """Test incomparable keys raise TypeError."""
+        with pytest.raises(TypeError):
+            PersistentList.from_list([1, 'a', 2]).sorted()
+
+
+class TestPersistentListSplit:
+    """Test split() and partition_sizes() on PersistentList."""
+
+    @pytest.mark.parametrize('n', [0, 1, 31, 32, 33, 1000, 1024, 1056, 33000, 100003])
+    @pytest.mark.parametrize('k', [1, 2, 3, 7, 64])
+    def test_parts_concatenate(self, n, k):
+        """Test the parts concatenate back to the original list."""
+        v = PersistentList.from_list(list(range(n)))
+        parts = v.split(k)
+        assert len(parts) == k
+        joined = []
+        for part in parts:
+            joined.extend(part)
+        assert joined == list(range(n))
+        assert v.partition_sizes(k) == [len(p) for p in parts]
+
+    def test_parts_are_usable(self):
+        """Test parts index, append, pop and update like any list."""
+        v = PersistentList.from_list(list(range(100000)))
+        for part in v.split(6):
+            first = part[0]
+            assert list(part) == list(range(first, first + len(part)))
+            grown = part.conj('x')
+            assert grown[-1] == 'x' and len(grown) == len(part) + 1
+            assert list(grown.pop()) == list(part)
+            assert part.assoc(0, 'y')[0] == 'y'
+
+    def test_balanced(self):
+        """Test parts are within a modest factor of an even share."""
+        sizes = PersistentList.from_list(list(range(1000000))).partition_sizes(10)
+        assert min(sizes) > 0.9 * 100000
+        assert max(sizes) < 1.1 * 100000
+
+    def test_parts_pickle_independently(self):
+        """Test each part round-trips through pickle on its own."""
+        import pickle
+        v = PersistentList.from_list(list(range(5000)))
+        for part in v.split(3):
+            assert pickle.loads(pickle.dumps(part)) == part
+
+    def test_zero_rejected(self):
+        """Test k=0 raises ValueError."""
+        with pytest.raises(ValueError):
+            PersistentList().split(0)
+
+
 class TestPersistentListPickle:
     """Test pickle serialization for PersistentList."""
 
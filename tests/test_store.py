@@ -0,0 +1,229 @@
+"""
+Tests for the change feed: PersistentDict.diff, ChangeSet and Store.
+
+Verifies that:
+- diff reports added, removed and changed entries, including across
+  hash collisions and between unrelated dicts
+- Store publishes one ChangeSet per update, or per outermost batch
+- Subscribers can maintain a secondary index incrementally
+"""
+
+import random
+
+import pytest
+from pypersistent import PersistentDict, Store
+
+
+class Collide:
+    """Key with a fixed hash, so distinct keys share one trie path."""
+
+    def __init__(self, value):
+        self.value = value
+
+    def __hash__(self):
+        return 42
+
+    def __eq__(self, other):
+        return isinstance(other, Collide) and self.value == other.value
+
+    def __repr__(self):
+        return f'Collide({self.value})'
+
+
+def as_sets(changes):
+    """ChangeSet contents as comparable sets."""
+    return (set(changes.added), set(changes.removed), set(changes.changed))
+
+
+def expected(before, after):
+    """Reference diff computed from plain dicts."""
+    added = {(k, v) for k, v in after.items() if k not in before}
+    removed = {(k, v) for k, v in before.items() if k not in after}
+    changed = {(k, before[k], after[k]) for k in before.keys() & after.keys()
+               if before[k] != after[k]}
+    return added, removed, changed
+
+
+class TestPersistentDictDiff:
+    """Test the structural diff between two versions."""
+
+    def test_identical(self):
+        """Test a dict diffed with itself has no changes."""
+        m = PersistentDict.from_dict({i: i for i in range(1000)})
+        changes = m.diff(m)
+        assert len(changes) == 0
+        assert changes.before == m and changes.after == m
+
+    def test_single_edits(self):
+        """Test add, remove and change of one key on a large map."""
+        m = PersistentDict.from_dict({i: i for i in range(5000)})
+        assert as_sets(m.diff(m.assoc(-1, 'x'))) == ({(-1, 'x')}, set(), set())
+        assert as_sets(m.diff(m.dissoc(7))) == (set(), {(7, 7)}, set())
+        assert as_sets(m.diff(m.assoc(7, 'y'))) == (set(), set(), {(7, 7, 'y')})
+
+    def test_equal_values_not_changed(self):
+        """Test a value replaced by an equal object is not reported."""
+        m = PersistentDict.from_dict({'a': 1000})
+        assert len(m.diff(m.assoc('a', int('1000')))) == 0
+
+    def test_random_edits(self):
+        """Test many edits and unrelated dicts against a plain-dict reference."""
+        rng = random.Random(7)
+        base = {i: i for i in range(2000)}
+        m = PersistentDict.from_dict(base)
+        for _ in range(20):
+            after = dict(base)
+            n = m
+            for _ in range(rng.randrange(1, 50)):
+                k = rng.randrange(2500)
+                if rng.random() < 0.3 and k in after:
+                    del after[k]
+                    n = n.dissoc(k)
+                else:
+                    after[k] = rng.randrange(3)
+                    n = n.assoc(k, after[k])
+            assert as_sets(m.diff(n)) == expected(base, after)
+        other = {i: -i for i in range(1000, 3000)}
+        assert as_sets(m.diff(PersistentDict.from_dict(other))) == expected(base, other)
+
+    def test_collisions(self):
+        """Test entries that share a slot or a collision bucket."""
+        a = PersistentDict.from_dict({Collide(1): 1, 'x': 0})
+        b = a.assoc(Collide(2), 2).assoc(Collide(1), 10)
+        changes = a.diff(b)
+        assert [(k.value, v) for k, v in changes.added] == [(2, 2)]
+        assert [(k.value, o, n) for k, o, n in changes.changed] == [(1, 1, 10)]
+        assert changes.removed == []
+        back = b.diff(a)
+        assert [(k.value, v) for k, v in back.removed] == [(2, 2)]
+
+    def test_flooded_bucket(self):
+        """Test large collision buckets: sorted int keys and unorderable keys."""
+        modulus = 2**61 - 1
+        rng = random.Random(5)
+        for make in (lambda k: 7 + k * modulus, Collide):
+            base = {make(k): k for k in range(300)}
+            after = dict(base)
+            for k in rng.sample(range(300), 60):
+                del after[make(k)]
+            for k in rng.sample(range(300), 60):
+                if make(k) in after:
+                    after[make(k)] = -k
+            for k in range(300, 340):
+                after[make(k)] = k
+            m = PersistentDict.from_dict(base)
+            n = m
+            for k in base.keys() - after.keys():
+                n = n.dissoc(k)
+            for k, v in after.items():
+                n = n.assoc(k, v)
+            assert m.trie_stats()['collision_nodes'] == 1
+            assert as_sets(m.diff(n)) == expected(base, after)
+            assert as_sets(n.diff(m)) == expected(after, base)
+
+
+class TestStore:
+    """Test publishing ChangeSets from a mutable cell."""
+
+    def test_updates_publish(self):
+        """Test each update publishes its own ChangeSet."""
+        store = Store(PersistentDict.from_dict({'a': 1}))
+        seen = []
+        store.subscribe(seen.append)
+        store.assoc('b', 2)
+        store.assoc('a', 3)
+        store.dissoc('b')
+        assert [as_sets(c) for c in seen] == [
+            ({('b', 2)}, set(), set()),
+            (set(), set(), {('a', 1, 3)}),
+            (set(), {('b', 2)}, set()),
+        ]
+        assert seen[-1].after == store.state
+
+    def test_state_is_a_snapshot(self):
+        """Test a held store.state is unchanged by later updates."""
+        store = Store(PersistentDict.from_dict({'a': 0}))
+        before = store.state
+        store.assoc('a', 1)
+        store.update({'b': 2})
+        store.reset(PersistentDict())
+        assert dict(before.items()) == {'a': 0}
+        assert len(store.state) == 0
+
+    def test_no_op_publishes_nothing(self):
+        """Test updates that leave the state unchanged are not published."""
+        store = Store(PersistentDict.from_dict({'a': 1}))
+        seen = []
+        store.subscribe(seen.append)
+        store.dissoc('missing')
+        store.assoc('a', 1)
+        store.reset(store.state)
+        assert seen == []
+
+    def test_batch(self):
+        """Test a batch publishes one net ChangeSet when the outermost exits."""
+        store = Store(PersistentDict.from_dict({'a': 1, 'b': 2}))
+        seen = []
+        store.subscribe(seen.append)
+        with store.batch():
+            store.assoc('c', 3)
+            with store.batch():
+                store.dissoc('b')
+                store.update({'a': 5, 'd': 4})
+            assert seen == []
+            store.dissoc('d')
+            assert store.in_batch
+        assert not store.in_batch
+        assert len(seen) == 1
+        assert as_sets(seen[0]) == ({('c', 3)}, {('b', 2)}, {('a', 1, 5)})
+
+    def test_batch_publishes_on_error(self):
+        """Test updates made before an exception inside a batch are published."""
+        store = Store()
+        seen = []
+        store.subscribe(seen.append)
+        with pytest.raises(KeyError):
+            with store.batch():
+                store.assoc('a', 1)
+                raise KeyError('boom')
+        assert as_sets(seen[0]) == ({('a', 1)}, set(), set())
+
+    def test_unsubscribe(self):
+        """Test unsubscribed callables are no longer called."""
+        store = Store()
+        calls = []
+        token = store.subscribe(lambda c: calls.append(1))
+        store.assoc(1, 1)
+        assert store.unsubscribe(token)
+        assert not store.unsubscribe(token)
+        store.assoc(2, 2)
+        assert calls == [1]
+        with pytest.raises(TypeError):
+            store.subscribe(42)
+
+    def test_incremental_index(self):
+        """Test a reverse index maintained from ChangeSets matches a rebuild."""
+        store = Store()
+        index = {}
+
+        def maintain(changes):
+            for k, v in changes.removed:
+                index[v].discard(k)
+            for k, old, new in changes.changed:
+                index[old].discard(k)
+                index.setdefault(new, set()).add(k)
+            for k, v in changes.added:
+                index.setdefault(v, set()).add(k)
+
+        store.subscribe(maintain)
+        rng = random.Random(3)
+        for _ in range(300):
+            k = rng.randrange(100)
+            if rng.random() < 0.25:
+                store.dissoc(k)
+            else:
+                store.assoc(k, rng.randrange(5))
+        rebuilt = {}
+        for k, v in store.state.items():
+            rebuilt.setdefault(v, set()).add(k)
+        assert {v: ks for v, ks in index.items() if ks} == rebuilt